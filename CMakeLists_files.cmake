@@ -31,6 +31,7 @@
 list (APPEND MAIN_SOURCE_FILES
   opm/core/grid/GridHelpers.cpp
 	opm/core/grid/GridManager.cpp
+	opm/core/grid/GridPartition.cpp
 	opm/core/grid/GridUtilities.cpp
 	opm/core/grid/grid.c
 	opm/core/grid/cart_grid.c
@@ -39,6 +40,7 @@ list (APPEND MAIN_SOURCE_FILES
 	opm/core/grid/cpgpreprocess/geometry.c
 	opm/core/grid/cpgpreprocess/preprocess.c
 	opm/core/grid/cpgpreprocess/uniquepoints.c
+	opm/core/io/checkpoint/Checkpoint.cpp
 	opm/core/io/eclipse/EclipseGridInspector.cpp
 	opm/core/io/eclipse/EclipseWriter.cpp
 	opm/core/io/eclipse/EclipseReader.cpp
@@ -52,6 +54,8 @@ list (APPEND MAIN_SOURCE_FILES
 	opm/core/linalg/LinearSolverIstl.cpp
 	opm/core/linalg/LinearSolverUmfpack.cpp
 	opm/core/linalg/LinearSolverPetsc.cpp
+	opm/core/linalg/LinearSolverRecycling.cpp
+	opm/core/linalg/LinearSystemCapture.cpp
 	opm/core/linalg/call_umfpack.c
 	opm/core/linalg/sparse_sys.c
 	opm/core/pressure/CompressibleTpfa.cpp
@@ -103,12 +107,15 @@ list (APPEND MAIN_SOURCE_FILES
 	opm/core/props/satfunc/RelpermDiagnostics.cpp
 	opm/core/simulator/AdaptiveSimulatorTimer.cpp
 	opm/core/simulator/BlackoilState.cpp
+	opm/core/simulator/PressureUpdatePolicy.cpp
+	opm/core/simulator/RelativeChange.cpp
 	opm/core/simulator/TimeStepControl.cpp
 	opm/core/simulator/SimulatorCompressibleTwophase.cpp
 	opm/core/simulator/SimulatorIncompTwophase.cpp
 	opm/core/simulator/SimulatorOutput.cpp
 	opm/core/simulator/SimulatorReport.cpp
 	opm/core/simulator/SimulatorState.cpp
+	opm/core/simulator/StateComparison.cpp
 	opm/core/simulator/SimulatorTimer.cpp
 	opm/core/flowdiagnostics/AnisotropicEikonal.cpp
 	opm/core/flowdiagnostics/DGBasis.cpp
@@ -120,10 +127,13 @@ list (APPEND MAIN_SOURCE_FILES
 	opm/core/transport/implicit/transport_source.c
 	opm/core/transport/minimal/spu_explicit.c
 	opm/core/transport/minimal/spu_implicit.c
+	opm/core/transport/minimal/spu_tables.c
+	opm/core/transport/minimal/TransportSolverTwophaseExplicitLts.cpp
 	opm/core/transport/reorder/TransportSolverCompressibleTwophaseReorder.cpp
 	opm/core/transport/reorder/ReorderSolverInterface.cpp
 	opm/core/transport/reorder/TransportSolverTwophaseReorder.cpp
 	opm/core/transport/reorder/reordersequence.cpp
+	opm/core/transport/reorder/parallelscc.cpp
 	opm/core/transport/reorder/tarjan.c
 	opm/core/utility/compressedToCartesian.cpp
 	opm/core/utility/Event.cpp
@@ -131,6 +141,7 @@ list (APPEND MAIN_SOURCE_FILES
 	opm/core/utility/StopWatch.cpp
 	opm/core/utility/VelocityInterpolation.cpp
 	opm/core/utility/WachspressCoord.cpp
+	opm/core/utility/MemoryUsage.cpp
 	opm/core/utility/miscUtilities.cpp
        opm/core/utility/opm_memcmp_double.c
 	opm/core/utility/miscUtilitiesBlackoil.cpp
@@ -184,22 +195,40 @@ list (APPEND TEST_SOURCE_FILES
 	tests/test_param.cpp
 	tests/test_blackoilfluid.cpp
 	tests/test_satfunc.cpp
+	tests/test_saturationpropsbasic.cpp
 	tests/test_shadow.cpp
 	tests/test_equil.cpp
 	tests/test_regionmapping.cpp
 	tests/test_units.cpp
 	tests/test_blackoilstate.cpp
+	tests/test_checkpoint.cpp
 	tests/test_parser.cpp
 	tests/test_wellsmanager.cpp
 	tests/test_wellcontrols.cpp
 	tests/test_wellsgroup.cpp
 	tests/test_wellcollection.cpp
 	tests/test_timer.cpp
+	tests/test_timestepcontrol.cpp
+	tests/test_pressureupdatepolicy.cpp
+	tests/test_compressiblereorder.cpp
+	tests/test_parallelscc.cpp
+	tests/test_tofreorder.cpp
+	tests/test_reordernewton.cpp
+	tests/test_spu_explicit_lts.cpp
+	tests/test_phaseconfiguration.cpp
+	tests/test_statecomparison.cpp
+	tests/test_memoryusage.cpp
+	tests/test_rootfinders.cpp
+	tests/test_linearsolverrecycling.cpp
+	tests/test_linearsystemcapture.cpp
 	tests/test_minpvprocessor.cpp
 	tests/test_pinchprocessor.cpp
 	tests/test_gridutilities.cpp
+	tests/test_gridpartition.cpp
+	tests/test_cellhaloexchange.cpp
 	tests/test_anisotropiceikonal.cpp
 	tests/test_stoppedwells.cpp
+	tests/test_compressibletpfa.cpp
 	tests/test_relpermdiagnostics.cpp
         tests/test_norne_pvt.cpp
   )
@@ -242,11 +271,13 @@ list (APPEND TEST_DATA_FILES
 # originally generated with the command:
 # find tutorials examples -name '*.c*' -printf '\t%p\n' | sort
 list (APPEND EXAMPLE_SOURCE_FILES
+	examples/bench_relperm_basic.cpp
 	examples/compute_eikonal_from_files.cpp
 	examples/compute_initial_state.cpp
 	examples/compute_tof.cpp
 	examples/compute_tof_from_files.cpp
   examples/mirror_grid.cpp
+	examples/replay_linear_systems.cpp
 	examples/sim_2p_comp_reorder.cpp
 	examples/sim_2p_incomp.cpp
 	examples/wells_example.cpp
@@ -286,6 +317,7 @@ list (APPEND PUBLIC_HEADER_FILES
 	opm/core/grid/FaceQuadrature.hpp
 	opm/core/grid/GridHelpers.hpp
 	opm/core/grid/GridManager.hpp
+	opm/core/grid/GridPartition.hpp
 	opm/core/grid/GridUtilities.hpp
 	opm/core/grid/MinpvProcessor.hpp
 	opm/core/grid/PinchProcessor.hpp
@@ -295,6 +327,7 @@ list (APPEND PUBLIC_HEADER_FILES
 	opm/core/grid/cpgpreprocess/geometry.h
 	opm/core/grid/cpgpreprocess/preprocess.h
 	opm/core/grid/cpgpreprocess/uniquepoints.h
+	opm/core/io/checkpoint/Checkpoint.hpp
 	opm/core/io/eclipse/CornerpointChopper.hpp
 	opm/core/io/eclipse/EclipseIOUtil.hpp
 	opm/core/io/eclipse/EclipseGridInspector.hpp
@@ -311,6 +344,8 @@ list (APPEND PUBLIC_HEADER_FILES
 	opm/core/linalg/LinearSolverIstl.hpp
 	opm/core/linalg/LinearSolverUmfpack.hpp
 	opm/core/linalg/LinearSolverPetsc.hpp
+	opm/core/linalg/LinearSolverRecycling.hpp
+	opm/core/linalg/LinearSystemCapture.hpp
 	opm/core/linalg/ParallelIstlInformation.hpp
 	opm/core/linalg/blas_lapack.h
 	opm/core/linalg/call_umfpack.h
@@ -345,6 +380,7 @@ list (APPEND PUBLIC_HEADER_FILES
 	opm/core/pressure/tpfa/TransTpfa_impl.hpp
 	opm/core/pressure/tpfa/trans_tpfa.h
 	opm/core/props/BlackoilPhases.hpp
+	opm/core/props/PhaseConfiguration.hpp
 	opm/core/props/BlackoilPropertiesBasic.hpp
 	opm/core/props/BlackoilPropertiesFromDeck.hpp
 	opm/core/props/BlackoilPropertiesInterface.hpp
@@ -382,12 +418,15 @@ list (APPEND PUBLIC_HEADER_FILES
 	opm/core/simulator/EquilibrationHelpers.hpp
   opm/core/simulator/ExplicitArraysFluidState.hpp
 	opm/core/simulator/ExplicitArraysSatDerivativesFluidState.hpp
+	opm/core/simulator/PressureUpdatePolicy.hpp
+	opm/core/simulator/RelativeChange.hpp
 	opm/core/simulator/TimeStepControl.hpp
 	opm/core/simulator/SimulatorCompressibleTwophase.hpp
 	opm/core/simulator/SimulatorIncompTwophase.hpp
 	opm/core/simulator/SimulatorOutput.hpp
 	opm/core/simulator/SimulatorReport.hpp
 	opm/core/simulator/SimulatorState.hpp
+	opm/core/simulator/StateComparison.hpp
 	opm/core/simulator/SimulatorTimerInterface.hpp
 	opm/core/simulator/SimulatorTimer.hpp
 	opm/core/simulator/TimeStepControlInterface.hpp
@@ -417,11 +456,15 @@ list (APPEND PUBLIC_HEADER_FILES
 	opm/core/transport/implicit/transport_source.h
 	opm/core/transport/minimal/spu_explicit.h
 	opm/core/transport/minimal/spu_implicit.h
+	opm/core/transport/minimal/spu_tables.h
+	opm/core/transport/minimal/TransportSolverTwophaseExplicitLts.hpp
 	opm/core/transport/reorder/TransportSolverCompressibleTwophaseReorder.hpp
 	opm/core/transport/reorder/ReorderSolverInterface.hpp
 	opm/core/transport/reorder/TransportSolverTwophaseReorder.hpp
 	opm/core/transport/reorder/reordersequence.h
+	opm/core/transport/reorder/parallelscc.h
 	opm/core/transport/reorder/tarjan.h
+	opm/core/utility/AllocationCounterHook.hpp
 	opm/core/utility/Average.hpp
 	opm/core/utility/CompressedPropertyAccess.hpp
 	opm/core/utility/compressedToCartesian.hpp
@@ -429,6 +472,7 @@ list (APPEND PUBLIC_HEADER_FILES
 	opm/core/utility/Event.hpp
 	opm/core/utility/Event_impl.hpp
 	opm/core/utility/Factory.hpp
+	opm/core/utility/MemoryUsage.hpp
 	opm/core/utility/MonotCubicInterpolator.hpp
 	opm/core/utility/opm_memcmp_double.h
 	opm/core/utility/NonuniformTableLinear.hpp
@@ -0,0 +1,84 @@
+/*
+  Copyright 2015 SINTEF ICT, Applied Mathematics.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#if HAVE_CONFIG_H
+#include "config.h"
+#endif // HAVE_CONFIG_H
+
+#include <opm/core/props/satfunc/SaturationPropsBasic.hpp>
+#include <opm/core/utility/StopWatch.hpp>
+#include <opm/core/utility/parameters/ParameterGroup.hpp>
+
+#include <cmath>
+#include <iostream>
+#include <string>
+#include <vector>
+
+/**
+ * @file bench_relperm_basic.cpp
+ * @brief Throughput of the analytic relative permeabilities.
+ *
+ * Evaluates SaturationPropsBasic::relperm() with and without
+ * derivatives on num_cells cells, and reports cells per second.
+ * Accepts the parameters of SaturationPropsBasic::init() and
+ * num_cells (1048576) and repeats (100).
+ */
+
+// ----------------- Main program -----------------
+int
+main(int argc, char** argv)
+try
+{
+    using namespace Opm;
+
+    parameter::ParameterGroup param(argc, argv);
+    SaturationPropsBasic satprops;
+    satprops.init(param);
+    const int n = param.getDefault("num_cells", 1 << 20);
+    const int repeats = param.getDefault("repeats", 100);
+    const int np = satprops.numPhases();
+
+    std::vector<double> s(n*np);
+    for (int i = 0; i < n; ++i) {
+        s[np*i] = 0.5 + 0.5*std::sin(double(i));
+        if (np == 2) {
+            s[np*i + 1] = 1.0 - s[np*i];
+        }
+    }
+    std::vector<double> kr(n*np);
+    std::vector<double> dkrds(n*np*np);
+
+    for (int deriv = 0; deriv < 2; ++deriv) {
+        double* dkr = deriv ? &dkrds[0] : 0;
+        satprops.relperm(n, &s[0], &kr[0], dkr);
+        time::StopWatch clock;
+        clock.start();
+        for (int r = 0; r < repeats; ++r) {
+            satprops.relperm(n, &s[0], &kr[0], dkr);
+        }
+        clock.stop();
+        const double secs = clock.secsSinceStart();
+        std::cout << (deriv ? "relperm and derivatives: " : "relperm:                 ")
+                  << double(n)*repeats/secs << " cells/s" << std::endl;
+    }
+}
+catch (const std::exception &e) {
+    std::cerr << "Program threw an exception: " << e.what() << "\n";
+    throw;
+}
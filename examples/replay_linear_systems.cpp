@@ -0,0 +1,217 @@
+/*
+  Copyright 2015 SINTEF ICT, Applied Mathematics.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#if HAVE_CONFIG_H
+#include "config.h"
+#endif // HAVE_CONFIG_H
+
+#include <opm/core/linalg/LinearSolverFactory.hpp>
+#include <opm/core/linalg/LinearSystemCapture.hpp>
+#include <opm/core/utility/StopWatch.hpp>
+#include <opm/core/utility/parameters/ParameterGroup.hpp>
+#include <opm/common/ErrorMacros.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+/**
+ * @file replay_linear_systems.cpp
+ * @brief Replay captured linear systems against the available solvers.
+ *
+ * Usage: replay_linear_systems [parameters] file.olsys ...
+ *
+ * The files are written by LinearSolverCapture, for instance by giving
+ * linsolver_capture_prefix to a simulator using LinearSolverFactory.
+ * Every system is solved with every backend enabled in this build, and
+ * the best solve time over the repeats, the iterations and the true
+ * relative residual are reported. The parameters are
+ *    backends           (all)   comma separated subset of the names below
+ *    repeats            (3)     solves of each system with each backend
+ *    use_initial_guess  (true)  start from the captured initial guess
+ *    tolerance          (-1)    override the captured tolerance if positive;
+ *                               files without one use the backend default
+ */
+
+namespace
+{
+    struct Backend
+    {
+        std::string name;
+        std::string linsolver;
+        int istl_type;
+    };
+
+    std::vector<Backend> allBackends()
+    {
+        const Backend backends[] = {
+            { "umfpack",          "umfpack", -1 },
+            { "istl_cg_ilu0",     "istl",     0 },
+            { "istl_cg_amg",      "istl",     1 },
+            { "istl_bicgstab_ilu0", "istl",   2 },
+            { "istl_fastamg",     "istl",     3 },
+            { "istl_kamg",        "istl",     4 },
+            { "petsc",            "petsc",   -1 }
+        };
+        return std::vector<Backend>(backends, backends + sizeof(backends)/sizeof(backends[0]));
+    }
+
+    std::vector<Backend> selectBackends(const std::string& names)
+    {
+        const std::vector<Backend> all = allBackends();
+        if (names == "all") {
+            return all;
+        }
+        std::vector<Backend> selected;
+        std::istringstream is(names);
+        std::string name;
+        while (std::getline(is, name, ',')) {
+            std::vector<Backend>::const_iterator it = all.begin();
+            while (it != all.end() && it->name != name) {
+                ++it;
+            }
+            if (it == all.end()) {
+                OPM_THROW(std::runtime_error, "Unknown backend " << name << '.');
+            }
+            selected.push_back(*it);
+        }
+        return selected;
+    }
+
+    /// Solver for a backend, or null if it is not enabled in this build.
+    std::shared_ptr<Opm::LinearSolverInterface> makeSolver(const Backend& backend)
+    {
+        Opm::parameter::ParameterGroup param;
+        param.disableOutput();
+        param.insertParameter("linsolver", backend.linsolver);
+        if (backend.istl_type >= 0) {
+            std::ostringstream type;
+            type << backend.istl_type;
+            param.insertParameter("linsolver_type", type.str());
+        }
+        try {
+            return std::make_shared<Opm::LinearSolverFactory>(param);
+        } catch (const std::runtime_error&) {
+            return std::shared_ptr<Opm::LinearSolverInterface>();
+        }
+    }
+
+    /// |b - Ax| / |b|.
+    double relativeResidual(const Opm::CapturedLinearSystem& sys, const std::vector<double>& x)
+    {
+        double rr = 0.0;
+        double bb = 0.0;
+        for (int row = 0; row < sys.size(); ++row) {
+            double r = sys.rhs[row];
+            for (int k = sys.ia[row]; k < sys.ia[row + 1]; ++k) {
+                r -= sys.sa[k] * x[sys.ja[k]];
+            }
+            rr += r*r;
+            bb += sys.rhs[row]*sys.rhs[row];
+        }
+        return bb > 0.0 ? std::sqrt(rr/bb) : std::sqrt(rr);
+    }
+} // anon namespace
+
+
+
+// ----------------- Main program -----------------
+int
+main(int argc, char** argv)
+try
+{
+    using namespace Opm;
+
+    parameter::ParameterGroup param(argc, argv, false);
+    const std::vector<Backend> backends = selectBackends(param.getDefault<std::string>("backends", "all"));
+    const int repeats = std::max(param.getDefault("repeats", 3), 1);
+    const bool use_initial_guess = param.getDefault("use_initial_guess", true);
+    const double tolerance = param.getDefault("tolerance", -1.0);
+    const std::vector<std::string>& files = param.unhandledArguments();
+    if (files.empty()) {
+        std::cerr << "Usage: " << argv[0] << " [parameters] file.olsys ...\n";
+        return EXIT_FAILURE;
+    }
+
+    std::vector<std::shared_ptr<LinearSolverInterface> > solvers;
+    std::vector<double> default_tolerances;
+    for (std::size_t b = 0; b < backends.size(); ++b) {
+        solvers.push_back(makeSolver(backends[b]));
+        default_tolerances.push_back(solvers.back() ? solvers.back()->getTolerance() : -1.0);
+        if (!solvers.back()) {
+            std::cout << "Backend " << backends[b].name << " is not enabled in this build.\n";
+        }
+    }
+
+    std::cout << std::left << std::setw(32) << "system" << std::setw(20) << "backend"
+              << std::right << std::setw(10) << "rows" << std::setw(12) << "nonzeros"
+              << std::setw(12) << "time [s]" << std::setw(8) << "iter"
+              << std::setw(14) << "residual" << "  status\n";
+    for (std::size_t f = 0; f < files.size(); ++f) {
+        const CapturedLinearSystem sys = readLinearSystem(files[f]);
+        for (std::size_t b = 0; b < backends.size(); ++b) {
+            if (!solvers[b]) {
+                continue;
+            }
+            LinearSolverInterface& solver = *solvers[b];
+            // Files without a captured tolerance use the backend default,
+            // not whatever the previous file set.
+            const double tol = tolerance > 0.0 ? tolerance
+                : (sys.tolerance > 0.0 ? sys.tolerance : default_tolerances[b]);
+            if (tol > 0.0) {
+                solver.setTolerance(tol);
+            }
+            std::cout << std::left << std::setw(32) << files[f] << std::setw(20) << backends[b].name
+                      << std::right << std::setw(10) << sys.size() << std::setw(12) << sys.nonzeros();
+            double best = std::numeric_limits<double>::max();
+            LinearSolverInterface::LinearSolverReport rep = {};
+            std::vector<double> x;
+            try {
+                for (int r = 0; r < repeats; ++r) {
+                    x = use_initial_guess ? sys.initial_guess : std::vector<double>(sys.size(), 0.0);
+                    time::StopWatch clock;
+                    clock.start();
+                    rep = solver.solve(sys.size(), sys.nonzeros(), &sys.ia[0],
+                                       sys.ja.empty() ? 0 : &sys.ja[0], sys.sa.empty() ? 0 : &sys.sa[0],
+                                       sys.rhs.empty() ? 0 : &sys.rhs[0], x.empty() ? 0 : &x[0]);
+                    clock.stop();
+                    best = std::min(best, clock.secsSinceStart());
+                }
+            } catch (const std::exception& e) {
+                std::cout << "  failed: " << e.what() << '\n';
+                continue;
+            }
+            std::cout << std::setw(12) << std::setprecision(4) << best
+                      << std::setw(8) << rep.iterations
+                      << std::setw(14) << std::setprecision(3) << relativeResidual(sys, x)
+                      << (rep.converged ? "  converged\n" : "  NOT CONVERGED\n");
+        }
+    }
+}
+catch (const std::exception &e) {
+    std::cerr << "Program threw an exception: " << e.what() << "\n";
+    throw;
+}
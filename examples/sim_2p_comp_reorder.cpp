@@ -32,6 +32,7 @@
 #include <opm/core/simulator/SimulatorReport.hpp>
 #include <opm/core/simulator/SimulatorTimer.hpp>
 #include <opm/core/utility/miscUtilities.hpp>
+#include <opm/core/utility/StopWatch.hpp>
 #include <opm/core/utility/parameters/ParameterGroup.hpp>
 
 #include <opm/core/props/BlackoilPropertiesBasic.hpp>
@@ -97,6 +98,10 @@ try
     // bool check_well_controls = false;
     // int max_well_control_iterations = 0;
     double gravity[3] = { 0.0 };
+    // time to first step, including deck parsing and state initialisation
+    Opm::time::StopWatch init_timer;
+    init_timer.start();
+    Opm::time::StopWatch state_timer;
     if (use_deck) {
         ParseMode parseMode;
         std::string deck_filename = param.get<std::string>("deck_filename");
@@ -114,12 +119,14 @@ try
         // Gravity.
         gravity[2] = deck->hasKeyword("NOGRAV") ? 0.0 : unit::gravity;
         // Init state variables (saturation and pressure).
+        state_timer.start();
         if (param.has("init_saturation")) {
             initStateBasic(*grid->c_grid(), *props, param, gravity[2], state);
         } else {
             initStateFromDeck(*grid->c_grid(), *props, deck, gravity[2], state);
         }
         initBlackoilSurfvol(*grid->c_grid(), *props, state);
+        state_timer.stop();
     } else {
         // Grid init.
         const int nx = param.getDefault("nx", 100);
@@ -136,8 +143,10 @@ try
         // Gravity.
         gravity[2] = param.getDefault("gravity", 0.0);
         // Init state variables (saturation and pressure).
+        state_timer.start();
         initStateBasic(*grid->c_grid(), *props, param, gravity[2], state);
         initBlackoilSurfvol(*grid->c_grid(), *props, state);
+        state_timer.stop();
     }
 
     bool use_gravity = (gravity[0] != 0.0 || gravity[1] != 0.0 || gravity[2] != 0.0);
@@ -199,6 +208,9 @@ try
         param.writeParam(output_dir + "/simulation.param");
     }
 
+    init_timer.stop();
+    std::cout << "\nState initialisation time: " << state_timer.secsSinceStart() << " s"
+              << "\nTime to first step:        " << init_timer.secsSinceStart() << " s\n";
 
     std::cout << "\n\n================    Starting main simulation loop     ===============\n";
 
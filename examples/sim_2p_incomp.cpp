@@ -33,6 +33,7 @@
 #include <opm/core/simulator/SimulatorReport.hpp>
 #include <opm/core/simulator/SimulatorTimer.hpp>
 #include <opm/core/utility/miscUtilities.hpp>
+#include <opm/core/utility/AllocationCounterHook.hpp>
 #include <opm/core/utility/parameters/ParameterGroup.hpp>
 
 #include <opm/core/props/IncompPropertiesBasic.hpp>
@@ -40,6 +41,7 @@
 #include <opm/core/props/rock/RockCompressibility.hpp>
 
 #include <opm/core/linalg/LinearSolverFactory.hpp>
+#include <opm/core/linalg/LinearSolverRecycling.hpp>
 
 #include <opm/core/simulator/TwophaseState.hpp>
 #include <opm/core/simulator/WellState.hpp>
@@ -83,6 +85,9 @@ try
     parameter::ParameterGroup param(argc, argv, false);
     std::cout << "---------------    Reading parameters     ---------------" << std::endl;
 
+    // Allocation counts are reported per step if this is on.
+    AllocationCounter::enable(param.getDefault("count_allocations", false));
+
 #if ! HAVE_SUITESPARSE_UMFPACK_H
     // This is an extra check to intercept a potentially invalid request for the
     // implicit transport solver as early as possible for the user.
@@ -189,8 +194,10 @@ try
         bcs.pressureSide(*grid->c_grid(), FlowBCManager::Side(pside), pside_pressure);
     }
 
-    // Linear solver.
-    LinearSolverFactory linsolver(param);
+    // Linear solver. Previous pressure solutions are recycled
+    // as initial guesses when linsolver_recycle_size > 0.
+    LinearSolverFactory base_linsolver(param);
+    LinearSolverRecycling linsolver(base_linsolver, param.getDefault("linsolver_recycle_size", 0));
 
     // Write parameters used for later reference.
     bool output = param.getDefault("output", true);
@@ -294,6 +301,9 @@ try
     }
 
     std::cout << "\n\n================    End of simulation     ===============\n\n";
+    std::cout << "Pressure solves:                " << linsolver.numSolves() << '\n'
+              << "Linear iterations:              " << linsolver.totalIterations() << '\n'
+              << "Solves skipped by recycling:    " << linsolver.numSkippedSolves() << '\n';
     rep.report(std::cout);
 
     if (output) {
@@ -22,6 +22,7 @@
 #include <opm/core/grid.h>
 #include <opm/common/ErrorMacros.hpp>
 #include <opm/core/utility/SparseTable.hpp>
+#include <opm/core/transport/reorder/tarjan.h>
 
 #include <algorithm>
 #include <numeric>
@@ -43,7 +44,8 @@ namespace Opm
           source_(0),
           tof_(0),
           gauss_seidel_tol_(1e-3),
-          use_multidim_upwind_(use_multidim_upwind)
+          use_multidim_upwind_(use_multidim_upwind),
+          num_updated_cells_(0)
     {
     }
 
@@ -89,6 +91,176 @@ namespace Opm
 
 
 
+    /// Update a time-of-flight solution after a local change of
+    /// the flux field.
+    /// \param[in]  darcyflux         Array of signed face fluxes.
+    /// \param[in]  porevolume        Array of pore volumes.
+    /// \param[in]  source            Source term, as for solveTof().
+    /// \param[in]  changed_faces     Faces whose flux has changed, see changedFaces().
+    /// \param[in]  changed_cells     Cells whose source term has changed.
+    /// \param[in, out] tof           Time-of-flight for the old fluxes on input,
+    ///                               for the new fluxes on output.
+    void TofReorder::updateTof(const double* darcyflux,
+                               const double* porevolume,
+                               const double* source,
+                               const std::vector<int>& changed_faces,
+                               const std::vector<int>& changed_cells,
+                               std::vector<double>& tof)
+    {
+        const int num_cells = grid_.number_of_cells;
+        if (int(tof.size()) != num_cells) {
+            OPM_THROW(std::runtime_error, "updateTof() needs a previous solution with "
+                      << num_cells << " values, got " << tof.size());
+        }
+        for (std::size_t i = 0; i < changed_faces.size(); ++i) {
+            if (changed_faces[i] < 0 || changed_faces[i] >= grid_.number_of_faces) {
+                OPM_THROW(std::runtime_error, "updateTof(): changed face " << changed_faces[i]
+                          << " is not in [0, " << grid_.number_of_faces << ")");
+            }
+        }
+        for (std::size_t i = 0; i < changed_cells.size(); ++i) {
+            if (changed_cells[i] < 0 || changed_cells[i] >= num_cells) {
+                OPM_THROW(std::runtime_error, "updateTof(): changed cell " << changed_cells[i]
+                          << " is not in [0, " << num_cells << ")");
+            }
+        }
+        if (use_multidim_upwind_) {
+            // The face values are not retained between solves.
+            solveTof(darcyflux, porevolume, source, tof);
+            num_updated_cells_ = num_cells;
+            return;
+        }
+        darcyflux_ = darcyflux;
+        porevolume_ = porevolume;
+        source_ = source;
+        tof_ = &tof[0];
+        compute_tracer_ = false;
+
+        // Collect the cells whose equation has changed, then all
+        // cells downstream of those (breadth first).
+        update_index_.resize(num_cells, -1);
+        std::vector<int> cells;
+        for (std::size_t i = 0; i < changed_faces.size(); ++i) {
+            const int f = changed_faces[i];
+            for (int side = 0; side < 2; ++side) {
+                const int cell = grid_.face_cells[2*f + side];
+                if (cell != -1 && update_index_[cell] == -1) {
+                    update_index_[cell] = cells.size();
+                    cells.push_back(cell);
+                }
+            }
+        }
+        for (std::size_t i = 0; i < changed_cells.size(); ++i) {
+            const int cell = changed_cells[i];
+            if (update_index_[cell] == -1) {
+                update_index_[cell] = cells.size();
+                cells.push_back(cell);
+            }
+        }
+        for (std::size_t i = 0; i < cells.size(); ++i) {
+            const int cell = cells[i];
+            for (int hf = grid_.cell_facepos[cell]; hf < grid_.cell_facepos[cell + 1]; ++hf) {
+                const int f = grid_.cell_faces[hf];
+                const bool first = (cell == grid_.face_cells[2*f]);
+                const double outflux = first ? darcyflux_[f] : -darcyflux_[f];
+                const int other = grid_.face_cells[2*f + (first ? 1 : 0)];
+                if (outflux > 0.0 && other != -1 && update_index_[other] == -1) {
+                    update_index_[other] = cells.size();
+                    cells.push_back(other);
+                }
+            }
+        }
+        const int num_update = cells.size();
+        num_updated_cells_ = num_update;
+        if (num_update == 0) {
+            return;
+        }
+
+        // Reorder the update set by its own upwind graph.  Since it
+        // is closed downstream, every loop through one of its cells
+        // lies entirely within it, and the cells upstream of it keep
+        // their previous values.
+        std::vector<int> ia(num_update + 1, 0);
+        std::vector<int> ja;
+        for (int i = 0; i < num_update; ++i) {
+            const int cell = cells[i];
+            for (int hf = grid_.cell_facepos[cell]; hf < grid_.cell_facepos[cell + 1]; ++hf) {
+                const int f = grid_.cell_faces[hf];
+                const bool first = (cell == grid_.face_cells[2*f]);
+                const double outflux = first ? darcyflux_[f] : -darcyflux_[f];
+                const int other = grid_.face_cells[2*f + (first ? 1 : 0)];
+                if (outflux < 0.0 && other != -1 && update_index_[other] != -1) {
+                    ja.push_back(update_index_[other]);
+                }
+            }
+            ia[i + 1] = ja.size();
+        }
+        std::vector<int> sequence(num_update);
+        std::vector<int> components(num_update + 1);
+        std::vector<int> work(3*num_update);
+        int num_components = 0;
+        tarjan(num_update, &ia[0], ja.data(), &sequence[0], &components[0],
+               &num_components, &work[0]);
+
+        num_multicell_ = 0;
+        max_size_multicell_ = 0;
+        max_iter_multicell_ = 0;
+        std::vector<int> component_cells;
+        for (int comp = 0; comp < num_components; ++comp) {
+            const int comp_size = components[comp + 1] - components[comp];
+            if (comp_size == 1) {
+                solveSingleCell(cells[sequence[components[comp]]]);
+            } else {
+                component_cells.resize(comp_size);
+                for (int i = 0; i < comp_size; ++i) {
+                    component_cells[i] = cells[sequence[components[comp] + i]];
+                }
+                solveMultiCell(comp_size, &component_cells[0]);
+            }
+        }
+
+        for (int i = 0; i < num_update; ++i) {
+            update_index_[cells[i]] = -1;
+        }
+    }
+
+
+
+
+    /// Faces whose flux has changed by more than a threshold.
+    std::vector<int> TofReorder::changedFaces(const int num_faces,
+                                              const double* old_flux,
+                                              const double* new_flux,
+                                              const double threshold)
+    {
+        std::vector<int> faces;
+        for (int f = 0; f < num_faces; ++f) {
+            if (std::fabs(new_flux[f] - old_flux[f]) > threshold) {
+                faces.push_back(f);
+            }
+        }
+        return faces;
+    }
+
+
+
+
+    int TofReorder::numUpdatedCells() const
+    {
+        return num_updated_cells_;
+    }
+
+
+
+
+    int TofReorder::numMultiCellComponents() const
+    {
+        return num_multicell_;
+    }
+
+
+
+
     /// Solve for time-of-flight and a number of tracers.
     /// \param[in]  darcyflux         Array of signed face fluxes.
     /// \param[in]  porevolume        Array of pore volumes.
@@ -61,6 +61,48 @@ namespace Opm
                       const double* source,
                       std::vector<double>& tof);
 
+        /// Update a time-of-flight solution after a local change of
+        /// the flux field, for instance a new well control.  Only the
+        /// cells adjacent to a changed face, the cells with a changed
+        /// source and all cells downstream of those are recomputed;
+        /// everywhere else the previous solution is kept.  Backward
+        /// time-of-flight is updated by passing the negated fluxes and
+        /// sources as for solveTof(), so the upstream cone of the
+        /// changes is recomputed.  With multidimensional upwinding the
+        /// full solution is recomputed.
+        /// \param[in]  darcyflux         Array of signed face fluxes.
+        /// \param[in]  porevolume        Array of pore volumes.
+        /// \param[in]  source            Source term, as for solveTof().
+        /// \param[in]  changed_faces     Faces whose flux has changed, see changedFaces().
+        /// \param[in]  changed_cells     Cells whose source term has changed.
+        /// \param[in, out] tof           Time-of-flight computed by solveTof() or
+        ///                               updateTof() for the old fluxes, on output
+        ///                               the time-of-flight for the new fluxes.
+        void updateTof(const double* darcyflux,
+                       const double* porevolume,
+                       const double* source,
+                       const std::vector<int>& changed_faces,
+                       const std::vector<int>& changed_cells,
+                       std::vector<double>& tof);
+
+        /// Faces whose flux has changed by more than a threshold.
+        /// \param[in]  num_faces         Number of faces.
+        /// \param[in]  old_flux          Fluxes of the previous solve.
+        /// \param[in]  new_flux          Current fluxes.
+        /// \param[in]  threshold         Absolute flux change tolerated.
+        /// \return                       Faces with |new_flux - old_flux| > threshold.
+        static std::vector<int> changedFaces(const int num_faces,
+                                             const double* old_flux,
+                                             const double* new_flux,
+                                             const double threshold);
+
+        /// Number of cells recomputed by the last call to updateTof().
+        int numUpdatedCells() const;
+
+        /// Number of strongly connected components with more than one
+        /// cell solved by the last call to solveTof() or updateTof().
+        int numMultiCellComponents() const;
+
         /// Solve for time-of-flight and a number of tracers.
         /// \param[in]  darcyflux         Array of signed face fluxes.
         /// \param[in]  porevolume        Array of pore volumes.
@@ -112,6 +154,9 @@ namespace Opm
         bool use_multidim_upwind_;
         std::vector<double> face_tof_;       // For multidim upwind face tofs.
         std::vector<double> face_part_tof_;  // For multidim upwind face tofs.
+        // For updateTof():
+        std::vector<int> update_index_;      // Position of cell in update set, -1 if outside.
+        int num_updated_cells_;
     };
 
 } // namespace Opm
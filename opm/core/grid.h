@@ -61,6 +61,8 @@ struct UnstructuredGrid
 
 void destroy_grid(struct UnstructuredGrid *g);
 
+size_t grid_memory_usage(const struct UnstructuredGrid *g);
+
 struct UnstructuredGrid *
 create_grid_empty(void);
 
@@ -253,6 +255,18 @@ struct UnstructuredGrid
  */
 void destroy_grid(struct UnstructuredGrid *g);
 
+/**
+   Compute the number of bytes of dynamically allocated storage held
+   by an UnstructuredGrid, including the grid structure itself.
+
+   Only non-null arrays are counted, and the array sizes are inferred
+   from the grid's dimensions as documented above.
+
+   \param[in] g  Grid.  May be <code>NULL</code>.
+   \return Total storage in bytes.  Zero if <code>g</code> is <code>NULL</code>.
+ */
+size_t grid_memory_usage(const struct UnstructuredGrid *g);
+
 /**
    Allocate and initialise an empty UnstructuredGrid.
 
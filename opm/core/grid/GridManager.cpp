@@ -132,6 +132,14 @@ namespace Opm
 
 
 
+    std::size_t GridManager::memoryUsage() const
+    {
+        return grid_memory_usage(ug_);
+    }
+
+
+
+
     // Construct corner-point grid from EclipseGrid.
     void GridManager::initFromEclipseGrid(Opm::EclipseGridConstPtr eclipseGrid,
                                           const std::vector<double>& poreVolumes)
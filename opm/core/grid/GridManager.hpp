@@ -23,6 +23,8 @@
 #include <opm/parser/eclipse/Deck/Deck.hpp>
 #include <opm/parser/eclipse/EclipseState/Grid/EclipseGrid.hpp>
 
+#include <opm/core/utility/MemoryUsage.hpp>
+
 #include <string>
 
 struct UnstructuredGrid;
@@ -38,7 +40,7 @@ namespace Opm
     ///   - 2d cartesian grids
     ///   - 3d cartesian grids
     /// The resulting UnstructuredGrid is available through the c_grid() method.
-    class GridManager
+    class GridManager : public MemoryUsageInterface
     {
     public:
         /// Construct a 3d corner-point grid or tensor grid from a deck.
@@ -81,6 +83,9 @@ namespace Opm
         /// to make it clear that we are returning a C-compatible struct.
         const UnstructuredGrid* c_grid() const;
 
+        /// Number of bytes held by the managed UnstructuredGrid.
+        virtual std::size_t memoryUsage() const;
+
         static void createGrdecl(Opm::DeckConstPtr deck, struct grdecl &grdecl);
 
     private:
@@ -0,0 +1,541 @@
+/*
+  Copyright 2015 SINTEF ICT, Applied Mathematics.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "config.h"
+#include <opm/core/grid/GridPartition.hpp>
+#include <opm/core/simulator/SimulatorState.hpp>
+#include <opm/common/ErrorMacros.hpp>
+
+#if HAVE_MPI && HAVE_DUNE_ISTL
+#include <opm/core/linalg/ParallelIstlInformation.hpp>
+#endif
+
+#include <algorithm>
+#include <cstdlib>
+#include <deque>
+#include <stdexcept>
+#include <vector>
+
+namespace Opm
+{
+
+    namespace
+    {
+
+        // Breadth-first ordering of the cells marked with 'mark' in
+        // the 'in_set' array, starting from 'start'. Components not
+        // reachable from 'start' are appended, each in breadth-first
+        // order from its first cell in 'cells'.
+        void bfsOrder(const UnstructuredGrid& grid,
+                      const std::vector<int>& cells,
+                      const int start,
+                      const std::vector<int>& in_set,
+                      const int mark,
+                      std::vector<int>& visited,
+                      std::vector<int>& order)
+        {
+            order.clear();
+            std::deque<int> queue;
+            std::vector<int>::const_iterator next = cells.begin();
+            int seed = start;
+            while (true) {
+                visited[seed] = mark;
+                queue.push_back(seed);
+                while (!queue.empty()) {
+                    const int cell = queue.front();
+                    queue.pop_front();
+                    order.push_back(cell);
+                    for (int i = grid.cell_facepos[cell]; i < grid.cell_facepos[cell + 1]; ++i) {
+                        const int f = grid.cell_faces[i];
+                        const int other = grid.face_cells[2*f] == cell
+                            ? grid.face_cells[2*f + 1] : grid.face_cells[2*f];
+                        if (other >= 0 && in_set[other] == mark && visited[other] != mark) {
+                            visited[other] = mark;
+                            queue.push_back(other);
+                        }
+                    }
+                }
+                while (next != cells.end() && visited[*next] == mark) {
+                    ++next;
+                }
+                if (next == cells.end()) {
+                    break;
+                }
+                seed = *next;
+            }
+        }
+
+        void bisect(const UnstructuredGrid& grid,
+                    const std::vector<int>& cells,
+                    const int num_parts,
+                    const int first_part,
+                    std::vector<int>& in_set,
+                    std::vector<int>& visited,
+                    int& mark,
+                    std::vector<int>& cell_part)
+        {
+            if (num_parts == 1 || cells.size() <= 1) {
+                for (std::vector<int>::size_type i = 0; i < cells.size(); ++i) {
+                    cell_part[cells[i]] = first_part;
+                }
+                return;
+            }
+
+            // Find a pseudo-peripheral cell by two sweeps, and order
+            // the cells breadth-first from it.
+            const int set_mark = ++mark;
+            for (std::vector<int>::size_type i = 0; i < cells.size(); ++i) {
+                in_set[cells[i]] = set_mark;
+            }
+            std::vector<int> order;
+            bfsOrder(grid, cells, cells.front(), in_set, set_mark, visited, order);
+            const int peripheral = order.back();
+            // Re-mark the set, so that the second sweep sees it unvisited.
+            const int sweep_mark = ++mark;
+            for (std::vector<int>::size_type i = 0; i < cells.size(); ++i) {
+                in_set[cells[i]] = sweep_mark;
+            }
+            bfsOrder(grid, cells, peripheral, in_set, sweep_mark, visited, order);
+
+            // Split proportionally to the number of parts on each side.
+            const int parts_first = num_parts/2;
+            const std::vector<int>::size_type split
+                = (cells.size()*parts_first)/num_parts;
+            std::vector<int> first(order.begin(), order.begin() + split);
+            std::vector<int> second(order.begin() + split, order.end());
+            std::sort(first.begin(), first.end());
+            std::sort(second.begin(), second.end());
+            bisect(grid, first, parts_first, first_part,
+                   in_set, visited, mark, cell_part);
+            bisect(grid, second, num_parts - parts_first, first_part + parts_first,
+                   in_set, visited, mark, cell_part);
+        }
+
+    } // anonymous namespace
+
+
+
+    void partitionCellGraph(const UnstructuredGrid& grid,
+                            const int num_parts,
+                            std::vector<int>& cell_part)
+    {
+        if (num_parts < 1) {
+            OPM_THROW(std::runtime_error, "Number of parts must be positive, got " << num_parts);
+        }
+        const int nc = grid.number_of_cells;
+        cell_part.assign(nc, 0);
+        std::vector<int> cells(nc);
+        for (int c = 0; c < nc; ++c) {
+            cells[c] = c;
+        }
+        std::vector<int> in_set(nc, 0);
+        std::vector<int> visited(nc, 0);
+        int mark = 0;
+        if (nc > 0) {
+            bisect(grid, cells, num_parts, 0, in_set, visited, mark, cell_part);
+        }
+    }
+
+
+
+
+    SubdomainGrid::SubdomainGrid(const UnstructuredGrid& grid,
+                                 const std::vector<int>& cell_part,
+                                 const int part)
+        : ug_(0),
+          part_(part),
+          num_owned_(0),
+          num_global_cells_(grid.number_of_cells)
+    {
+        const int nc = grid.number_of_cells;
+        const int nf = grid.number_of_faces;
+        const int dim = grid.dimensions;
+        if (int(cell_part.size()) != nc) {
+            OPM_THROW(std::runtime_error, "Partition has " << cell_part.size()
+                      << " entries, grid has " << nc << " cells.");
+        }
+
+        // Owned cells, then one layer of ghost cells.
+        std::vector<int> ghosts;
+        for (int c = 0; c < nc; ++c) {
+            if (cell_part[c] != part) {
+                continue;
+            }
+            global_cell_.push_back(c);
+            for (int i = grid.cell_facepos[c]; i < grid.cell_facepos[c + 1]; ++i) {
+                const int f = grid.cell_faces[i];
+                for (int side = 0; side < 2; ++side) {
+                    const int other = grid.face_cells[2*f + side];
+                    if (other >= 0 && cell_part[other] != part) {
+                        ghosts.push_back(other);
+                    }
+                }
+            }
+        }
+        num_owned_ = global_cell_.size();
+        std::sort(ghosts.begin(), ghosts.end());
+        ghosts.erase(std::unique(ghosts.begin(), ghosts.end()), ghosts.end());
+        global_cell_.insert(global_cell_.end(), ghosts.begin(), ghosts.end());
+        const int nlc = global_cell_.size();
+        cell_owner_.resize(nlc);
+        std::vector<int> local_cell(nc, -1);
+        for (int lc = 0; lc < nlc; ++lc) {
+            local_cell[global_cell_[lc]] = lc;
+            cell_owner_[lc] = cell_part[global_cell_[lc]];
+        }
+
+        // Faces and nodes of the local cells.
+        std::vector<int> local_face(nf, -1);
+        std::vector<int> local_node(grid.number_of_nodes, -1);
+        int num_cellfaces = 0;
+        for (int lc = 0; lc < nlc; ++lc) {
+            const int c = global_cell_[lc];
+            for (int i = grid.cell_facepos[c]; i < grid.cell_facepos[c + 1]; ++i) {
+                local_face[grid.cell_faces[i]] = 0;
+                ++num_cellfaces;
+            }
+        }
+        int num_facenodes = 0;
+        for (int f = 0; f < nf; ++f) {
+            if (local_face[f] == 0) {
+                local_face[f] = global_face_.size();
+                global_face_.push_back(f);
+                for (int i = grid.face_nodepos[f]; i < grid.face_nodepos[f + 1]; ++i) {
+                    local_node[grid.face_nodes[i]] = 0;
+                    ++num_facenodes;
+                }
+            }
+        }
+        std::vector<int> global_node;
+        for (int n = 0; n < grid.number_of_nodes; ++n) {
+            if (local_node[n] == 0) {
+                local_node[n] = global_node.size();
+                global_node.push_back(n);
+            }
+        }
+        const int nlf = global_face_.size();
+        const int nln = global_node.size();
+
+        ug_ = allocate_grid(dim, nlc, nlf, num_facenodes, num_cellfaces, nln);
+        if (ug_ == 0) {
+            OPM_THROW(std::runtime_error, "Failed to allocate subdomain grid.");
+        }
+
+        for (int ln = 0; ln < nln; ++ln) {
+            std::copy(grid.node_coordinates + dim*global_node[ln],
+                      grid.node_coordinates + dim*(global_node[ln] + 1),
+                      ug_->node_coordinates + dim*ln);
+        }
+
+        ug_->face_nodepos[0] = 0;
+        for (int lf = 0; lf < nlf; ++lf) {
+            const int f = global_face_[lf];
+            int pos = ug_->face_nodepos[lf];
+            for (int i = grid.face_nodepos[f]; i < grid.face_nodepos[f + 1]; ++i) {
+                ug_->face_nodes[pos++] = local_node[grid.face_nodes[i]];
+            }
+            ug_->face_nodepos[lf + 1] = pos;
+            for (int side = 0; side < 2; ++side) {
+                const int c = grid.face_cells[2*f + side];
+                ug_->face_cells[2*lf + side] = (c >= 0) ? local_cell[c] : -1;
+            }
+            std::copy(grid.face_centroids + dim*f, grid.face_centroids + dim*(f + 1),
+                      ug_->face_centroids + dim*lf);
+            std::copy(grid.face_normals + dim*f, grid.face_normals + dim*(f + 1),
+                      ug_->face_normals + dim*lf);
+            ug_->face_areas[lf] = grid.face_areas[f];
+        }
+
+        ug_->cell_facepos[0] = 0;
+        for (int lc = 0; lc < nlc; ++lc) {
+            const int c = global_cell_[lc];
+            int pos = ug_->cell_facepos[lc];
+            for (int i = grid.cell_facepos[c]; i < grid.cell_facepos[c + 1]; ++i) {
+                if (grid.cell_facetag != 0) {
+                    ug_->cell_facetag[pos] = grid.cell_facetag[i];
+                }
+                ug_->cell_faces[pos++] = local_face[grid.cell_faces[i]];
+            }
+            ug_->cell_facepos[lc + 1] = pos;
+            std::copy(grid.cell_centroids + dim*c, grid.cell_centroids + dim*(c + 1),
+                      ug_->cell_centroids + dim*lc);
+            ug_->cell_volumes[lc] = grid.cell_volumes[c];
+        }
+        if (grid.cell_facetag == 0) {
+            free(ug_->cell_facetag);
+            ug_->cell_facetag = 0;
+        }
+
+        ug_->global_cell = static_cast<int*>(malloc(nlc * sizeof *ug_->global_cell));
+        if (ug_->global_cell == 0) {
+            destroy_grid(ug_);
+            OPM_THROW(std::runtime_error, "Failed to allocate subdomain grid.");
+        }
+        for (int lc = 0; lc < nlc; ++lc) {
+            const int c = global_cell_[lc];
+            ug_->global_cell[lc] = grid.global_cell ? grid.global_cell[c] : c;
+        }
+        std::copy(grid.cartdims, grid.cartdims + 3, ug_->cartdims);
+    }
+
+
+
+    SubdomainGrid::~SubdomainGrid()
+    {
+        destroy_grid(ug_);
+    }
+
+
+
+    const UnstructuredGrid* SubdomainGrid::c_grid() const
+    {
+        return ug_;
+    }
+
+
+
+    int SubdomainGrid::part() const
+    {
+        return part_;
+    }
+
+
+
+    int SubdomainGrid::numOwnedCells() const
+    {
+        return num_owned_;
+    }
+
+
+
+    const std::vector<int>& SubdomainGrid::globalCell() const
+    {
+        return global_cell_;
+    }
+
+
+
+    const std::vector<int>& SubdomainGrid::globalFace() const
+    {
+        return global_face_;
+    }
+
+
+
+    const std::vector<int>& SubdomainGrid::cellOwner() const
+    {
+        return cell_owner_;
+    }
+
+
+
+    int SubdomainGrid::localCell(const int global_cell) const
+    {
+        // Owned and ghost cells are each sorted by global index.
+        std::vector<int>::const_iterator mid = global_cell_.begin() + num_owned_;
+        std::vector<int>::const_iterator it
+            = std::lower_bound(global_cell_.begin(), mid, global_cell);
+        if (it != mid && *it == global_cell) {
+            return it - global_cell_.begin();
+        }
+        it = std::lower_bound(mid, global_cell_.end(), global_cell);
+        if (it != global_cell_.end() && *it == global_cell) {
+            return it - global_cell_.begin();
+        }
+        return -1;
+    }
+
+
+
+    void SubdomainGrid::extractCellData(const std::vector<double>& global_data,
+                                        std::vector<double>& local_data) const
+    {
+        const int stride = num_global_cells_ > 0 ? global_data.size()/num_global_cells_ : 0;
+        const int nlc = global_cell_.size();
+        local_data.resize(nlc*stride);
+        for (int lc = 0; lc < nlc; ++lc) {
+            for (int k = 0; k < stride; ++k) {
+                local_data[stride*lc + k] = global_data[stride*global_cell_[lc] + k];
+            }
+        }
+    }
+
+
+
+    void SubdomainGrid::insertOwnedCellData(const std::vector<double>& local_data,
+                                            std::vector<double>& global_data) const
+    {
+        const int nlc = global_cell_.size();
+        const int stride = nlc > 0 ? local_data.size()/nlc : 0;
+        for (int lc = 0; lc < num_owned_; ++lc) {
+            for (int k = 0; k < stride; ++k) {
+                global_data[stride*global_cell_[lc] + k] = local_data[stride*lc + k];
+            }
+        }
+    }
+
+
+
+#if HAVE_MPI
+    CellHaloExchange::CellHaloExchange(const SubdomainGrid& subdomain, MPI_Comm comm)
+        : comm_(comm),
+          num_cells_(subdomain.globalCell().size())
+    {
+        int size;
+        MPI_Comm_size(comm_, &size);
+
+        // Ghost cells are sorted by global index, so grouping them by
+        // owner gives the receive lists.
+        const std::vector<int>& global_cell = subdomain.globalCell();
+        const std::vector<int>& owner = subdomain.cellOwner();
+        std::vector<int> recv_count(size, 0);
+        for (int lc = subdomain.numOwnedCells(); lc < num_cells_; ++lc) {
+            if (owner[lc] >= size) {
+                OPM_THROW(std::runtime_error, "Cell owner " << owner[lc]
+                          << " is not a rank of the communicator.");
+            }
+            ++recv_count[owner[lc]];
+        }
+        std::vector<int> recv_displ(size + 1, 0);
+        for (int p = 0; p < size; ++p) {
+            recv_displ[p + 1] = recv_displ[p] + recv_count[p];
+        }
+        std::vector<int> requested(recv_displ[size]);
+        std::vector<int> requested_local(recv_displ[size]);
+        {
+            std::vector<int> next(recv_displ.begin(), recv_displ.end() - 1);
+            for (int lc = subdomain.numOwnedCells(); lc < num_cells_; ++lc) {
+                requested[next[owner[lc]]] = global_cell[lc];
+                requested_local[next[owner[lc]]++] = lc;
+            }
+        }
+
+        // Tell the owners which of their cells we need.
+        std::vector<int> send_count(size);
+        MPI_Alltoall(&recv_count[0], 1, MPI_INT, &send_count[0], 1, MPI_INT, comm_);
+        std::vector<int> send_displ(size + 1, 0);
+        for (int p = 0; p < size; ++p) {
+            send_displ[p + 1] = send_displ[p] + send_count[p];
+        }
+        std::vector<int> send_global(send_displ[size]);
+        MPI_Alltoallv(requested.empty() ? 0 : &requested[0], &recv_count[0], &recv_displ[0], MPI_INT,
+                      send_global.empty() ? 0 : &send_global[0], &send_count[0], &send_displ[0], MPI_INT,
+                      comm_);
+
+        // Set up the per-neighbour lists.
+        send_start_.push_back(0);
+        recv_start_.push_back(0);
+        for (int p = 0; p < size; ++p) {
+            if (send_count[p] == 0 && recv_count[p] == 0) {
+                continue;
+            }
+            neighbours_.push_back(p);
+            for (int i = send_displ[p]; i < send_displ[p + 1]; ++i) {
+                const int lc = subdomain.localCell(send_global[i]);
+                if (lc < 0 || lc >= subdomain.numOwnedCells()) {
+                    OPM_THROW(std::runtime_error, "Rank " << p << " requested cell "
+                              << send_global[i] << ", which is not owned here.");
+                }
+                send_cells_.push_back(lc);
+            }
+            send_start_.push_back(send_cells_.size());
+            recv_cells_.insert(recv_cells_.end(),
+                               requested_local.begin() + recv_displ[p],
+                               requested_local.begin() + recv_displ[p + 1]);
+            recv_start_.push_back(recv_cells_.size());
+        }
+    }
+
+
+
+    void CellHaloExchange::exchange(std::vector<double>& data) const
+    {
+        const int stride = num_cells_ > 0 ? data.size()/num_cells_ : 0;
+        const int num_nb = neighbours_.size();
+        std::vector<double> send_buf(stride*send_cells_.size());
+        std::vector<double> recv_buf(stride*recv_cells_.size());
+        for (std::vector<int>::size_type i = 0; i < send_cells_.size(); ++i) {
+            std::copy(data.begin() + stride*send_cells_[i],
+                      data.begin() + stride*(send_cells_[i] + 1),
+                      send_buf.begin() + stride*i);
+        }
+        std::vector<MPI_Request> requests;
+        requests.reserve(2*num_nb);
+        const int tag = 4711;
+        for (int n = 0; n < num_nb; ++n) {
+            const int count = stride*(recv_start_[n + 1] - recv_start_[n]);
+            if (count > 0) {
+                requests.push_back(MPI_Request());
+                MPI_Irecv(&recv_buf[stride*recv_start_[n]], count, MPI_DOUBLE,
+                          neighbours_[n], tag, comm_, &requests.back());
+            }
+        }
+        for (int n = 0; n < num_nb; ++n) {
+            const int count = stride*(send_start_[n + 1] - send_start_[n]);
+            if (count > 0) {
+                requests.push_back(MPI_Request());
+                MPI_Isend(&send_buf[stride*send_start_[n]], count, MPI_DOUBLE,
+                          neighbours_[n], tag, comm_, &requests.back());
+            }
+        }
+        if (!requests.empty()) {
+            MPI_Waitall(requests.size(), &requests[0], MPI_STATUSES_IGNORE);
+        }
+        for (std::vector<int>::size_type i = 0; i < recv_cells_.size(); ++i) {
+            std::copy(recv_buf.begin() + stride*i,
+                      recv_buf.begin() + stride*(i + 1),
+                      data.begin() + stride*recv_cells_[i]);
+        }
+    }
+
+
+
+    void CellHaloExchange::exchange(SimulatorState& state) const
+    {
+        std::vector<std::vector<double> >& fields = state.cellData();
+        for (std::vector<std::vector<double> >::size_type i = 0; i < fields.size(); ++i) {
+            exchange(fields[i]);
+        }
+    }
+#endif // HAVE_MPI
+
+
+
+#if HAVE_MPI && HAVE_DUNE_ISTL
+    void buildParallelInformation(const SubdomainGrid& subdomain,
+                                  ParallelISTLInformation& info)
+    {
+        typedef ParallelISTLInformation::ParallelIndexSet IndexSet;
+        typedef Dune::OwnerOverlapCopyAttributeSet::AttributeSet Attribute;
+        IndexSet& index_set = *info.indexSet();
+        const std::vector<int>& global_cell = subdomain.globalCell();
+        const int nlc = global_cell.size();
+        index_set.beginResize();
+        for (int lc = 0; lc < nlc; ++lc) {
+            const Attribute attr = lc < subdomain.numOwnedCells()
+                ? Dune::OwnerOverlapCopyAttributeSet::owner
+                : Dune::OwnerOverlapCopyAttributeSet::copy;
+            index_set.add(global_cell[lc], IndexSet::LocalIndex(lc, attr, true));
+        }
+        index_set.endResize();
+        info.remoteIndices()->rebuild<false>();
+    }
+#endif
+
+} // namespace Opm
@@ -0,0 +1,165 @@
+/*
+  Copyright 2015 SINTEF ICT, Applied Mathematics.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OPM_GRIDPARTITION_HEADER_INCLUDED
+#define OPM_GRIDPARTITION_HEADER_INCLUDED
+
+#include <opm/core/grid.h>
+
+#if HAVE_MPI
+#include <opm/common/utility/platform_dependent/disable_warnings.h>
+#include <mpi.h>
+#include <opm/common/utility/platform_dependent/reenable_warnings.h>
+#endif
+
+#include <vector>
+
+namespace Opm
+{
+
+    class SimulatorState;
+    class ParallelISTLInformation;
+
+    /// Partition the cells of a grid into parts of (nearly) equal size.
+    /// The partition is computed by recursive bisection of the cell
+    /// graph (cells connected by faces), splitting breadth-first
+    /// orderings that start from pseudo-peripheral cells. The result
+    /// is deterministic, so all processes computing it get the same
+    /// partition.
+    /// \param[in]  grid       A grid object.
+    /// \param[in]  num_parts  Number of parts, at least 1.
+    /// \param[out] cell_part  The part of each cell, in [0, num_parts).
+    void partitionCellGraph(const UnstructuredGrid& grid,
+                            const int num_parts,
+                            std::vector<int>& cell_part);
+
+
+    /// The subdomain of a partitioned grid belonging to one part, with
+    /// one layer of ghost cells. The subdomain is itself an
+    /// UnstructuredGrid, in which the owned cells are numbered first
+    /// (in increasing global order), followed by the ghost cells.
+    /// Faces between a ghost cell and a cell outside the subdomain
+    /// become boundary faces. The global_cell field of the subdomain
+    /// grid maps to the same logical cartesian indices as the global
+    /// grid, so properties may be set up from a deck as usual.
+    class SubdomainGrid
+    {
+    public:
+        /// Construct subdomain.
+        /// \param[in] grid       The global grid.
+        /// \param[in] cell_part  Part of each global cell, such as
+        ///                       from partitionCellGraph().
+        /// \param[in] part       The part owning this subdomain.
+        SubdomainGrid(const UnstructuredGrid& grid,
+                      const std::vector<int>& cell_part,
+                      const int part);
+
+        /// Destructor.
+        ~SubdomainGrid();
+
+        /// Access the underlying C grid.
+        const UnstructuredGrid* c_grid() const;
+
+        /// The part owning this subdomain.
+        int part() const;
+
+        /// Number of cells owned by this subdomain. These are the
+        /// first cells of the subdomain grid.
+        int numOwnedCells() const;
+
+        /// Global index of each local cell.
+        const std::vector<int>& globalCell() const;
+
+        /// Global index of each local face.
+        const std::vector<int>& globalFace() const;
+
+        /// Owning part of each local cell.
+        const std::vector<int>& cellOwner() const;
+
+        /// Local index of a global cell, or -1 if it is not in the
+        /// subdomain.
+        int localCell(const int global_cell) const;
+
+        /// Copy per-cell data from a global field to a local one. The
+        /// number of values per cell is deduced from the field size.
+        void extractCellData(const std::vector<double>& global_data,
+                             std::vector<double>& local_data) const;
+
+        /// Copy per-cell data of the owned cells from a local field
+        /// to a global one. Other global values are left untouched.
+        void insertOwnedCellData(const std::vector<double>& local_data,
+                                 std::vector<double>& global_data) const;
+
+    private:
+        // Disable copying and assignment.
+        SubdomainGrid(const SubdomainGrid& other);
+        SubdomainGrid& operator=(const SubdomainGrid& other);
+
+        UnstructuredGrid* ug_;
+        int part_;
+        int num_owned_;
+        int num_global_cells_;
+        std::vector<int> global_cell_;
+        std::vector<int> global_face_;
+        std::vector<int> cell_owner_;
+    };
+
+
+#if HAVE_MPI
+    /// Halo exchange for per-cell data on a SubdomainGrid, assuming
+    /// that part p is handled by rank p of the communicator. After an
+    /// exchange, ghost cells hold the values of their owners.
+    class CellHaloExchange
+    {
+    public:
+        /// Set up communication pattern. Collective.
+        CellHaloExchange(const SubdomainGrid& subdomain, MPI_Comm comm);
+
+        /// Update the ghost values of a cell field. The number of
+        /// values per cell is deduced from the field size. Collective.
+        void exchange(std::vector<double>& data) const;
+
+        /// Update the ghost values of all cell fields of a state.
+        /// Collective.
+        void exchange(SimulatorState& state) const;
+
+    private:
+        MPI_Comm comm_;
+        int num_cells_;
+        std::vector<int> neighbours_;  // ranks we communicate with
+        std::vector<int> send_start_;  // per neighbour, into send_cells_
+        std::vector<int> send_cells_;  // owned cells to send
+        std::vector<int> recv_start_;  // per neighbour, into recv_cells_
+        std::vector<int> recv_cells_;  // ghost cells to receive
+    };
+#endif // HAVE_MPI
+
+
+#if HAVE_MPI && HAVE_DUNE_ISTL
+    /// Set up the index set and remote indices of a parallel
+    /// information object for solving on a SubdomainGrid with the
+    /// dune-istl solvers. Owned cells get the owner attribute, and
+    /// ghost cells the copy attribute. Collective.
+    void buildParallelInformation(const SubdomainGrid& subdomain,
+                                  ParallelISTLInformation& info);
+#endif
+
+} // namespace Opm
+
+#endif // OPM_GRIDPARTITION_HEADER_INCLUDED
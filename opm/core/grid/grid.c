@@ -55,6 +55,44 @@ destroy_grid(struct UnstructuredGrid *g)
 }
 
 
+size_t
+grid_memory_usage(const struct UnstructuredGrid *g)
+{
+    size_t nbytes, nc, nf, nn, nd, nfn, ncf;
+
+    if (g == NULL) {
+        return 0;
+    }
+
+    nd  = g->dimensions;
+    nc  = g->number_of_cells;
+    nf  = g->number_of_faces;
+    nn  = g->number_of_nodes;
+    nfn = (g->face_nodepos != NULL) ? g->face_nodepos[nf] : 0;
+    ncf = (g->cell_facepos != NULL) ? g->cell_facepos[nc] : 0;
+
+    nbytes = sizeof *g;
+
+    if (g->face_nodes       != NULL) { nbytes += nfn      * sizeof *g->face_nodes;       }
+    if (g->face_nodepos     != NULL) { nbytes += (nf + 1) * sizeof *g->face_nodepos;     }
+    if (g->face_cells       != NULL) { nbytes += 2 * nf   * sizeof *g->face_cells;       }
+    if (g->cell_faces       != NULL) { nbytes += ncf      * sizeof *g->cell_faces;       }
+    if (g->cell_facepos     != NULL) { nbytes += (nc + 1) * sizeof *g->cell_facepos;     }
+
+    if (g->node_coordinates != NULL) { nbytes += nd * nn  * sizeof *g->node_coordinates; }
+    if (g->face_centroids   != NULL) { nbytes += nd * nf  * sizeof *g->face_centroids;   }
+    if (g->face_areas       != NULL) { nbytes += nf       * sizeof *g->face_areas;       }
+    if (g->face_normals     != NULL) { nbytes += nd * nf  * sizeof *g->face_normals;     }
+    if (g->cell_centroids   != NULL) { nbytes += nd * nc  * sizeof *g->cell_centroids;   }
+    if (g->cell_volumes     != NULL) { nbytes += nc       * sizeof *g->cell_volumes;     }
+
+    if (g->global_cell      != NULL) { nbytes += nc       * sizeof *g->global_cell;      }
+    if (g->cell_facetag     != NULL) { nbytes += ncf      * sizeof *g->cell_facetag;     }
+
+    return nbytes;
+}
+
+
 struct UnstructuredGrid *
 create_grid_empty(void)
 {
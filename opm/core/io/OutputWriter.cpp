@@ -2,6 +2,7 @@
 
 #include <opm/core/grid.h>
 #include <opm/core/io/eclipse/EclipseWriter.hpp>
+#include <opm/core/io/checkpoint/Checkpoint.hpp>
 #include <opm/core/utility/parameters/Parameter.hpp>
 #include <opm/core/utility/parameters/ParameterGroup.hpp>
 
@@ -71,6 +72,7 @@ typedef map <const char*, unique_ptr <OutputWriter> (*)(
         std::shared_ptr <const UnstructuredGrid>)> map_t;
 map_t FORMATS = {
     { "output_ecl", &create <EclipseWriter> },
+    { "output_checkpoint", &create <CheckpointWriter> },
 };
 
 } // anonymous namespace
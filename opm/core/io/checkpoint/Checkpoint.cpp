@@ -0,0 +1,536 @@
+/*
+  Copyright 2015 SINTEF ICT, Applied Mathematics.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "config.h"
+#include <opm/core/io/checkpoint/Checkpoint.hpp>
+#include <opm/core/simulator/SimulatorState.hpp>
+#include <opm/core/simulator/WellState.hpp>
+#include <opm/core/utility/parameters/ParameterGroup.hpp>
+#include <opm/common/ErrorMacros.hpp>
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <exception>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <thread>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define OPM_CHECKPOINT_MMAP 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace Opm
+{
+
+    namespace
+    {
+        const char magic[8] = { 'O', 'P', 'M', 'C', 'K', 'P', 'T', '\0' };
+        const std::uint32_t version = 1;
+        const std::uint32_t byteOrderMark = 0x01020304;
+
+        enum Encoding { Raw = 0, XorZeroBytes = 1 };
+
+        /// Copy of everything stored in a checkpoint, so that it can be
+        /// written while the simulator modifies the original state.
+        struct Snapshot
+        {
+            CheckpointTime time;
+            int numCells;
+            int numFaces;
+            int numPhases;
+            std::vector<std::string> cellNames;
+            std::vector<std::vector<double> > cellData;
+            std::vector<std::string> faceNames;
+            std::vector<std::vector<double> > faceData;
+            std::vector<std::vector<double> > wellData;
+        };
+
+        /// The WellState vectors in the order they are stored.
+        std::vector<std::vector<double>*> wellVectors(WellState& ws)
+        {
+            std::vector<std::vector<double>*> v;
+            v.push_back(&ws.bhp());
+            v.push_back(&ws.thp());
+            v.push_back(&ws.temperature());
+            v.push_back(&ws.wellRates());
+            v.push_back(&ws.perfRates());
+            v.push_back(&ws.perfPress());
+            return v;
+        }
+
+        Snapshot takeSnapshot(const SimulatorTimerInterface& timer,
+                              const SimulatorState& state,
+                              const WellState& wellState)
+        {
+            Snapshot s;
+            s.time.stepNum    = timer.currentStepNum();
+            s.time.elapsed    = timer.simulationTimeElapsed();
+            // the step length is undefined once the timer is done
+            s.time.stepLength = timer.done() ? 0.0 : timer.currentStepLength();
+            s.numCells  = state.numCells();
+            s.numFaces  = state.numFaces();
+            s.numPhases = state.numPhases();
+            s.cellNames = state.cellDataNames();
+            s.cellData  = state.cellData();
+            s.faceNames = state.faceDataNames();
+            s.faceData  = state.faceData();
+            // same order as wellVectors()
+            s.wellData.push_back(wellState.bhp());
+            s.wellData.push_back(wellState.thp());
+            s.wellData.push_back(wellState.temperature());
+            s.wellData.push_back(wellState.wellRates());
+            s.wellData.push_back(wellState.perfRates());
+            s.wellData.push_back(wellState.perfPress());
+            return s;
+        }
+
+        // --- Output buffer ---
+
+        template <class T>
+        void put(std::vector<char>& out, const T& value)
+        {
+            const char* p = reinterpret_cast<const char*>(&value);
+            out.insert(out.end(), p, p + sizeof(T));
+        }
+
+        void putString(std::vector<char>& out, const std::string& s)
+        {
+            put(out, std::uint32_t(s.size()));
+            out.insert(out.end(), s.begin(), s.end());
+        }
+
+        /// Xor each value with its predecessor and store the number of
+        /// leading zero bytes followed by the remaining low order bytes.
+        void encodeXor(const std::vector<double>& v, std::vector<char>& out)
+        {
+            std::uint64_t prev = 0;
+            for (std::size_t i = 0; i < v.size(); ++i) {
+                std::uint64_t bits;
+                std::memcpy(&bits, &v[i], sizeof(bits));
+                std::uint64_t x = bits ^ prev;
+                prev = bits;
+                int nbytes = 0;
+                for (std::uint64_t y = x; y != 0; y >>= 8) {
+                    ++nbytes;
+                }
+                out.push_back(char(8 - nbytes));
+                for (int b = 0; b < nbytes; ++b, x >>= 8) {
+                    out.push_back(char(x & 0xff));
+                }
+            }
+        }
+
+        void putArray(std::vector<char>& out, const std::vector<double>& v, const bool compress)
+        {
+            put(out, std::uint64_t(v.size()));
+            put(out, std::uint8_t(compress ? XorZeroBytes : Raw));
+            const std::size_t sizePos = out.size();
+            put(out, std::uint64_t(0));
+            const std::size_t start = out.size();
+            if (compress) {
+                encodeXor(v, out);
+            } else if (!v.empty()) {
+                const char* p = reinterpret_cast<const char*>(&v[0]);
+                out.insert(out.end(), p, p + v.size()*sizeof(double));
+            }
+            const std::uint64_t nbytes = out.size() - start;
+            std::memcpy(&out[sizePos], &nbytes, sizeof(nbytes));
+        }
+
+        void putFields(std::vector<char>& out,
+                       const std::vector<std::string>& names,
+                       const std::vector<std::vector<double> >& data,
+                       const bool compress)
+        {
+            put(out, std::uint32_t(data.size()));
+            for (std::size_t i = 0; i < data.size(); ++i) {
+                putString(out, i < names.size() ? names[i] : std::string());
+                putArray(out, data[i], compress);
+            }
+        }
+
+        void writeSnapshot(const std::string& filename, const Snapshot& s, const bool compress)
+        {
+            std::vector<char> out;
+            out.insert(out.end(), magic, magic + sizeof(magic));
+            put(out, version);
+            put(out, byteOrderMark);
+            put(out, std::int32_t(s.time.stepNum));
+            put(out, s.time.elapsed);
+            put(out, s.time.stepLength);
+            put(out, std::int32_t(s.numCells));
+            put(out, std::int32_t(s.numFaces));
+            put(out, std::int32_t(s.numPhases));
+            putFields(out, s.cellNames, s.cellData, compress);
+            putFields(out, s.faceNames, s.faceData, compress);
+            put(out, std::uint32_t(s.wellData.size()));
+            for (std::size_t i = 0; i < s.wellData.size(); ++i) {
+                putArray(out, s.wellData[i], compress);
+            }
+
+            const std::string tmpname = filename + ".tmp";
+            {
+                std::ofstream file(tmpname.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+                if (!file) {
+                    OPM_THROW(std::runtime_error, "Could not open checkpoint file " << tmpname << " for writing.");
+                }
+                file.write(out.empty() ? 0 : &out[0], out.size());
+                if (!file) {
+                    OPM_THROW(std::runtime_error, "Failed writing checkpoint file " << tmpname << '.');
+                }
+            }
+            if (std::rename(tmpname.c_str(), filename.c_str()) != 0) {
+                OPM_THROW(std::runtime_error, "Could not rename " << tmpname << " to " << filename << '.');
+            }
+        }
+
+        // --- Input ---
+
+        /// Read-only view of a checkpoint file, memory mapped if possible.
+        class MappedFile
+        {
+        public:
+            explicit MappedFile(const std::string& filename)
+                : data_(0), size_(0), mapped_(false)
+            {
+#ifdef OPM_CHECKPOINT_MMAP
+                const int fd = ::open(filename.c_str(), O_RDONLY);
+                if (fd < 0) {
+                    OPM_THROW(std::runtime_error, "Could not open checkpoint file " << filename << '.');
+                }
+                struct stat st;
+                if (::fstat(fd, &st) == 0 && st.st_size > 0) {
+                    void* p = ::mmap(0, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+                    if (p != MAP_FAILED) {
+                        data_ = static_cast<const char*>(p);
+                        size_ = st.st_size;
+                        mapped_ = true;
+                    }
+                }
+                ::close(fd);
+                if (mapped_) {
+                    return;
+                }
+#endif
+                std::ifstream file(filename.c_str(), std::ios::in | std::ios::binary);
+                if (!file) {
+                    OPM_THROW(std::runtime_error, "Could not open checkpoint file " << filename << '.');
+                }
+                buffer_.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+                data_ = buffer_.empty() ? 0 : &buffer_[0];
+                size_ = buffer_.size();
+            }
+
+            ~MappedFile()
+            {
+#ifdef OPM_CHECKPOINT_MMAP
+                if (mapped_) {
+                    ::munmap(const_cast<char*>(data_), size_);
+                }
+#endif
+            }
+
+            const char* data() const { return data_; }
+            std::size_t size() const { return size_; }
+
+        private:
+            MappedFile(const MappedFile&);
+            MappedFile& operator=(const MappedFile&);
+
+            const char* data_;
+            std::size_t size_;
+            bool mapped_;
+            std::vector<char> buffer_;
+        };
+
+        /// Bounds checked sequential reader over the file contents.
+        class Reader
+        {
+        public:
+            Reader(const char* data, const std::size_t size, const std::string& filename)
+                : data_(data), size_(size), pos_(0), filename_(filename)
+            {}
+
+            const char* take(const std::size_t n)
+            {
+                if (n > size_ - pos_) {
+                    OPM_THROW(std::runtime_error, "Checkpoint file " << filename_ << " is truncated.");
+                }
+                const char* p = data_ + pos_;
+                pos_ += n;
+                return p;
+            }
+
+            template <class T>
+            T get()
+            {
+                T value;
+                std::memcpy(&value, take(sizeof(T)), sizeof(T));
+                return value;
+            }
+
+            std::string getString()
+            {
+                const std::uint32_t n = get<std::uint32_t>();
+                const char* p = take(n);
+                return std::string(p, p + n);
+            }
+
+            void getArray(std::vector<double>& v)
+            {
+                const std::uint64_t n = get<std::uint64_t>();
+                const std::uint8_t encoding = get<std::uint8_t>();
+                const std::uint64_t nbytes = get<std::uint64_t>();
+                const char* p = take(nbytes);
+                v.resize(n);
+                if (encoding == Raw) {
+                    if (nbytes != n*sizeof(double)) {
+                        corrupt();
+                    }
+                    if (n > 0) {
+                        std::memcpy(&v[0], p, nbytes);
+                    }
+                } else if (encoding == XorZeroBytes) {
+                    const char* end = p + nbytes;
+                    std::uint64_t prev = 0;
+                    for (std::uint64_t i = 0; i < n; ++i) {
+                        if (p == end) {
+                            corrupt();
+                        }
+                        const int zeros = static_cast<unsigned char>(*p++);
+                        const int bytes = 8 - zeros;
+                        if (zeros > 8 || bytes > end - p) {
+                            corrupt();
+                        }
+                        std::uint64_t x = 0;
+                        for (int b = 0; b < bytes; ++b) {
+                            x |= std::uint64_t(static_cast<unsigned char>(*p++)) << (8*b);
+                        }
+                        prev ^= x;
+                        std::memcpy(&v[i], &prev, sizeof(prev));
+                    }
+                } else {
+                    corrupt();
+                }
+            }
+
+            void corrupt() const
+            {
+                OPM_THROW(std::runtime_error, "Checkpoint file " << filename_ << " is corrupt.");
+            }
+
+        private:
+            const char* data_;
+            std::size_t size_;
+            std::size_t pos_;
+            std::string filename_;
+        };
+
+        void getFields(Reader& in,
+                       const std::vector<std::string>& names,
+                       std::vector<std::vector<double> >& data,
+                       const std::string& filename)
+        {
+            const std::uint32_t n = in.get<std::uint32_t>();
+            if (n != data.size()) {
+                OPM_THROW(std::runtime_error, "Checkpoint file " << filename << " has " << n
+                          << " fields, the state has " << data.size() << '.');
+            }
+            for (std::uint32_t i = 0; i < n; ++i) {
+                const std::string name = in.getString();
+                if (i < names.size() && name != names[i]) {
+                    OPM_THROW(std::runtime_error, "Checkpoint field " << name
+                              << " does not match state field " << names[i] << '.');
+                }
+                std::vector<double> values;
+                in.getArray(values);
+                if (values.size() != data[i].size()) {
+                    OPM_THROW(std::runtime_error, "Checkpoint field " << name << " has " << values.size()
+                              << " values, the state has " << data[i].size() << '.');
+                }
+                data[i].swap(values);
+            }
+        }
+    } // anonymous namespace
+
+
+
+    void writeCheckpoint(const std::string& filename,
+                         const SimulatorTimerInterface& timer,
+                         const SimulatorState& state,
+                         const WellState& wellState,
+                         const bool compress)
+    {
+        writeSnapshot(filename, takeSnapshot(timer, state, wellState), compress);
+    }
+
+
+
+    CheckpointTime readCheckpoint(const std::string& filename,
+                                  SimulatorState& state,
+                                  WellState& wellState)
+    {
+        MappedFile file(filename);
+        Reader in(file.data(), file.size(), filename);
+        if (std::memcmp(in.take(sizeof(magic)), magic, sizeof(magic)) != 0) {
+            OPM_THROW(std::runtime_error, filename << " is not a checkpoint file.");
+        }
+        const std::uint32_t fileVersion = in.get<std::uint32_t>();
+        const std::uint32_t fileByteOrder = in.get<std::uint32_t>();
+        if (fileVersion != version || fileByteOrder != byteOrderMark) {
+            OPM_THROW(std::runtime_error, "Checkpoint file " << filename
+                      << " was written by an incompatible version or platform.");
+        }
+        CheckpointTime time;
+        time.stepNum    = in.get<std::int32_t>();
+        time.elapsed    = in.get<double>();
+        time.stepLength = in.get<double>();
+        const int numCells  = in.get<std::int32_t>();
+        const int numFaces  = in.get<std::int32_t>();
+        const int numPhases = in.get<std::int32_t>();
+        if (numCells != state.numCells() || numFaces != state.numFaces() || numPhases != state.numPhases()) {
+            OPM_THROW(std::runtime_error, "Checkpoint file " << filename << " has " << numCells << " cells, "
+                      << numFaces << " faces and " << numPhases << " phases, the state has "
+                      << state.numCells() << ", " << state.numFaces() << " and " << state.numPhases() << '.');
+        }
+        getFields(in, state.cellDataNames(), state.cellData(), filename);
+        getFields(in, state.faceDataNames(), state.faceData(), filename);
+
+        const std::vector<std::vector<double>*> wells = wellVectors(wellState);
+        const std::uint32_t numWellVectors = in.get<std::uint32_t>();
+        if (numWellVectors != wells.size()) {
+            in.corrupt();
+        }
+        for (std::size_t i = 0; i < wells.size(); ++i) {
+            in.getArray(*wells[i]);
+        }
+        return time;
+    }
+
+
+
+    // ---------------- CheckpointWriter ----------------
+
+    struct CheckpointWriter::Impl
+    {
+        std::thread worker;
+        std::exception_ptr error;
+    };
+
+
+
+    CheckpointWriter::CheckpointWriter(const parameter::ParameterGroup& params,
+                                       std::shared_ptr<const EclipseState> /* eclipseState */,
+                                       const PhaseUsage& /* phaseUsage */,
+                                       int /* numCells */,
+                                       const int* /* compressedToCartesianCellIdx */)
+        : pimpl_(new Impl)
+        , filename_(params.getDefault<std::string>("checkpoint_file",
+                                                   params.getDefault<std::string>("output_dir", ".")
+                                                   + "/checkpoint.ockp"))
+        , interval_(params.getDefault<int>("checkpoint_interval", 1))
+        , compress_(params.getDefault<bool>("checkpoint_compress", false))
+        , asynchronous_(params.getDefault<bool>("checkpoint_async", true))
+    {
+    }
+
+
+
+    CheckpointWriter::CheckpointWriter(const std::string& filename,
+                                       const int interval,
+                                       const bool compress,
+                                       const bool asynchronous)
+        : pimpl_(new Impl)
+        , filename_(filename)
+        , interval_(interval)
+        , compress_(compress)
+        , asynchronous_(asynchronous)
+    {
+    }
+
+
+
+    CheckpointWriter::~CheckpointWriter()
+    {
+        try {
+            wait();
+        }
+        catch (const std::exception& e) {
+            std::cerr << "Writing checkpoint failed: " << e.what() << std::endl;
+        }
+    }
+
+
+
+    void CheckpointWriter::writeInit(const SimulatorTimerInterface& /* timer */)
+    {
+    }
+
+
+
+    void CheckpointWriter::writeTimeStep(const SimulatorTimerInterface& timer,
+                                         const SimulatorState& reservoirState,
+                                         const WellState& wellState,
+                                         bool isSubstep)
+    {
+        if (isSubstep || interval_ <= 0 || timer.currentStepNum() % interval_ != 0) {
+            return;
+        }
+        // Only one write in flight, so the file is never written concurrently.
+        wait();
+        std::shared_ptr<Snapshot> snapshot(new Snapshot(takeSnapshot(timer, reservoirState, wellState)));
+        if (!asynchronous_) {
+            writeSnapshot(filename_, *snapshot, compress_);
+            return;
+        }
+        const std::string filename = filename_;
+        const bool compress = compress_;
+        Impl* impl = pimpl_.get();
+        pimpl_->worker = std::thread([impl, snapshot, filename, compress]() {
+                try {
+                    writeSnapshot(filename, *snapshot, compress);
+                }
+                catch (...) {
+                    impl->error = std::current_exception();
+                }
+            });
+    }
+
+
+
+    void CheckpointWriter::wait()
+    {
+        if (pimpl_->worker.joinable()) {
+            pimpl_->worker.join();
+        }
+        if (pimpl_->error) {
+            std::exception_ptr error = pimpl_->error;
+            pimpl_->error = std::exception_ptr();
+            std::rethrow_exception(error);
+        }
+    }
+
+} // namespace Opm
@@ -0,0 +1,129 @@
+/*
+  Copyright 2015 SINTEF ICT, Applied Mathematics.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OPM_CHECKPOINT_HEADER_INCLUDED
+#define OPM_CHECKPOINT_HEADER_INCLUDED
+
+#include <opm/core/io/OutputWriter.hpp>
+
+#include <memory>
+#include <string>
+
+struct UnstructuredGrid;
+
+namespace Opm
+{
+
+    class EclipseState;
+    class SimulatorState;
+    class WellState;
+    struct PhaseUsage;
+    namespace parameter { class ParameterGroup; }
+
+    /// Timer position stored in a checkpoint.
+    struct CheckpointTime
+    {
+        int    stepNum;     //!< SimulatorTimerInterface::currentStepNum()
+        double elapsed;     //!< SimulatorTimerInterface::simulationTimeElapsed()
+        double stepLength;  //!< SimulatorTimerInterface::currentStepLength()
+    };
+
+    /// Write all cell and face fields of a SimulatorState, the vectors of a
+    /// WellState and the timer position to a native binary file. Values are
+    /// stored exactly, in double precision. If compress is true the arrays
+    /// are encoded with a fast lossless scheme (each value is xor'ed with
+    /// its predecessor and leading zero bytes are dropped), which is
+    /// effective for smooth or constant fields.
+    ///
+    /// The file is first written under a temporary name and then renamed,
+    /// so a crash while writing never destroys an existing checkpoint.
+    void writeCheckpoint(const std::string& filename,
+                         const SimulatorTimerInterface& timer,
+                         const SimulatorState& state,
+                         const WellState& wellState,
+                         const bool compress = false);
+
+    /// Read a checkpoint written by writeCheckpoint() or CheckpointWriter.
+    /// The file is memory mapped where supported. The state must already be
+    /// initialised with the same number of cells, faces and phases and the
+    /// same registered fields as the one written; the well vectors are
+    /// resized to the stored sizes, the well map is left untouched.
+    /// \return the timer position at which the checkpoint was written,
+    ///         e.g. for SimulatorTimer::setCurrentStepNum().
+    CheckpointTime readCheckpoint(const std::string& filename,
+                                  SimulatorState& state,
+                                  WellState& wellState);
+
+    /// Output writer producing checkpoints for crash recovery.
+    ///
+    /// Every interval'th report step the state is copied and written by
+    /// writeCheckpoint() to a single file, which is replaced each time. With
+    /// asynchronous output the file is written by a background thread while
+    /// the simulation continues; only the copy is done synchronously.
+    class CheckpointWriter : public OutputWriter
+    {
+    public:
+        /// Construct from parameters:
+        ///   checkpoint_file     (output_dir/checkpoint.ockp)
+        ///   checkpoint_interval (1)
+        ///   checkpoint_compress (false)
+        ///   checkpoint_async    (true)
+        /// The remaining arguments match the other writers and are unused.
+        CheckpointWriter(const parameter::ParameterGroup& params,
+                         std::shared_ptr<const EclipseState> eclipseState,
+                         const PhaseUsage& phaseUsage,
+                         int numCells,
+                         const int* compressedToCartesianCellIdx);
+
+        CheckpointWriter(const std::string& filename,
+                         const int interval,
+                         const bool compress,
+                         const bool asynchronous);
+
+        /// Waits for a pending asynchronous write.
+        virtual ~CheckpointWriter();
+
+        /// Nothing to do, checkpoints contain no static data.
+        virtual void writeInit(const SimulatorTimerInterface& timer);
+
+        /// Write a checkpoint if this is a report step matching the interval.
+        virtual void writeTimeStep(const SimulatorTimerInterface& timer,
+                                   const SimulatorState& reservoirState,
+                                   const WellState& wellState,
+                                   bool  isSubstep);
+
+        /// Block until a pending asynchronous write has finished. Errors
+        /// raised by the background write are rethrown here.
+        void wait();
+
+        /// The file checkpoints are written to.
+        const std::string& filename() const { return filename_; }
+
+    private:
+        struct Impl;
+        std::shared_ptr<Impl> pimpl_;
+        std::string filename_;
+        int interval_;
+        bool compress_;
+        bool asynchronous_;
+    };
+
+} // namespace Opm
+
+#endif // OPM_CHECKPOINT_HEADER_INCLUDED
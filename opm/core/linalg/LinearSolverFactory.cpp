@@ -35,6 +35,7 @@
 #include <opm/core/linalg/LinearSolverPetsc.hpp>
 #endif
 
+#include <opm/core/linalg/LinearSystemCapture.hpp>
 #include <opm/core/utility/parameters/ParameterGroup.hpp>
 #include <opm/common/ErrorMacros.hpp>
 #include <string>
@@ -89,6 +90,14 @@ namespace Opm
             OPM_THROW(std::runtime_error, "Linear solver " << ls << " is not enabled in "
                   "this configuration.");
         }
+
+        const std::string capture_prefix =
+            param.getDefault<std::string>("linsolver_capture_prefix", "");
+        if (!capture_prefix.empty()) {
+            backend_ = solver_;
+            solver_.reset(new LinearSolverCapture(*backend_, capture_prefix,
+                                                  param.getDefault("linsolver_capture_max", -1)));
+        }
     }
 
 
@@ -114,6 +123,20 @@ namespace Opm
         return solver_->solve(size, nonzeros, ia, ja, sa, rhs, solution, add);
     }
 
+    LinearSolverInterface::LinearSolverReport
+    LinearSolverFactory::solveMultiple(const int size,
+                                       const int nonzeros,
+                                       const int* ia,
+                                       const int* ja,
+                                       const double* sa,
+                                       const int num_rhs,
+                                       const double* rhs,
+                                       double* solution,
+                                       const boost::any& add) const
+    {
+        return solver_->solveMultiple(size, nonzeros, ia, ja, sa, num_rhs, rhs, solution, add);
+    }
+
     void LinearSolverFactory::setTolerance(const double tol)
     {
         solver_->setTolerance(tol);
@@ -55,6 +55,11 @@ namespace Opm
         /// Any further parameters are passed on to the constructors
         /// of the actual solver used, see LinearSolverUmfpack,
         /// LinearSolverIstl and LinearSolverPetsc for details.
+        /// The systems solved are written to files for replay if
+        ///    linsolver_capture_prefix  (<empty string>)
+        /// is given, see LinearSolverCapture, at most
+        ///    linsolver_capture_max     (-1, no limit)
+        /// of them.
         LinearSolverFactory(const parameter::ParameterGroup& param);
 
         /// Destructor.
@@ -80,6 +85,29 @@ namespace Opm
                                          double* solution,
                                          const boost::any& add=boost::any()) const;
 
+        using LinearSolverInterface::solveMultiple;
+
+        /// Solve a linear system for several right hand sides, with a matrix given
+        /// in compressed sparse row format.
+        /// Forwarded to the actual solver.
+        /// \param[in] size        # of rows in matrix
+        /// \param[in] nonzeros    # of nonzeros elements in matrix
+        /// \param[in] ia          array of length (size + 1) containing start and end indices for each row
+        /// \param[in] ja          array of length nonzeros containing column numbers for the nonzero elements
+        /// \param[in] sa          array of length nonzeros containing the values of the nonzero elements
+        /// \param[in] num_rhs     # of right hand sides
+        /// \param[in] rhs         array of length num_rhs*size, right hand side k starts at rhs + k*size
+        /// \param[out] solution   array of length num_rhs*size, laid out like rhs
+        virtual LinearSolverReport solveMultiple(const int size,
+                                                 const int nonzeros,
+                                                 const int* ia,
+                                                 const int* ja,
+                                                 const double* sa,
+                                                 const int num_rhs,
+                                                 const double* rhs,
+                                                 double* solution,
+                                                 const boost::any& add=boost::any()) const;
+
         /// Set tolerance for the linear solver.
         /// \param[in] tol         tolerance value
         /// Not used for LinearSolverFactory
@@ -92,6 +120,8 @@ namespace Opm
 
     private:
         std::shared_ptr<LinearSolverInterface> solver_;
+        // The actual solver if solver_ is a capture wrapper around it.
+        std::shared_ptr<LinearSolverInterface> backend_;
     };
 
 
@@ -22,6 +22,7 @@
 #include <opm/core/linalg/LinearSolverInterface.hpp>
 #include <opm/core/linalg/sparse_sys.h>
 #include <opm/core/linalg/call_umfpack.h>
+#include <algorithm>
 
 namespace Opm
 {
@@ -36,9 +37,49 @@ namespace Opm
     LinearSolverInterface::LinearSolverReport
     LinearSolverInterface::solve(const CSRMatrix* A,
                                  const double* rhs,
-                                 double* solution) const
+                                 double* solution,
+                                 const boost::any& comm) const
     {
-        return solve(A->m, A->nnz, A->ia, A->ja, A->sa, rhs, solution);
+        return solve(A->m, A->nnz, A->ia, A->ja, A->sa, rhs, solution, comm);
+    }
+
+
+
+
+    LinearSolverInterface::LinearSolverReport
+    LinearSolverInterface::solveMultiple(const CSRMatrix* A,
+                                         const int num_rhs,
+                                         const double* rhs,
+                                         double* solution,
+                                         const boost::any& comm) const
+    {
+        return solveMultiple(A->m, A->nnz, A->ia, A->ja, A->sa, num_rhs, rhs, solution, comm);
+    }
+
+
+
+
+    LinearSolverInterface::LinearSolverReport
+    LinearSolverInterface::solveMultiple(const int size,
+                                         const int nonzeros,
+                                         const int* ia,
+                                         const int* ja,
+                                         const double* sa,
+                                         const int num_rhs,
+                                         const double* rhs,
+                                         double* solution,
+                                         const boost::any& add) const
+    {
+        LinearSolverReport rep = {};
+        rep.converged = true;
+        for (int k = 0; k < num_rhs; ++k) {
+            const LinearSolverReport rep_k = solve(size, nonzeros, ia, ja, sa,
+                                                   rhs + k*size, solution + k*size, add);
+            rep.converged = rep.converged && rep_k.converged;
+            rep.iterations += rep_k.iterations;
+            rep.residual_reduction = std::max(rep.residual_reduction, rep_k.residual_reduction);
+        }
+        return rep;
     }
 
 } // namespace Opm
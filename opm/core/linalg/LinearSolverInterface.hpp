@@ -50,10 +50,12 @@ namespace Opm
         /// \param[in] rhs         array of length A->m containing the right hand side
         /// \param[inout] solution array of length A->m to which the solution will be written, may also be used
         ///                        as initial guess by iterative solvers.
+        /// \param[in] comm        parallel information passed on to the virtual solve() method.
         /// Note: this method is a convenience method that calls the virtual solve() method.
         LinearSolverReport solve(const CSRMatrix* A,
                                  const double* rhs,
-                                 double* solution) const;
+                                 double* solution,
+                                 const boost::any& comm = boost::any()) const;
 
         /// Solve a linear system, with a matrix given in compressed sparse row format.
         /// \param[in] size        # of rows in matrix
@@ -73,6 +75,45 @@ namespace Opm
                                          double* solution,
                                          const boost::any& add=boost::any()) const = 0;
 
+        /// Solve a linear system for several right hand sides, with a matrix given
+        /// in compressed sparse row format.
+        /// \param[in] A           matrix in CSR format
+        /// \param[in] num_rhs     # of right hand sides
+        /// \param[in] rhs         array of length num_rhs*A->m, right hand side k starts at rhs + k*A->m
+        /// \param[out] solution   array of length num_rhs*A->m, laid out like rhs
+        /// \param[in] comm        parallel information passed on to the virtual solveMultiple() method.
+        /// Note: this method is a convenience method that calls the virtual solveMultiple() method.
+        LinearSolverReport solveMultiple(const CSRMatrix* A,
+                                         const int num_rhs,
+                                         const double* rhs,
+                                         double* solution,
+                                         const boost::any& comm = boost::any()) const;
+
+        /// Solve a linear system for several right hand sides, with a matrix given
+        /// in compressed sparse row format.
+        /// The default implementation calls solve() once for each right hand
+        /// side. Solvers override it to share the factorisation or
+        /// preconditioner between the right hand sides.
+        /// \param[in] size        # of rows in matrix
+        /// \param[in] nonzeros    # of nonzeros elements in matrix
+        /// \param[in] ia          array of length (size + 1) containing start and end indices for each row
+        /// \param[in] ja          array of length nonzeros containing column numbers for the nonzero elements
+        /// \param[in] sa          array of length nonzeros containing the values of the nonzero elements
+        /// \param[in] num_rhs     # of right hand sides
+        /// \param[in] rhs         array of length num_rhs*size, right hand side k starts at rhs + k*size
+        /// \param[out] solution   array of length num_rhs*size, laid out like rhs
+        /// \return Report with the total number of iterations, the largest
+        ///         residual reduction, and converged set if all systems converged.
+        virtual LinearSolverReport solveMultiple(const int size,
+                                                 const int nonzeros,
+                                                 const int* ia,
+                                                 const int* ja,
+                                                 const double* sa,
+                                                 const int num_rhs,
+                                                 const double* rhs,
+                                                 double* solution,
+                                                 const boost::any& add=boost::any()) const;
+
         /// Set tolerance for the linear solver.
         /// \param[in] tol         tolerance value
         virtual void setTolerance(const double tol) = 0;
@@ -171,6 +171,20 @@ namespace Opm
             const ParallelISTLInformation& info = boost::any_cast<const ParallelISTLInformation&>(comm);
             Comm istlComm(info.communicator());
             info.copyValuesTo(istlComm.indexSet(), istlComm.remoteIndices());
+            // Rows we do not own are recomputed by their owners, but
+            // must be nonsingular for the preconditioners. Replace
+            // them by identity rows. A single process owns all rows,
+            // so its matrix is left as it is.
+            if (istlComm.communicator().size() > 1) {
+                for (auto i = info.indexSet()->begin(), end = info.indexSet()->end(); i != end; ++i) {
+                    if (i->local().attribute() != Dune::OwnerOverlapCopyAttributeSet::owner) {
+                        const int row = i->local().local();
+                        for (auto col = A[row].begin(), cend = A[row].end(); col != cend; ++col) {
+                            *col = (int(col.index()) == row) ? 1.0 : 0.0;
+                        }
+                    }
+                }
+            }
             Dune::OverlappingSchwarzOperator<Mat,Vector,Vector, Comm>
                 opA(A, istlComm);
             Dune::OverlappingSchwarzScalarProduct<Vector,Comm> sp(istlComm);
@@ -256,6 +270,8 @@ namespace Opm
             std::cerr << "Unknown linsolver_type: " << int(linsolver_type_) << '\n';
             throw std::runtime_error("Unknown linsolver_type");
         }
+        // Make the solution consistent in the parallel case.
+        comm.copyOwnerToAll(x, x);
         std::copy(x.begin(), x.end(), solution);
         return res;
     }
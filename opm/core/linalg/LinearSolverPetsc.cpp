@@ -19,9 +19,11 @@
 */
 
 #include "config.h"
+#include <algorithm>
 #include <cstring>
 #include <opm/core/linalg/LinearSolverPetsc.hpp>
 #include <unordered_map>
+#include <vector>
 #define PETSC_CLANGUAGE_CXX 1 //enable CHKERRXX macro.
 #include <petsc.h>
 #include <opm/common/ErrorMacros.hpp>
@@ -222,6 +224,104 @@ namespace{
 
 } // anonymous namespace.
 
+    /// Matrix, vectors and solver objects kept between calls to solve().
+    /// PETSc's matrix refers to the CSR arrays stored here, so
+    /// updating the values only requires a copy into sa.
+    struct LinearSolverPetsc::PersistentSystem
+    {
+        std::vector<int> ia;
+        std::vector<int> ja;
+        std::vector<double> sa;
+        Vec x;
+        Vec b;
+        Mat A;
+        KSP ksp;
+        int solves_since_pc_setup;
+
+        PersistentSystem(const int size, const int nonzeros,
+                         const int* ia_in, const int* ja_in, const double* sa_in,
+                         KSPType method, PCType pcname,
+                         double rtol, double atol, double dtol, int maxits)
+            : ia(ia_in, ia_in + size + 1),
+              ja(ja_in, ja_in + nonzeros),
+              sa(sa_in, sa_in + nonzeros),
+              solves_since_pc_setup(0)
+        {
+            A = to_petsc_mat(size, nonzeros, ia.data(), ja.data(), sa.data());
+            auto err = MatSetOption(A, MAT_NEW_NONZERO_LOCATIONS, PETSC_FALSE);
+            CHKERRXX(err);
+            VecCreate(PETSC_COMM_WORLD, &x);
+            VecSetSizes(x, PETSC_DECIDE, size);
+            VecSetFromOptions(x);
+            VecDuplicate(x, &b);
+
+            KSPCreate(PETSC_COMM_WORLD, &ksp);
+            KSPSetOperators(ksp, A, A, DIFFERENT_NONZERO_PATTERN);
+            PC preconditioner;
+            KSPGetPC(ksp, &preconditioner);
+            err = KSPSetType(ksp, method);
+            CHKERRXX(err);
+            err = PCSetType(preconditioner, pcname);
+            CHKERRXX(err);
+            err = KSPSetTolerances(ksp, rtol, atol, dtol, maxits);
+            CHKERRXX(err);
+            err = KSPSetFromOptions(ksp);
+            CHKERRXX(err);
+            KSPSetInitialGuessNonzero(ksp, PETSC_FALSE);
+        }
+
+        ~PersistentSystem()
+        {
+            KSPDestroy(&ksp);
+            MatDestroy(&A);
+            VecDestroy(&x);
+            VecDestroy(&b);
+        }
+
+        bool samePattern(const int size, const int nonzeros,
+                         const int* ia_in, const int* ja_in) const
+        {
+            return int(ia.size()) == size + 1 && int(ja.size()) == nonzeros
+                && std::equal(ia.begin(), ia.end(), ia_in)
+                && std::equal(ja.begin(), ja.end(), ja_in);
+        }
+
+        /// Copy new values into the matrix. The preconditioner is
+        /// rebuilt unless it has been reused less than pc_reuse times.
+        void update(const double* sa_in, const int pc_reuse)
+        {
+            std::copy(sa_in, sa_in + sa.size(), sa.begin());
+            MatAssemblyBegin(A, MAT_FINAL_ASSEMBLY);
+            MatAssemblyEnd(A, MAT_FINAL_ASSEMBLY);
+            if (solves_since_pc_setup < pc_reuse) {
+                KSPSetOperators(ksp, A, A, SAME_PRECONDITIONER);
+                ++solves_since_pc_setup;
+            } else {
+                KSPSetOperators(ksp, A, A, SAME_NONZERO_PATTERN);
+                solves_since_pc_setup = 0;
+            }
+        }
+
+        void solve(const double* rhs, double* solution, const int ksp_view)
+        {
+            PetscScalar* vec;
+            VecGetArray(x, &vec);
+            std::memcpy(vec, rhs, (ia.size() - 1) * sizeof(double));
+            VecRestoreArray(x, &vec);
+
+            PetscInt its;
+            PetscReal residual;
+            KSPSolve(ksp, x, b);
+            KSPGetIterationNumber(ksp, &its);
+            KSPGetResidualNorm(ksp, &residual);
+            if (ksp_view)
+                KSPView(ksp, PETSC_VIEWER_STDOUT_WORLD);
+            auto err = PetscPrintf(PETSC_COMM_WORLD, "KSP Iterations %D, Final Residual %G\n", its, residual);
+            CHKERRXX(err);
+            from_petsc_vec(solution, b);
+        }
+    };
+
     LinearSolverPetsc::LinearSolverPetsc(const parameter::ParameterGroup& param)
         : ksp_type_( param.getDefault( std::string( "ksp_type" ), std::string( "gmres" ) ) )
         , pc_type_( param.getDefault( std::string( "pc_type" ), std::string( "sor" ) ) )
@@ -230,6 +330,8 @@ namespace{
         , atol_( param.getDefault( std::string( "ksp_atol" ), 1e-50 ) )
         , dtol_( param.getDefault( std::string( "ksp_dtol" ), 1e5 ) )
         , maxits_( param.getDefault( std::string( "ksp_max_it" ), 1e5 ) )
+        , ksp_reuse_( param.getDefault( std::string( "ksp_reuse" ), false ) )
+        , pc_reuse_( param.getDefault( std::string( "pc_reuse" ), 0 ) )
     {
         int argc = 0;
         char** argv = NULL;
@@ -239,6 +341,8 @@ namespace{
 
     LinearSolverPetsc::~LinearSolverPetsc()
     {
+       // The persistent PETSc objects must be destroyed before finalizing.
+       system_.reset();
        PetscFinalize();
     }
 
@@ -258,6 +362,20 @@ namespace{
         PCTypeMap pc(pc_type_);
         PCType pc_type = pc.find(pc_type_);
 
+        if (ksp_reuse_) {
+            if (system_ && system_->samePattern(size, nonzeros, ia, ja)) {
+                system_->update(sa, pc_reuse_);
+            } else {
+                system_.reset();
+                system_.reset(new PersistentSystem(size, nonzeros, ia, ja, sa, ksp_type, pc_type,
+                                                   rtol_, atol_, dtol_, maxits_));
+            }
+            system_->solve(rhs, solution, ksp_view_);
+            LinearSolverReport rep = {};
+            rep.converged = true;
+            return rep;
+        }
+
         OEM_DATA t( size );
         t.A = to_petsc_mat( size, nonzeros, ia, ja, sa );
         t.x = to_petsc_vec( rhs, size );
@@ -22,6 +22,7 @@
 #define OPM_LINEARSOLVERPETSC_HEADER_INCLUDED
 #include <opm/core/linalg/LinearSolverInterface.hpp>
 #include <opm/core/utility/parameters/ParameterGroup.hpp>
+#include <memory>
 #include <string>
 
 namespace Opm
@@ -42,6 +43,11 @@ namespace Opm
         /// Construct from parameters
         /// Accepted parameters are, with defaults, listed in the
         /// default constructor.
+        /// If ksp_reuse (default false) is true, the matrix, Krylov
+        /// solver and preconditioner are kept between calls to solve().
+        /// As long as the sparsity pattern is unchanged only the matrix
+        /// values are updated. The preconditioner is then rebuilt every
+        /// (pc_reuse + 1)'th solve (pc_reuse default 0).
         LinearSolverPetsc(const parameter::ParameterGroup& param);
 
         /// Destructor.
@@ -82,6 +88,11 @@ namespace Opm
         double          atol_;
         double          dtol_;
         int             maxits_;
+        bool            ksp_reuse_;
+        int             pc_reuse_;
+        struct PersistentSystem;
+        // Using shared_ptr instead of unique_ptr since unique_ptr requires complete type.
+        mutable std::shared_ptr<PersistentSystem> system_;
     };
 
 
@@ -0,0 +1,222 @@
+/*
+  Copyright 2015 SINTEF ICT, Applied Mathematics.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "config.h"
+#include <opm/core/linalg/LinearSolverRecycling.hpp>
+#include <opm/common/ErrorMacros.hpp>
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+namespace Opm
+{
+
+namespace
+{
+
+    double dot(const std::vector<double>& a, const double* b)
+    {
+        return std::inner_product(a.begin(), a.end(), b, 0.0);
+    }
+
+    void multiply(const int size, const int* ia, const int* ja, const double* sa,
+                  const std::vector<double>& x, std::vector<double>& y)
+    {
+        y.resize(size);
+        for (int row = 0; row < size; ++row) {
+            double sum = 0.0;
+            for (int k = ia[row]; k < ia[row + 1]; ++k) {
+                sum += sa[k] * x[ja[k]];
+            }
+            y[row] = sum;
+        }
+    }
+
+} // anonymous namespace
+
+
+
+
+    LinearSolverRecycling::LinearSolverRecycling(LinearSolverInterface& inner,
+                                                 const int subspace_size)
+        : inner_(inner),
+          subspace_size_(subspace_size),
+          num_solves_(0),
+          num_skipped_(0),
+          total_iterations_(0)
+    {
+        if (subspace_size < 0) {
+            OPM_THROW(std::runtime_error, "LinearSolverRecycling: negative subspace size " << subspace_size);
+        }
+    }
+
+
+
+
+    LinearSolverRecycling::~LinearSolverRecycling()
+    {
+    }
+
+
+
+
+    LinearSolverInterface::LinearSolverReport
+    LinearSolverRecycling::solve(const int size,
+                                 const int nonzeros,
+                                 const int* ia,
+                                 const int* ja,
+                                 const double* sa,
+                                 const double* rhs,
+                                 double* solution,
+                                 const boost::any& add) const
+    {
+        ++num_solves_;
+        if (subspace_size_ == 0 || !add.empty()) {
+            LinearSolverReport rep = inner_.solve(size, nonzeros, ia, ja, sa, rhs, solution, add);
+            total_iterations_ += rep.iterations;
+            return rep;
+        }
+        if (!solutions_.empty() && int(solutions_.front().size()) != size) {
+            solutions_.clear();
+        }
+
+        // Orthonormalize the images A*w of the recycled solutions w,
+        // applying the same operations to w so that A*w = q still holds.
+        const int m = solutions_.size();
+        std::vector<std::vector<double> > w(solutions_.begin(), solutions_.end());
+        std::vector<std::vector<double> > q(m);
+        int kept = 0;
+        for (int k = 0; k < m; ++k) {
+            multiply(size, ia, ja, sa, w[k], q[k]);
+            const double orig_norm = std::sqrt(dot(q[k], q[k].data()));
+            for (int j = 0; j < kept; ++j) {
+                const double h = dot(q[j], q[k].data());
+                for (int i = 0; i < size; ++i) {
+                    q[k][i] -= h * q[j][i];
+                    w[k][i] -= h * w[j][i];
+                }
+            }
+            const double norm = std::sqrt(dot(q[k], q[k].data()));
+            if (norm <= 1e-10 * orig_norm || norm == 0.0) {
+                continue;
+            }
+            for (int i = 0; i < size; ++i) {
+                q[k][i] /= norm;
+                w[k][i] /= norm;
+            }
+            if (k != kept) {
+                q[kept].swap(q[k]);
+                w[kept].swap(w[k]);
+            }
+            ++kept;
+        }
+
+        // Minimal residual initial guess x0 = W c, with c = Q^T b.
+        std::vector<double> x0(size, 0.0);
+        std::vector<double> residual(rhs, rhs + size);
+        for (int j = 0; j < kept; ++j) {
+            const double c = dot(q[j], rhs);
+            for (int i = 0; i < size; ++i) {
+                x0[i] += c * w[j][i];
+                residual[i] -= c * q[j][i];
+            }
+        }
+        const double rhs_norm = std::sqrt(std::inner_product(rhs, rhs + size, rhs, 0.0));
+        const double res_norm = std::sqrt(dot(residual, residual.data()));
+
+        const double tol = inner_.getTolerance();
+        LinearSolverReport rep = {};
+        if (kept > 0 && tol > 0.0 && res_norm <= tol * rhs_norm) {
+            // The recycled subspace already gives a converged solution.
+            rep.converged = true;
+            rep.iterations = 0;
+            rep.residual_reduction = rhs_norm > 0.0 ? res_norm / rhs_norm : 0.0;
+            std::copy(x0.begin(), x0.end(), solution);
+            ++num_skipped_;
+        } else {
+            // Solve for the correction, relaxing the tolerance so that
+            // the final residual is reduced by tol relative to rhs.
+            const bool relax = kept > 0 && tol > 0.0 && res_norm > 0.0;
+            if (relax) {
+                inner_.setTolerance(std::min(tol * rhs_norm / res_norm, 0.5));
+            }
+            std::vector<double> correction(size, 0.0);
+            try {
+                rep = inner_.solve(size, nonzeros, ia, ja, sa, residual.data(), correction.data(), add);
+            } catch (...) {
+                if (relax) {
+                    inner_.setTolerance(tol);
+                }
+                throw;
+            }
+            if (relax) {
+                inner_.setTolerance(tol);
+            }
+            if (rhs_norm > 0.0) {
+                rep.residual_reduction *= res_norm / rhs_norm;
+            }
+            for (int i = 0; i < size; ++i) {
+                solution[i] = x0[i] + correction[i];
+            }
+            total_iterations_ += rep.iterations;
+        }
+
+        if (int(solutions_.size()) == subspace_size_) {
+            solutions_.pop_front();
+        }
+        solutions_.push_back(std::vector<double>(solution, solution + size));
+        return rep;
+    }
+
+
+
+
+    void LinearSolverRecycling::setTolerance(const double tol)
+    {
+        inner_.setTolerance(tol);
+    }
+
+    double LinearSolverRecycling::getTolerance() const
+    {
+        return inner_.getTolerance();
+    }
+
+    void LinearSolverRecycling::clear()
+    {
+        solutions_.clear();
+    }
+
+    int LinearSolverRecycling::numSolves() const
+    {
+        return num_solves_;
+    }
+
+    int LinearSolverRecycling::numSkippedSolves() const
+    {
+        return num_skipped_;
+    }
+
+    int LinearSolverRecycling::totalIterations() const
+    {
+        return total_iterations_;
+    }
+
+
+
+} // namespace Opm
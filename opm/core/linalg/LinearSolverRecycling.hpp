@@ -0,0 +1,111 @@
+/*
+  Copyright 2015 SINTEF ICT, Applied Mathematics.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OPM_LINEARSOLVERRECYCLING_HEADER_INCLUDED
+#define OPM_LINEARSOLVERRECYCLING_HEADER_INCLUDED
+
+#include <opm/core/linalg/LinearSolverInterface.hpp>
+#include <deque>
+#include <vector>
+
+namespace Opm
+{
+
+
+    /// Linear solver wrapper for sequences of closely related systems,
+    /// such as the pressure systems of a sequential simulator.
+    ///
+    /// The solutions of the last few systems span a subspace that is
+    /// recycled when the next system is solved: the initial guess is
+    /// the minimal residual combination of these solutions under the
+    /// current matrix. This contains constant and linear extrapolation
+    /// in time as special cases. The wrapped solver then only has to
+    /// solve for the correction, with its tolerance relaxed so that the
+    /// final residual reduction relative to the right hand side is the
+    /// same as without recycling.
+    ///
+    /// Systems with parallel information are passed on unchanged, as are
+    /// all systems if the subspace size is zero. Iteration statistics
+    /// are gathered in either case.
+    class LinearSolverRecycling : public LinearSolverInterface
+    {
+    public:
+        /// Construct wrapper.
+        /// \param[in] inner          solver used for the corrections, must
+        ///                           outlive this object.
+        /// \param[in] subspace_size  number of previous solutions kept.
+        LinearSolverRecycling(LinearSolverInterface& inner,
+                              const int subspace_size = 4);
+
+        /// Destructor.
+        virtual ~LinearSolverRecycling();
+
+        using LinearSolverInterface::solve;
+
+        /// Solve a linear system, with a matrix given in compressed sparse row format.
+        /// \param[in] size        # of rows in matrix
+        /// \param[in] nonzeros    # of nonzeros elements in matrix
+        /// \param[in] ia          array of length (size + 1) containing start and end indices for each row
+        /// \param[in] ja          array of length nonzeros containing column numbers for the nonzero elements
+        /// \param[in] sa          array of length nonzeros containing the values of the nonzero elements
+        /// \param[in] rhs         array of length size containing the right hand side
+        /// \param[inout] solution array of length size to which the solution will be written.
+        virtual LinearSolverReport solve(const int size,
+                                         const int nonzeros,
+                                         const int* ia,
+                                         const int* ja,
+                                         const double* sa,
+                                         const double* rhs,
+                                         double* solution,
+                                         const boost::any& add=boost::any()) const;
+
+        /// Set tolerance of the wrapped solver.
+        /// \param[in] tol         tolerance value
+        virtual void setTolerance(const double tol);
+
+        /// Get tolerance of the wrapped solver.
+        /// \param[out] tolerance value
+        virtual double getTolerance() const;
+
+        /// Forget the recycled solutions.
+        void clear();
+
+        /// Number of systems solved.
+        int numSolves() const;
+
+        /// Number of systems for which the recycled initial guess was
+        /// accurate enough that the wrapped solver was not called.
+        int numSkippedSolves() const;
+
+        /// Sum of the iterations reported by the wrapped solver.
+        int totalIterations() const;
+
+    private:
+        LinearSolverInterface& inner_;
+        int subspace_size_;
+        mutable std::deque<std::vector<double> > solutions_;
+        mutable int num_solves_;
+        mutable int num_skipped_;
+        mutable int total_iterations_;
+    };
+
+
+} // namespace Opm
+
+#endif // OPM_LINEARSOLVERRECYCLING_HEADER_INCLUDED
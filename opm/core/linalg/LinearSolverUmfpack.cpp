@@ -62,6 +62,30 @@ namespace Opm
         return rep;
     }
 
+    LinearSolverInterface::LinearSolverReport
+    LinearSolverUmfpack::solveMultiple(const int size,
+                                       const int nonzeros,
+                                       const int* ia,
+                                       const int* ja,
+                                       const double* sa,
+                                       const int num_rhs,
+                                       const double* rhs,
+                                       double* solution,
+                                       const boost::any&) const
+    {
+        CSRMatrix A  = {
+            (size_t)size,
+            (size_t)nonzeros,
+            const_cast<int*>(ia),
+            const_cast<int*>(ja),
+            const_cast<double*>(sa)
+        };
+        call_UMFPACK_multiple(&A, num_rhs, rhs, solution);
+        LinearSolverReport rep = {};
+        rep.converged = true;
+        return rep;
+    }
+
     void LinearSolverUmfpack::setTolerance(const double /*tol*/)
     {
     }
@@ -58,6 +58,29 @@ namespace Opm
                                          double* solution,
                                          const boost::any& add=boost::any()) const;
 
+        using LinearSolverInterface::solveMultiple;
+
+        /// Solve a linear system for several right hand sides, with a matrix given
+        /// in compressed sparse row format.
+        /// The matrix is factorised once and the factors are used for all right hand sides.
+        /// \param[in] size        # of rows in matrix
+        /// \param[in] nonzeros    # of nonzeros elements in matrix
+        /// \param[in] ia          array of length (size + 1) containing start and end indices for each row
+        /// \param[in] ja          array of length nonzeros containing column numbers for the nonzero elements
+        /// \param[in] sa          array of length nonzeros containing the values of the nonzero elements
+        /// \param[in] num_rhs     # of right hand sides
+        /// \param[in] rhs         array of length num_rhs*size, right hand side k starts at rhs + k*size
+        /// \param[out] solution   array of length num_rhs*size, laid out like rhs
+        virtual LinearSolverReport solveMultiple(const int size,
+                                                 const int nonzeros,
+                                                 const int* ia,
+                                                 const int* ja,
+                                                 const double* sa,
+                                                 const int num_rhs,
+                                                 const double* rhs,
+                                                 double* solution,
+                                                 const boost::any& add=boost::any()) const;
+
         /// Set tolerance for the linear solver.
         /// \param[in] tol         tolerance value
         /// Not used for UMFPACK solver.
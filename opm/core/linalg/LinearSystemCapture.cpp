@@ -0,0 +1,267 @@
+/*
+  Copyright 2015 SINTEF ICT, Applied Mathematics.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "config.h"
+#include <opm/core/linalg/LinearSystemCapture.hpp>
+#include <opm/common/ErrorMacros.hpp>
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+namespace Opm
+{
+
+namespace
+{
+
+    const char magic[8] = { 'O', 'P', 'M', 'L', 'S', 'Y', 'S', '\0' };
+    const std::uint32_t version = 1;
+    const std::uint32_t byteOrderMark = 0x01020304;
+
+    template <class T>
+    void put(std::ofstream& file, const T& value)
+    {
+        file.write(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    template <class T>
+    void putArray(std::ofstream& file, const std::vector<T>& v)
+    {
+        if (!v.empty()) {
+            file.write(reinterpret_cast<const char*>(&v[0]), v.size()*sizeof(T));
+        }
+    }
+
+    template <class T>
+    T get(std::ifstream& file, const std::string& filename)
+    {
+        T value;
+        if (!file.read(reinterpret_cast<char*>(&value), sizeof(T))) {
+            OPM_THROW(std::runtime_error, "Linear system file " << filename << " is truncated.");
+        }
+        return value;
+    }
+
+    template <class T>
+    void getArray(std::ifstream& file, const std::size_t n,
+                  std::vector<T>& v, const std::string& filename)
+    {
+        v.resize(n);
+        if (n > 0 && !file.read(reinterpret_cast<char*>(&v[0]), n*sizeof(T))) {
+            OPM_THROW(std::runtime_error, "Linear system file " << filename << " is truncated.");
+        }
+    }
+
+} // anonymous namespace
+
+
+
+
+    void writeLinearSystem(const std::string& filename,
+                           const CapturedLinearSystem& system)
+    {
+        const int size = system.size();
+        if (int(system.ia.size()) != size + 1 || int(system.ja.size()) != system.nonzeros()
+            || int(system.initial_guess.size()) != size) {
+            OPM_THROW(std::runtime_error, "Inconsistent linear system for " << filename << '.');
+        }
+        std::ofstream file(filename.c_str(), std::ios::binary);
+        if (!file) {
+            OPM_THROW(std::runtime_error, "Could not open linear system file " << filename << " for writing.");
+        }
+        file.write(magic, sizeof(magic));
+        put(file, version);
+        put(file, byteOrderMark);
+        put(file, std::int32_t(size));
+        put(file, std::int32_t(system.nonzeros()));
+        put(file, system.tolerance);
+        putArray(file, system.ia);
+        putArray(file, system.ja);
+        putArray(file, system.sa);
+        putArray(file, system.rhs);
+        putArray(file, system.initial_guess);
+        if (!file) {
+            OPM_THROW(std::runtime_error, "Failed writing linear system file " << filename << '.');
+        }
+    }
+
+
+
+
+    CapturedLinearSystem readLinearSystem(const std::string& filename)
+    {
+        std::ifstream file(filename.c_str(), std::ios::binary);
+        if (!file) {
+            OPM_THROW(std::runtime_error, "Could not open linear system file " << filename << '.');
+        }
+        char fileMagic[sizeof(magic)];
+        if (!file.read(fileMagic, sizeof(fileMagic))
+            || std::memcmp(fileMagic, magic, sizeof(magic)) != 0) {
+            OPM_THROW(std::runtime_error, filename << " is not a linear system file.");
+        }
+        const std::uint32_t fileVersion = get<std::uint32_t>(file, filename);
+        const std::uint32_t fileByteOrder = get<std::uint32_t>(file, filename);
+        if (fileVersion != version || fileByteOrder != byteOrderMark) {
+            OPM_THROW(std::runtime_error, "Linear system file " << filename
+                      << " was written by an incompatible version or platform.");
+        }
+        const int size = get<std::int32_t>(file, filename);
+        const int nonzeros = get<std::int32_t>(file, filename);
+        if (size < 0 || nonzeros < 0) {
+            OPM_THROW(std::runtime_error, "Linear system file " << filename << " is corrupt.");
+        }
+        CapturedLinearSystem system;
+        system.tolerance = get<double>(file, filename);
+        getArray(file, size + 1, system.ia, filename);
+        getArray(file, nonzeros, system.ja, filename);
+        getArray(file, nonzeros, system.sa, filename);
+        getArray(file, size, system.rhs, filename);
+        getArray(file, size, system.initial_guess, filename);
+        if (system.ia[0] != 0 || system.ia[size] != nonzeros) {
+            OPM_THROW(std::runtime_error, "Linear system file " << filename << " is corrupt.");
+        }
+        for (int row = 0; row < size; ++row) {
+            if (system.ia[row + 1] < system.ia[row]) {
+                OPM_THROW(std::runtime_error, "Linear system file " << filename
+                          << " is corrupt: row starts decrease at row " << row << '.');
+            }
+        }
+        for (int k = 0; k < nonzeros; ++k) {
+            if (system.ja[k] < 0 || system.ja[k] >= size) {
+                OPM_THROW(std::runtime_error, "Linear system file " << filename
+                          << " is corrupt: column index " << system.ja[k] << " out of range.");
+            }
+        }
+        return system;
+    }
+
+
+
+
+    LinearSolverCapture::LinearSolverCapture(LinearSolverInterface& inner,
+                                             const std::string& prefix,
+                                             const int max_systems)
+        : inner_(inner),
+          prefix_(prefix),
+          max_systems_(max_systems),
+          num_captured_(0)
+    {
+    }
+
+
+
+
+    LinearSolverCapture::~LinearSolverCapture()
+    {
+    }
+
+
+
+
+    LinearSolverInterface::LinearSolverReport
+    LinearSolverCapture::solve(const int size,
+                               const int nonzeros,
+                               const int* ia,
+                               const int* ja,
+                               const double* sa,
+                               const double* rhs,
+                               double* solution,
+                               const boost::any& add) const
+    {
+        if (add.empty()) {
+            capture(size, nonzeros, ia, ja, sa, rhs, solution);
+        }
+        return inner_.solve(size, nonzeros, ia, ja, sa, rhs, solution, add);
+    }
+
+
+
+
+    LinearSolverInterface::LinearSolverReport
+    LinearSolverCapture::solveMultiple(const int size,
+                                       const int nonzeros,
+                                       const int* ia,
+                                       const int* ja,
+                                       const double* sa,
+                                       const int num_rhs,
+                                       const double* rhs,
+                                       double* solution,
+                                       const boost::any& add) const
+    {
+        if (add.empty()) {
+            for (int k = 0; k < num_rhs; ++k) {
+                capture(size, nonzeros, ia, ja, sa, rhs + k*size, solution + k*size);
+            }
+        }
+        return inner_.solveMultiple(size, nonzeros, ia, ja, sa, num_rhs, rhs, solution, add);
+    }
+
+
+
+
+    void LinearSolverCapture::setTolerance(const double tol)
+    {
+        inner_.setTolerance(tol);
+    }
+
+
+
+
+    double LinearSolverCapture::getTolerance() const
+    {
+        return inner_.getTolerance();
+    }
+
+
+
+
+    int LinearSolverCapture::numCaptured() const
+    {
+        return num_captured_;
+    }
+
+
+
+
+    void LinearSolverCapture::capture(const int size, const int nonzeros,
+                                      const int* ia, const int* ja, const double* sa,
+                                      const double* rhs, const double* initial_guess) const
+    {
+        if (max_systems_ >= 0 && num_captured_ >= max_systems_) {
+            return;
+        }
+        CapturedLinearSystem system;
+        system.ia.assign(ia, ia + size + 1);
+        system.ja.assign(ja, ja + nonzeros);
+        system.sa.assign(sa, sa + nonzeros);
+        system.rhs.assign(rhs, rhs + size);
+        system.initial_guess.assign(initial_guess, initial_guess + size);
+        system.tolerance = inner_.getTolerance();
+
+        std::ostringstream filename;
+        filename << prefix_ << '-' << std::setw(4) << std::setfill('0') << num_captured_ << ".olsys";
+        writeLinearSystem(filename.str(), system);
+        ++num_captured_;
+    }
+
+
+} // namespace Opm
@@ -0,0 +1,153 @@
+/*
+  Copyright 2015 SINTEF ICT, Applied Mathematics.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OPM_LINEARSYSTEMCAPTURE_HEADER_INCLUDED
+#define OPM_LINEARSYSTEMCAPTURE_HEADER_INCLUDED
+
+#include <opm/core/linalg/LinearSolverInterface.hpp>
+#include <string>
+#include <vector>
+
+namespace Opm
+{
+
+
+    /// A linear system as passed to LinearSolverInterface::solve(),
+    /// together with the initial guess and the solver tolerance.
+    struct CapturedLinearSystem
+    {
+        std::vector<int> ia;
+        std::vector<int> ja;
+        std::vector<double> sa;
+        std::vector<double> rhs;
+        std::vector<double> initial_guess;
+        double tolerance;
+
+        /// # of rows in matrix.
+        int size() const { return rhs.size(); }
+        /// # of nonzero elements in matrix.
+        int nonzeros() const { return sa.size(); }
+    };
+
+    /// Write a linear system in the binary capture format.
+    /// The files are meant to be read on the platform that wrote them.
+    void writeLinearSystem(const std::string& filename,
+                           const CapturedLinearSystem& system);
+
+    /// Read a linear system written by writeLinearSystem().
+    /// Throws if the file is not a valid capture file.
+    CapturedLinearSystem readLinearSystem(const std::string& filename);
+
+
+    /// Linear solver wrapper that writes every system it is asked to
+    /// solve to a file before passing it on to the wrapped solver, so
+    /// that production systems can be replayed offline against other
+    /// solvers, see examples/replay_linear_systems.cpp.
+    ///
+    /// The files are named <prefix>-<number>.olsys, numbered from zero
+    /// in the order of the solves. Each right hand side of a call to
+    /// solveMultiple() is written as a separate system. Systems with
+    /// parallel information are passed on without being captured,
+    /// since they only hold the local part of the matrix.
+    class LinearSolverCapture : public LinearSolverInterface
+    {
+    public:
+        /// Construct wrapper.
+        /// \param[in] inner        solver used for the solves, must
+        ///                         outlive this object.
+        /// \param[in] prefix       path and prefix of the capture files.
+        /// \param[in] max_systems  number of systems to capture, later
+        ///                         systems are only solved. Negative
+        ///                         means no limit.
+        LinearSolverCapture(LinearSolverInterface& inner,
+                            const std::string& prefix,
+                            const int max_systems = -1);
+
+        /// Destructor.
+        virtual ~LinearSolverCapture();
+
+        using LinearSolverInterface::solve;
+
+        /// Solve a linear system, with a matrix given in compressed sparse row format.
+        /// \param[in] size        # of rows in matrix
+        /// \param[in] nonzeros    # of nonzeros elements in matrix
+        /// \param[in] ia          array of length (size + 1) containing start and end indices for each row
+        /// \param[in] ja          array of length nonzeros containing column numbers for the nonzero elements
+        /// \param[in] sa          array of length nonzeros containing the values of the nonzero elements
+        /// \param[in] rhs         array of length size containing the right hand side
+        /// \param[inout] solution array of length size to which the solution will be written, may also be used
+        ///                        as initial guess by iterative solvers.
+        virtual LinearSolverReport solve(const int size,
+                                         const int nonzeros,
+                                         const int* ia,
+                                         const int* ja,
+                                         const double* sa,
+                                         const double* rhs,
+                                         double* solution,
+                                         const boost::any& add=boost::any()) const;
+
+        using LinearSolverInterface::solveMultiple;
+
+        /// Solve a linear system for several right hand sides, with a matrix given
+        /// in compressed sparse row format.
+        /// Forwarded to the wrapped solver after capturing each right hand side.
+        /// \param[in] size        # of rows in matrix
+        /// \param[in] nonzeros    # of nonzeros elements in matrix
+        /// \param[in] ia          array of length (size + 1) containing start and end indices for each row
+        /// \param[in] ja          array of length nonzeros containing column numbers for the nonzero elements
+        /// \param[in] sa          array of length nonzeros containing the values of the nonzero elements
+        /// \param[in] num_rhs     # of right hand sides
+        /// \param[in] rhs         array of length num_rhs*size, right hand side k starts at rhs + k*size
+        /// \param[out] solution   array of length num_rhs*size, laid out like rhs
+        virtual LinearSolverReport solveMultiple(const int size,
+                                                 const int nonzeros,
+                                                 const int* ia,
+                                                 const int* ja,
+                                                 const double* sa,
+                                                 const int num_rhs,
+                                                 const double* rhs,
+                                                 double* solution,
+                                                 const boost::any& add=boost::any()) const;
+
+        /// Set tolerance of the wrapped solver.
+        /// \param[in] tol         tolerance value
+        virtual void setTolerance(const double tol);
+
+        /// Get tolerance of the wrapped solver.
+        /// \param[out] tolerance value
+        virtual double getTolerance() const;
+
+        /// Number of systems written so far.
+        int numCaptured() const;
+
+    private:
+        void capture(const int size, const int nonzeros,
+                     const int* ia, const int* ja, const double* sa,
+                     const double* rhs, const double* initial_guess) const;
+
+        LinearSolverInterface& inner_;
+        std::string prefix_;
+        int max_systems_;
+        mutable int num_captured_;
+    };
+
+
+} // namespace Opm
+
+#endif // OPM_LINEARSYSTEMCAPTURE_HEADER_INCLUDED
@@ -40,8 +40,12 @@
 #include <algorithm>
 #include <functional>
 #include <limits>
+#include <memory>
 #include <numeric>
+#include <stdexcept>
 #include <type_traits>
+#include <utility>
+#include <vector>
 
 namespace Opm
 {
@@ -143,22 +147,125 @@ public:
     template<class T>
     void copyOwnerToAll (const T& source, T& dest) const
     {
-        typedef Dune::Combine<Dune::EnumItem<Dune::OwnerOverlapCopyAttributeSet::AttributeSet,Dune::OwnerOverlapCopyAttributeSet::owner>,Dune::EnumItem<Dune::OwnerOverlapCopyAttributeSet::AttributeSet,Dune::OwnerOverlapCopyAttributeSet::overlap>,Dune::OwnerOverlapCopyAttributeSet::AttributeSet> OwnerOverlapSet;
-        typedef Dune::EnumItem<Dune::OwnerOverlapCopyAttributeSet::AttributeSet,Dune::OwnerOverlapCopyAttributeSet::owner> OwnerSet;
-        typedef Dune::Combine<OwnerOverlapSet, Dune::EnumItem<Dune::OwnerOverlapCopyAttributeSet::AttributeSet,Dune::OwnerOverlapCopyAttributeSet::copy>,Dune::OwnerOverlapCopyAttributeSet::AttributeSet> AllSet;
-      OwnerSet sourceFlags;
-      AllSet destFlags;
-      Dune::Interface interface(communicator_);
-      if( !remoteIndices_->isSynced() )
-      {
-          remoteIndices_->rebuild<false>();
-      }
-      interface.build(*remoteIndices_,sourceFlags,destFlags);
       Dune::BufferedCommunicator communicator;
-      communicator.template build<T>(interface);
+      communicator.template build<T>(ownerToAllInterface());
       communicator.template forward<CopyGatherScatter<T> >(source,dest);
       communicator.free();
     }
+    /// \brief Start a non-blocking copy of the dofs owned by us to the other processes.
+    ///
+    /// The values to send are packed before returning, so source may be
+    /// modified afterwards. Computations not involving the non-owned dofs
+    /// can be done before calling copyOwnerToAllEnd(). Only one copy may be
+    /// pending at a time.
+    /// \tparam T A container whose entries are trivially copyable.
+    template<class T>
+    void copyOwnerToAllBegin(const T& source) const
+    {
+        typedef typename Dune::CommPolicy<T>::IndexedType V;
+        if( pendingCopy_.active )
+        {
+            OPM_THROW(std::logic_error, "A non-blocking copy is already pending.");
+        }
+        const auto& interfaces = ownerToAllInterface().interfaces();
+        std::size_t sendSize = 0, recvSize = 0;
+        for( const auto& remote : interfaces )
+        {
+            sendSize += remote.second.first.size();
+            recvSize += remote.second.second.size();
+        }
+        pendingCopy_.sendBuffer.resize(sendSize*sizeof(V));
+        pendingCopy_.recvBuffer.resize(recvSize*sizeof(V));
+        pendingCopy_.requests.clear();
+        V* sendBuffer = reinterpret_cast<V*>(pendingCopy_.sendBuffer.data());
+        V* recvBuffer = reinterpret_cast<V*>(pendingCopy_.recvBuffer.data());
+        MPI_Comm comm = communicator_;
+        const int tag = 4712;
+        std::size_t sendPos = 0, recvPos = 0;
+        for( const auto& remote : interfaces )
+        {
+            const auto& recvList = remote.second.second;
+            if( recvList.size() )
+            {
+                pendingCopy_.requests.push_back(MPI_Request());
+                MPI_Irecv(recvBuffer + recvPos, recvList.size()*sizeof(V), MPI_BYTE,
+                          remote.first, tag, comm, &pendingCopy_.requests.back());
+                recvPos += recvList.size();
+            }
+            const auto& sendList = remote.second.first;
+            if( sendList.size() )
+            {
+                V* start = sendBuffer + sendPos;
+                for( std::size_t i = 0; i < sendList.size(); ++i )
+                {
+                    sendBuffer[sendPos++] = source[sendList[i]];
+                }
+                pendingCopy_.requests.push_back(MPI_Request());
+                MPI_Isend(start, sendList.size()*sizeof(V), MPI_BYTE,
+                          remote.first, tag, comm, &pendingCopy_.requests.back());
+            }
+        }
+        pendingCopy_.active = true;
+    }
+    /// \brief Complete a copy started by copyOwnerToAllBegin().
+    ///
+    /// Afterwards all non-owned dofs of dest contain the values of their owners.
+    template<class T>
+    void copyOwnerToAllEnd(T& dest) const
+    {
+        typedef typename Dune::CommPolicy<T>::IndexedType V;
+        if( !pendingCopy_.active )
+        {
+            OPM_THROW(std::logic_error, "No non-blocking copy is pending.");
+        }
+        if( !pendingCopy_.requests.empty() )
+        {
+            MPI_Waitall(pendingCopy_.requests.size(), &pendingCopy_.requests[0],
+                        MPI_STATUSES_IGNORE);
+        }
+        const V* recvBuffer = reinterpret_cast<const V*>(pendingCopy_.recvBuffer.data());
+        std::size_t recvPos = 0;
+        for( const auto& remote : ownerToAllInterface().interfaces() )
+        {
+            const auto& recvList = remote.second.second;
+            for( std::size_t i = 0; i < recvList.size(); ++i )
+            {
+                dest[recvList[i]] = recvBuffer[recvPos++];
+            }
+        }
+        pendingCopy_.active = false;
+    }
+    /// \brief Compute several inner products of owned dofs with one global sum.
+    ///
+    /// This is cheaper than separate reductions when the communication is
+    /// latency bound, as for the norms and inner products needed in one
+    /// Krylov iteration. Norms are obtained by passing a vector twice.
+    /// \param pairs Pairs of containers (x_i, y_i) of equal size.
+    /// \param[out] results results[i] is the sum of x_i[j]*y_i[j] over
+    /// the dofs j owned by us.
+    template<class Container>
+    void computeInnerProducts(const std::vector<std::pair<const Container*, const Container*> >& pairs,
+                              std::vector<double>& results) const
+    {
+        results.assign(pairs.size(), 0.0);
+        if( pairs.empty() )
+        {
+            return;
+        }
+        const std::vector<double>& mask = updateOwnerMask(*pairs[0].first);
+        for( std::size_t k = 0; k < pairs.size(); ++k )
+        {
+            const Container& x = *pairs[k].first;
+            const Container& y = *pairs[k].second;
+            double sum = 0.0;
+            for( std::size_t j = 0; j < mask.size(); ++j )
+            {
+                sum += mask[j]*x[j]*y[j];
+            }
+            results[k] = sum;
+        }
+        communicator_.sum(&results[0], results.size());
+    }
     template<class T>
     const std::vector<double>& updateOwnerMask(const T& container) const
     {
@@ -204,6 +311,30 @@ public:
         computeReduction(container, binaryOperator, value, is_tuple<Container>());
     }
 private:
+    /// \brief Get the interface for communicating from owner to all dofs.
+    ///
+    /// The interface is built on first use and rebuilt only when the
+    /// index set changes.
+    const Dune::Interface& ownerToAllInterface() const
+    {
+        typedef Dune::Combine<Dune::EnumItem<Dune::OwnerOverlapCopyAttributeSet::AttributeSet,Dune::OwnerOverlapCopyAttributeSet::owner>,Dune::EnumItem<Dune::OwnerOverlapCopyAttributeSet::AttributeSet,Dune::OwnerOverlapCopyAttributeSet::overlap>,Dune::OwnerOverlapCopyAttributeSet::AttributeSet> OwnerOverlapSet;
+        typedef Dune::EnumItem<Dune::OwnerOverlapCopyAttributeSet::AttributeSet,Dune::OwnerOverlapCopyAttributeSet::owner> OwnerSet;
+        typedef Dune::Combine<OwnerOverlapSet, Dune::EnumItem<Dune::OwnerOverlapCopyAttributeSet::AttributeSet,Dune::OwnerOverlapCopyAttributeSet::copy>,Dune::OwnerOverlapCopyAttributeSet::AttributeSet> AllSet;
+        if( !remoteIndices_->isSynced() )
+        {
+            remoteIndices_->rebuild<false>();
+            ownerToAllInterface_.reset();
+        }
+        if( !ownerToAllInterface_ || interfaceSeqNo_ != indexSet_->seqNo() )
+        {
+            OwnerSet sourceFlags;
+            AllSet destFlags;
+            ownerToAllInterface_.reset(new Dune::Interface(communicator_));
+            ownerToAllInterface_->build(*remoteIndices_, sourceFlags, destFlags);
+            interfaceSeqNo_ = indexSet_->seqNo();
+        }
+        return *ownerToAllInterface_;
+    }
     /// \brief compute the reductions for tuples.
     ///
     /// This is a helper function to prepare for calling computeTupleReduction.
@@ -363,6 +494,19 @@ private:
     std::shared_ptr<RemoteIndices> remoteIndices_;
     Dune::CollectiveCommunication<MPI_Comm> communicator_;
     mutable std::vector<double> ownerMask_;
+    /// \brief Cached interface for copyOwnerToAll and friends.
+    mutable std::shared_ptr<Dune::Interface> ownerToAllInterface_;
+    /// \brief Sequence number of the index set the interface was built for.
+    mutable int interfaceSeqNo_ = -1;
+    /// \brief State of a pending non-blocking copy.
+    struct PendingCopy
+    {
+        bool active = false;
+        std::vector<char> sendBuffer;
+        std::vector<char> recvBuffer;
+        std::vector<MPI_Request> requests;
+    };
+    mutable PendingCopy pendingCopy_;
 };
 
     namespace Reduction
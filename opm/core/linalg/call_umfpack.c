@@ -143,9 +143,11 @@ csr_to_csc(const int        *ia,
 
 /* ---------------------------------------------------------------------- */
 static void
-solve_umfpack(struct CSCMatrix *csc, const double *b, double *x)
+solve_umfpack_multiple(struct CSCMatrix *csc, int nrhs,
+                       const double *b, double *x)
 /* ---------------------------------------------------------------------- */
 {
+    int   k;
     void *Symbolic, *Numeric;
     double Info[UMFPACK_INFO], Control[UMFPACK_CONTROL];
 
@@ -158,8 +160,12 @@ solve_umfpack(struct CSCMatrix *csc, const double *b, double *x)
 
     umfpack_dl_free_symbolic(&Symbolic);
 
-    umfpack_dl_solve(UMFPACK_A, csc->p, csc->i, csc->x, x, b,
-                     Numeric, Control, Info);
+    /* Factor once, back-substitute for each right hand side */
+    for (k = 0; k < nrhs; k++) {
+        umfpack_dl_solve(UMFPACK_A, csc->p, csc->i, csc->x,
+                         x + k*csc->n, b + k*csc->n,
+                         Numeric, Control, Info);
+    }
 
     umfpack_dl_free_numeric(&Numeric);
 }
@@ -167,7 +173,8 @@ solve_umfpack(struct CSCMatrix *csc, const double *b, double *x)
 
 /*---------------------------------------------------------------------------*/
 void
-call_UMFPACK(struct CSRMatrix *A, const double *b, double *x)
+call_UMFPACK_multiple(struct CSRMatrix *A, int nrhs,
+                      const double *b, double *x)
 /*---------------------------------------------------------------------------*/
 {
     struct CSCMatrix *csc;
@@ -177,9 +184,18 @@ call_UMFPACK(struct CSRMatrix *A, const double *b, double *x)
     if (csc != NULL) {
         csr_to_csc(A->ia, A->ja, A->sa, csc);
 
-        solve_umfpack(csc, b, x);
+        solve_umfpack_multiple(csc, nrhs, b, x);
     }
 
     csc_deallocate(csc);
 }
 
+
+/*---------------------------------------------------------------------------*/
+void
+call_UMFPACK(struct CSRMatrix *A, const double *b, double *x)
+/*---------------------------------------------------------------------------*/
+{
+    call_UMFPACK_multiple(A, 1, b, x);
+}
+
@@ -43,6 +43,11 @@ struct CSRMatrix;
 
 void call_UMFPACK(struct CSRMatrix *A, const double *b, double *x);
 
+/* Solve A x = b for nrhs right hand sides using a single factorisation.
+ * Right hand side and solution k are stored at b + k*A->m and x + k*A->m. */
+void call_UMFPACK_multiple(struct CSRMatrix *A, int nrhs,
+                           const double *b, double *x);
+
 #ifdef __cplusplus
 }
 #endif
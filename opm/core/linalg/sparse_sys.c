@@ -178,6 +178,27 @@ csrmatrix_delete(struct CSRMatrix *A)
 }
 
 
+/* ---------------------------------------------------------------------- */
+size_t
+csrmatrix_memory_usage(const struct CSRMatrix *A)
+/* ---------------------------------------------------------------------- */
+{
+    size_t nbytes;
+
+    nbytes = 0;
+
+    if (A != NULL) {
+        nbytes += sizeof *A;
+
+        if (A->ia != NULL) { nbytes += (A->m + 1) * sizeof *A->ia; }
+        if (A->ja != NULL) { nbytes += A->nnz     * sizeof *A->ja; }
+        if (A->sa != NULL) { nbytes += A->nnz     * sizeof *A->sa; }
+    }
+
+    return nbytes;
+}
+
+
 /* ---------------------------------------------------------------------- */
 void
 csrmatrix_zero(struct CSRMatrix *A)
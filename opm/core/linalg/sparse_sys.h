@@ -162,6 +162,19 @@ void
 csrmatrix_delete(struct CSRMatrix *A);
 
 
+/**
+ * Compute number of bytes of dynamically allocated storage held by a
+ * matrix, including the matrix structure itself.
+ *
+ * \param[in] A Matrix.  May be @c NULL.
+ *
+ * \return Total storage, in bytes, held by @c A.  Zero if
+ * <CODE>A == NULL</CODE>.
+ */
+size_t
+csrmatrix_memory_usage(const struct CSRMatrix *A);
+
+
 /**
  * Zero all matrix elements, typically in preparation of elemental
  * assembly.
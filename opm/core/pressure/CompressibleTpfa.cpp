@@ -32,16 +32,124 @@
 #include <opm/core/simulator/BlackoilState.hpp>
 #include <opm/core/simulator/WellState.hpp>
 #include <opm/core/props/rock/RockCompressibility.hpp>
+#include <opm/core/props/BlackoilPropertiesInterface.hpp>
 
 #include <algorithm>
 #include <cmath>
 #include <iostream>
 #include <iomanip>
 #include <numeric>
+#include <utility>
 
 namespace Opm
 {
 
+    namespace
+    {
+        // Computes the upwind fluid matrices and mobilities and the
+        // gravity contributions of every face, see
+        // CompressibleTpfa::computeFaceDynamicData().
+        struct FaceDataKernel
+        {
+            const UnstructuredGrid& grid;
+            int np;
+            double grav;
+            const double* cell_press;
+            const double* face_press;
+            const double* cell_rho; // May be null if grav is zero.
+            const double* cell_phasemob;
+            const double* cell_A;
+            double* face_A;
+            double* face_phasemob;
+            double* face_gravcap;
+
+            template <PhaseConfiguration Config>
+            void apply() const
+            {
+                const int np = PhaseTraits<Config>::numPhases(this->np);
+                const int nf = grid.number_of_faces;
+                const int dim = grid.dimensions;
+                double gravcontrib[2][BlackoilPhases::MaxNumPhases];
+                double pot[2][BlackoilPhases::MaxNumPhases];
+                for (int face = 0; face < nf; ++face) {
+                    // Obtain properties from both sides of the face.
+                    const double face_depth = grid.face_centroids[face*dim + dim - 1];
+                    const int* c = &grid.face_cells[2*face];
+
+                    // Get pressures and compute gravity contributions,
+                    // to decide upwind directions.
+                    double c_press[2];
+                    for (int j = 0; j < 2; ++j) {
+                        if (c[j] >= 0) {
+                            // Pressure
+                            c_press[j] = cell_press[c[j]];
+                            // Gravity contribution, gravcontrib = rho*(face_z - cell_z) [per phase].
+                            if (grav != 0.0) {
+                                const double depth_diff = face_depth - grid.cell_centroids[c[j]*dim + dim - 1];
+                                for (int p = 0; p < np; ++p) {
+                                    gravcontrib[j][p] = cell_rho[np*c[j] + p]*depth_diff*grav;
+                                }
+                            } else {
+                                std::fill(gravcontrib[j], gravcontrib[j] + np, 0.0);
+                            }
+                        } else {
+                            // Pressures
+                            c_press[j] = face_press[face];
+                            // Gravity contribution.
+                            std::fill(gravcontrib[j], gravcontrib[j] + np, 0.0);
+                        }
+                    }
+
+                    // Gravity contribution:
+                    //    gravcapf = rho_1*g*(z_12 - z_1) - rho_2*g*(z_12 - z_2)
+                    // where _1 and _2 refers to two neigbour cells, z is the
+                    // z coordinate of the centroid, and z_12 is the face centroid.
+                    // Also compute the potentials.
+                    for (int phase = 0; phase < np; ++phase) {
+                        face_gravcap[np*face + phase] = gravcontrib[0][phase] - gravcontrib[1][phase];
+                        pot[0][phase] = c_press[0] + face_gravcap[np*face + phase];
+                        pot[1][phase] = c_press[1];
+                    }
+
+                    // Now we can easily find the upwind direction for every phase,
+                    // we can also tell which boundary faces are inflow bdys.
+
+                    // Get upwind mobilities by phase.
+                    // Get upwind A matrix rows by phase.
+                    // NOTE:
+                    // We should be careful to upwind the R factors,
+                    // the B factors are not that vital.
+                    //      z = Au = RB^{-1}u,
+                    // where (this example is for gas-oil)
+                    //      R = [1 RgL; RoV 1], B = [BL 0 ; 0 BV]
+                    // (RgL is gas in Liquid phase, RoV is oil in Vapour phase.)
+                    //      A = [1/BL RgL/BV; RoV/BL 1/BV]
+                    // This presents us with a dilemma, as V factors should be
+                    // upwinded according to V phase flow, same for L. What then
+                    // about the RgL/BV and RoV/BL numbers?
+                    // We give priority to R, and therefore upwind the rows of A
+                    // by phase (but remember, Fortran matrix ordering).
+                    // This prompts the question if we should split the matrix()
+                    // property method into formation volume and R-factor methods.
+                    for (int phase = 0; phase < np; ++phase) {
+                        int upwindc = -1;
+                        if (c[0] >=0 && c[1] >= 0) {
+                            upwindc = (pot[0][phase] < pot[1][phase]) ? c[1] : c[0];
+                        } else {
+                            upwindc = (c[0] >= 0) ? c[0] : c[1];
+                        }
+                        face_phasemob[np*face + phase] = cell_phasemob[np*upwindc + phase];
+                        for (int p2 = 0; p2 < np; ++p2) {
+                            // Recall: column-major ordering.
+                            face_A[np*np*face + phase + np*p2]
+                                = cell_A[np*np*upwindc + phase + np*p2];
+                        }
+                    }
+                }
+            }
+        };
+    } // anonymous namespace
+
 
     /// Construct solver.
     /// \param[in] grid          A 2d or 3d grid.
@@ -59,6 +167,18 @@ namespace Opm
     ///                                and completions does not change during the
     ///                                run. However, controls (only) are allowed
     ///                                to change.
+    /// \param[in] forcing_max   If positive, the relative tolerance of the
+    ///                          linear solver is chosen adaptively in each
+    ///                          Newton iteration (Eisenstat-Walker forcing
+    ///                          terms), never looser than this value
+    ///                          nor tighter than the tolerance of linsolver.
+    ///                          Needs linsolver by non-const reference.
+    /// \param[in] max_backtracks Maximum number of times the Newton step is
+    ///                          halved when it does not decrease the residual.
+    /// \param[in] well_schur    If true, the well bhp unknowns that can be
+    ///                          eliminated without fill (bhp controlled and
+    ///                          single-perforation wells) are removed before
+    ///                          calling the linear solver.
     CompressibleTpfa::CompressibleTpfa(const UnstructuredGrid& grid,
                                        const BlackoilPropertiesInterface& props,
                                        const RockCompressibility* rock_comp_props,
@@ -67,20 +187,30 @@ namespace Opm
                                        const double change_tol,
                                        const int maxiter,
                                        const double* gravity,
-                                       const struct Wells* wells)
+                                       const struct Wells* wells,
+                                       const double forcing_max,
+                                       const int max_backtracks,
+                                       const bool well_schur)
         : grid_(grid),
           props_(props),
           rock_comp_props_(rock_comp_props),
           linsolver_(linsolver),
+          tunable_linsolver_(0),
           residual_tol_(residual_tol),
           change_tol_(change_tol),
           maxiter_(maxiter),
           gravity_(gravity),
           wells_(wells),
+          forcing_max_(forcing_max),
+          max_backtracks_(max_backtracks),
+          well_schur_(well_schur),
+          phase_config_(phaseConfiguration(props.phaseUsage())),
           htrans_(grid.cell_facepos[ grid.number_of_cells ]),
           trans_ (grid.number_of_faces),
           allcells_(grid.number_of_cells),
-          singular_(false)
+          singular_(false),
+          linear_iterations_(0),
+          backtracks_(0)
     {
         if (wells_ && (wells_->number_of_phases != props.numPhases())) {
             OPM_THROW(std::runtime_error, "Inconsistent number of phases specified (wells vs. props): "
@@ -109,6 +239,30 @@ namespace Opm
 
 
 
+    /// Construct solver that may change the tolerance of linsolver.
+    CompressibleTpfa::CompressibleTpfa(const UnstructuredGrid& grid,
+                                       const BlackoilPropertiesInterface& props,
+                                       const RockCompressibility* rock_comp_props,
+                                       LinearSolverInterface& linsolver,
+                                       const double residual_tol,
+                                       const double change_tol,
+                                       const int maxiter,
+                                       const double* gravity,
+                                       const struct Wells* wells,
+                                       const double forcing_max,
+                                       const int max_backtracks,
+                                       const bool well_schur)
+        : CompressibleTpfa(grid, props, rock_comp_props,
+                           static_cast<const LinearSolverInterface&>(linsolver),
+                           residual_tol, change_tol, maxiter, gravity, wells,
+                           forcing_max, max_backtracks, well_schur)
+    {
+        tunable_linsolver_ = &linsolver;
+    }
+
+
+
+
     /// Destructor.
     CompressibleTpfa::~CompressibleTpfa()
     {
@@ -123,8 +277,16 @@ namespace Opm
                                  BlackoilState& state,
                                  WellState& well_state)
     {
-        const int nc = grid_.number_of_cells;
-        const int nw = (wells_ != 0) ? wells_->number_of_wells : 0;
+        // Forcing term parameters, choice 2 of Eisenstat and Walker (1996).
+        const double ew_gamma = 0.9;
+        const double ew_alpha = 2.0;
+        const bool adaptive = forcing_max_ > 0.0 && tunable_linsolver_ != 0
+            && linsolver_.getTolerance() > 0.0;
+        double forcing = forcing_max_;
+        // Set when a small increment came from a loose linear solve.
+        bool tighten = false;
+        linear_iterations_ = 0;
+        backtracks_ = 0;
 
         // Set up dynamic data.
         computePerSolveDynamicData(dt, state, well_state);
@@ -144,24 +306,32 @@ namespace Opm
             // Solve for increment in Newton method:
             //   incr = x_{n+1} - x_{n} = -J^{-1}F
             // (J is Jacobian matrix, F is residual)
-            solveIncrement();
+            if (adaptive) {
+                // Do not solve more accurately than needed to reach
+                // residual_tol_.
+                forcing = std::min(std::max(forcing, 0.5*residual_tol_/res_norm), forcing_max_);
+            }
+            const bool loose = adaptive && !tighten && forcing > linsolver_.getTolerance();
+            solveIncrement(loose ? forcing : -1.0);
             ++iter;
 
             // Update pressure vars with increment.
-            for (int c = 0; c < nc; ++c) {
-                state.pressure()[c] += pressure_increment_[c];
-            }
-            for (int w = 0; w < nw; ++w) {
-                well_state.bhp()[w] += pressure_increment_[nc + w];
-            }
+            applyIncrement(1.0, state, well_state);
 
-            // Stop iterating if increment is small.
+            // Stop iterating if increment is small. An increment from
+            // a loose linear solve may be small without the iterate
+            // being converged, so the next one is solved to the full
+            // tolerance of the linear solver before accepting.
             inc_norm = incrementNorm();
+            tighten = false;
             if (inc_norm <= change_tol_) {
-                std::cout << std::setw(9) << iter
-                          << std::setw(18) << '*'
-                          << std::setw(18) << inc_norm << std::endl;
-                break;
+                if (!loose) {
+                    std::cout << std::setw(9) << iter
+                              << std::setw(18) << '*'
+                              << std::setw(18) << inc_norm << std::endl;
+                    break;
+                }
+                tighten = true;
             }
 
             // Set up dynamic data.
@@ -170,19 +340,43 @@ namespace Opm
             // Assemble J and F.
             assemble(dt, state, well_state);
 
-            // Update residual norm.
+            // Update residual norm, halving the step while the
+            // residual does not decrease sufficiently.
+            const double old_res_norm = res_norm;
             res_norm = residualNorm();
+            double step = 1.0;
+            for (int bt = 0; bt < max_backtracks_ && res_norm > (1.0 - 1e-4*step)*old_res_norm; ++bt) {
+                applyIncrement(-0.5*step, state, well_state);
+                step *= 0.5;
+                computePerIterationDynamicData(dt, state, well_state);
+                assemble(dt, state, well_state);
+                res_norm = residualNorm();
+                ++backtracks_;
+            }
 
+            if (adaptive) {
+                const double previous = forcing;
+                forcing = ew_gamma*std::pow(res_norm/old_res_norm, ew_alpha);
+                const double safeguard = ew_gamma*std::pow(previous, ew_alpha);
+                if (safeguard > 0.1) {
+                    forcing = std::max(forcing, safeguard);
+                }
+                forcing = std::min(forcing, forcing_max_);
+            }
+
+            // Only the accepted fraction of the increment was applied,
+            // but the convergence tests use the full increment.
             std::cout << std::setw(9) << iter
                       << std::setw(18) << res_norm
-                      << std::setw(18) << inc_norm << std::endl;
+                      << std::setw(18) << step*inc_norm << std::endl;
         }
 
-        if ((iter == maxiter_) && (res_norm > residual_tol_) && (inc_norm > change_tol_)) {
+        if ((iter == maxiter_) && (res_norm > residual_tol_) && (inc_norm > change_tol_ || tighten)) {
             OPM_THROW(std::runtime_error, "CompressibleTpfa::solve() failed to converge in " << maxiter_ << " iterations.");
         }
 
-        std::cout << "Solved pressure in " << iter << " iterations." << std::endl;
+        std::cout << "Solved pressure in " << iter << " iterations ("
+                  << linear_iterations_ << " linear iterations)." << std::endl;
 
         // Compute fluxes and face pressures.
         computeResults(state, well_state);
@@ -191,6 +385,24 @@ namespace Opm
 
 
 
+    /// Add step times the increment to the pressures and bhps.
+    void CompressibleTpfa::applyIncrement(const double step,
+                                          BlackoilState& state,
+                                          WellState& well_state) const
+    {
+        const int nc = grid_.number_of_cells;
+        const int nw = (wells_ != 0) ? wells_->number_of_wells : 0;
+        for (int c = 0; c < nc; ++c) {
+            state.pressure()[c] += step*pressure_increment_[c];
+        }
+        for (int w = 0; w < nw; ++w) {
+            well_state.bhp()[w] += step*pressure_increment_[nc + w];
+        }
+    }
+
+
+
+
 
     /// @brief After solve(), was the resulting pressure singular.
     /// Returns true if the pressure is singular in the following
@@ -206,6 +418,44 @@ namespace Opm
 
 
 
+    int CompressibleTpfa::linearIterations() const
+    {
+        return linear_iterations_;
+    }
+
+
+
+
+    int CompressibleTpfa::lineSearchBacktracks() const
+    {
+        return backtracks_;
+    }
+
+
+
+
+    std::size_t CompressibleTpfa::memoryUsage() const
+    {
+        return Opm::memoryUsage(htrans_) + Opm::memoryUsage(trans_)
+            + Opm::memoryUsage(allcells_) + Opm::memoryUsage(wellperf_wdp_)
+            + Opm::memoryUsage(initial_porevol_) + Opm::memoryUsage(cell_A_)
+            + Opm::memoryUsage(cell_dA_) + Opm::memoryUsage(cell_viscosity_)
+            + Opm::memoryUsage(cell_phasemob_) + Opm::memoryUsage(cell_voldisc_)
+            + Opm::memoryUsage(cell_rho_)
+            + Opm::memoryUsage(face_A_) + Opm::memoryUsage(face_phasemob_)
+            + Opm::memoryUsage(face_gravcap_) + Opm::memoryUsage(wellperf_A_)
+            + Opm::memoryUsage(wellperf_phasemob_) + Opm::memoryUsage(porevol_)
+            + Opm::memoryUsage(rock_comp_) + Opm::memoryUsage(pressure_increment_)
+            + Opm::memoryUsage(schur_ia_) + Opm::memoryUsage(schur_ja_)
+            + Opm::memoryUsage(schur_sa_) + Opm::memoryUsage(schur_rhs_)
+            + Opm::memoryUsage(schur_dinv_) + Opm::memoryUsage(schur_pos_)
+            + Opm::memoryUsage(schur_well_)
+            + cfs_tpfa_res_memory_usage(h_);
+    }
+
+
+
+
 
     /// Compute well potentials.
     void CompressibleTpfa::computeWellPotentials(const BlackoilState& state)
@@ -357,91 +607,23 @@ namespace Opm
         const int nf = grid_.number_of_faces;
         const int dim = grid_.dimensions;
         const double grav = gravity_ ? gravity_[dim - 1] : 0.0;
-        std::vector<double> gravcontrib[2];
-        std::vector<double> pot[2];
-        gravcontrib[0].resize(np);
-        gravcontrib[1].resize(np);
-        pot[0].resize(np);
-        pot[1].resize(np);
+        if (grav != 0.0) {
+            // Densities of all cells at once rather than two
+            // single-cell calls per face.
+            cell_rho_.resize(grid_.number_of_cells*np);
+            props_.density(grid_.number_of_cells, &cell_A_[0], &allcells_[0], &cell_rho_[0]);
+        }
         face_A_.resize(nf*np*np);
         face_phasemob_.resize(nf*np);
         face_gravcap_.resize(nf*np);
-        for (int face = 0; face < nf; ++face) {
-            // Obtain properties from both sides of the face.
-            const double face_depth = grid_.face_centroids[face*dim + dim - 1];
-            const int* c = &grid_.face_cells[2*face];
-
-            // Get pressures and compute gravity contributions,
-            // to decide upwind directions.
-            double c_press[2];
-            for (int j = 0; j < 2; ++j) {
-                if (c[j] >= 0) {
-                    // Pressure
-                    c_press[j] = state.pressure()[c[j]];
-                    // Gravity contribution, gravcontrib = rho*(face_z - cell_z) [per phase].
-                    if (grav != 0.0) {
-                        const double depth_diff = face_depth - grid_.cell_centroids[c[j]*dim + dim - 1];
-                        props_.density(1, &cell_A_[np*np*c[j]], &c[j], &gravcontrib[j][0]);
-                        for (int p = 0; p < np; ++p) {
-                            gravcontrib[j][p] *= depth_diff*grav;
-                        }
-                    } else {
-                        std::fill(gravcontrib[j].begin(), gravcontrib[j].end(), 0.0);
-                    }
-                } else {
-                    // Pressures
-                    c_press[j] = state.facepressure()[face];
-                    // Gravity contribution.
-                    std::fill(gravcontrib[j].begin(), gravcontrib[j].end(), 0.0);
-                }
-            }
-
-            // Gravity contribution:
-            //    gravcapf = rho_1*g*(z_12 - z_1) - rho_2*g*(z_12 - z_2)
-            // where _1 and _2 refers to two neigbour cells, z is the
-            // z coordinate of the centroid, and z_12 is the face centroid.
-            // Also compute the potentials.
-            for (int phase = 0; phase < np; ++phase) {
-                face_gravcap_[np*face + phase] = gravcontrib[0][phase] - gravcontrib[1][phase];
-                pot[0][phase] = c_press[0] + face_gravcap_[np*face + phase];
-                pot[1][phase] = c_press[1];
-            }
-
-            // Now we can easily find the upwind direction for every phase,
-            // we can also tell which boundary faces are inflow bdys.
-
-            // Get upwind mobilities by phase.
-            // Get upwind A matrix rows by phase.
-            // NOTE:
-            // We should be careful to upwind the R factors,
-            // the B factors are not that vital.
-            //      z = Au = RB^{-1}u,
-            // where (this example is for gas-oil)
-            //      R = [1 RgL; RoV 1], B = [BL 0 ; 0 BV]
-            // (RgL is gas in Liquid phase, RoV is oil in Vapour phase.)
-            //      A = [1/BL RgL/BV; RoV/BL 1/BV]
-            // This presents us with a dilemma, as V factors should be
-            // upwinded according to V phase flow, same for L. What then
-            // about the RgL/BV and RoV/BL numbers?
-            // We give priority to R, and therefore upwind the rows of A
-            // by phase (but remember, Fortran matrix ordering).
-            // This prompts the question if we should split the matrix()
-            // property method into formation volume and R-factor methods.
-            for (int phase = 0; phase < np; ++phase) {
-                int upwindc = -1;
-                if (c[0] >=0 && c[1] >= 0) {
-                    upwindc = (pot[0][phase] < pot[1][phase]) ? c[1] : c[0];
-                } else {
-                    upwindc = (c[0] >= 0) ? c[0] : c[1];
-                }
-                face_phasemob_[np*face + phase] = cell_phasemob_[np*upwindc + phase];
-                for (int p2 = 0; p2 < np; ++p2) {
-                    // Recall: column-major ordering.
-                    face_A_[np*np*face + phase + np*p2]
-                        = cell_A_[np*np*upwindc + phase + np*p2];
-                }
-            }
-        }
+        const FaceDataKernel kernel = {
+            grid_, np, grav,
+            &state.pressure()[0], &state.facepressure()[0],
+            grav != 0.0 ? &cell_rho_[0] : 0,
+            &cell_phasemob_[0], &cell_A_[0],
+            &face_A_[0], &face_phasemob_[0], &face_gravcap_[0]
+        };
+        dispatchPhaseConfiguration(phase_config_, kernel);
     }
 
 
@@ -549,10 +731,25 @@ namespace Opm
 
 
     /// Computes pressure_increment_.
-    void CompressibleTpfa::solveIncrement()
+    /// If forcing is positive it is used as the relative tolerance of
+    /// the linear solver, otherwise the solver's own tolerance is used.
+    void CompressibleTpfa::solveIncrement(const double forcing)
     {
         // Increment is equal to -J^{-1}F
-        linsolver_.solve(h_->J, h_->F, &pressure_increment_[0]);
+        if (forcing > 0.0 && tunable_linsolver_ != 0) {
+            // The tolerance of the solver is restored before returning.
+            const double tol = tunable_linsolver_->getTolerance();
+            tunable_linsolver_->setTolerance(std::max(forcing, tol));
+            try {
+                linear_iterations_ += solveJacobianSystem();
+            } catch (...) {
+                tunable_linsolver_->setTolerance(tol);
+                throw;
+            }
+            tunable_linsolver_->setTolerance(tol);
+        } else {
+            linear_iterations_ += solveJacobianSystem();
+        }
         std::transform(pressure_increment_.begin(), pressure_increment_.end(),
                        pressure_increment_.begin(), std::negate<double>());
     }
@@ -560,6 +757,184 @@ namespace Opm
 
 
 
+    /// Solve J x = F for x, stored in pressure_increment_.
+    /// Returns the number of linear iterations.
+    int CompressibleTpfa::solveJacobianSystem()
+    {
+        if (well_schur_ && wells_ != 0 && wells_->number_of_wells > 0 && eliminateWells()) {
+            const LinearSolverInterface::LinearSolverReport rep
+                = linsolver_.solve(schur_rhs_.size(), schur_ja_.size(), &schur_ia_[0], &schur_ja_[0],
+                                   &schur_sa_[0], &schur_rhs_[0], &pressure_increment_[0]);
+            recoverWells();
+            return rep.iterations;
+        }
+        const LinearSolverInterface::LinearSolverReport rep
+            = linsolver_.solve(h_->J, h_->F, &pressure_increment_[0]);
+        return rep.iterations;
+    }
+
+
+
+
+    /// Eliminate well bhp unknowns from the Jacobian
+    ///     J = [ A  B ]
+    ///         [ C  D ]
+    /// where this does not introduce fill. Eliminating well w adds
+    /// -B_w D_w^{-1} C_w to the cell block, whose nonzeros are all pairs
+    /// of perforated cells in B_w and C_w. The equation of a bhp
+    /// controlled well does not involve cell pressures (C_w = 0) and a
+    /// well with a single perforation only touches the diagonal, so
+    /// these wells are eliminated. The remaining (rate controlled,
+    /// multi-perforation) wells are kept as a bordered system, ordered
+    /// after the cells. Each well equation only couples the bhp of its
+    /// own well, hence D is diagonal. Returns false, leaving the system
+    /// to be solved as a whole, if D is not diagonal or is singular, or
+    /// if no well can be eliminated.
+    bool CompressibleTpfa::eliminateWells()
+    {
+        const CSRMatrix& J = *h_->J;
+        const double* F = h_->F;
+        const int nc = grid_.number_of_cells;
+        const int nw = wells_->number_of_wells;
+
+        // Count the nonzero cell entries of the well columns B_w. The
+        // sparsity pattern of J has entries for all perforations, also
+        // where the assembled coefficient is zero.
+        schur_well_.assign(nw, 0);
+        for (int row = 0; row < nc; ++row) {
+            for (int k = J.ia[row]; k < J.ia[row + 1]; ++k) {
+                if (J.ja[k] >= nc && J.sa[k] != 0.0) {
+                    ++schur_well_[J.ja[k] - nc];
+                }
+            }
+        }
+
+        // Check D and decide which wells to eliminate. Afterwards
+        // schur_well_[w] is -1 for eliminated wells, otherwise the
+        // position of the well among the kept ones.
+        schur_dinv_.resize(nw);
+        int nkept = 0;
+        for (int w = 0; w < nw; ++w) {
+            const int row = nc + w;
+            double d = 0.0;
+            int ncoupled = 0;
+            for (int k = J.ia[row]; k < J.ia[row + 1]; ++k) {
+                if (J.ja[k] == row) {
+                    d = J.sa[k];
+                } else if (J.ja[k] >= nc) {
+                    return false;
+                } else if (J.sa[k] != 0.0) {
+                    ++ncoupled;
+                }
+            }
+            if (d == 0.0) {
+                return false;
+            }
+            schur_dinv_[w] = 1.0/d;
+            schur_well_[w] = (ncoupled*schur_well_[w] <= 1) ? -1 : nkept++;
+        }
+        if (nkept == nw) {
+            return false;
+        }
+
+        const int nrows = nc + nkept;
+        schur_ia_.assign(1, 0);
+        schur_ja_.clear();
+        schur_sa_.clear();
+        schur_rhs_.resize(nrows);
+        schur_pos_.assign(nrows, -1);
+        std::vector<std::pair<int, double> > row_entries;
+        for (int row = 0; row < nc + nw; ++row) {
+            if (row >= nc && schur_well_[row - nc] < 0) {
+                continue;
+            }
+            const int srow = schur_ia_.size() - 1;
+            const int start = schur_ja_.size();
+            schur_rhs_[srow] = F[row];
+            for (int k = J.ia[row]; k < J.ia[row + 1]; ++k) {
+                const int col = J.ja[k];
+                if (col < nc) {
+                    addSchurEntry(start, col, J.sa[k]);
+                } else if (schur_well_[col - nc] >= 0) {
+                    addSchurEntry(start, nc + schur_well_[col - nc], J.sa[k]);
+                } else {
+                    // Eliminated well: subtract B_{row,w} D_w^{-1} C_w.
+                    const double factor = J.sa[k]*schur_dinv_[col - nc];
+                    schur_rhs_[srow] -= factor*F[col];
+                    for (int kw = J.ia[col]; kw < J.ia[col + 1]; ++kw) {
+                        if (J.ja[kw] < nc && J.sa[kw] != 0.0) {
+                            addSchurEntry(start, J.ja[kw], -factor*J.sa[kw]);
+                        }
+                    }
+                }
+            }
+            // Keep the columns of each row sorted, as in J.
+            row_entries.clear();
+            for (int k = start; k < int(schur_ja_.size()); ++k) {
+                row_entries.push_back(std::make_pair(schur_ja_[k], schur_sa_[k]));
+            }
+            std::sort(row_entries.begin(), row_entries.end());
+            for (int k = start; k < int(schur_ja_.size()); ++k) {
+                schur_ja_[k] = row_entries[k - start].first;
+                schur_sa_[k] = row_entries[k - start].second;
+            }
+            schur_ia_.push_back(schur_ja_.size());
+        }
+        return true;
+    }
+
+
+
+
+    /// Add value to entry (row, col) of the reduced system row
+    /// that starts at index start of schur_ja_.
+    void CompressibleTpfa::addSchurEntry(const int start, const int col, const double value)
+    {
+        if (schur_pos_[col] >= start) {
+            schur_sa_[schur_pos_[col]] += value;
+        } else {
+            schur_pos_[col] = schur_ja_.size();
+            schur_ja_.push_back(col);
+            schur_sa_.push_back(value);
+        }
+    }
+
+
+
+
+    /// Expand the solution of the reduced system in
+    /// pressure_increment_ to all unknowns. The kept wells are moved
+    /// to their own positions, and the eliminated ones are computed
+    /// from x_w = D^{-1} (F_w - C x_c).
+    void CompressibleTpfa::recoverWells()
+    {
+        const CSRMatrix& J = *h_->J;
+        const int nc = grid_.number_of_cells;
+        const int nw = wells_->number_of_wells;
+        // Kept wells only move towards the end, so go backwards.
+        for (int w = nw - 1; w >= 0; --w) {
+            if (schur_well_[w] >= 0) {
+                pressure_increment_[nc + w] = pressure_increment_[nc + schur_well_[w]];
+            }
+        }
+        for (int w = 0; w < nw; ++w) {
+            if (schur_well_[w] >= 0) {
+                continue;
+            }
+            const int row = nc + w;
+            double r = h_->F[row];
+            for (int k = J.ia[row]; k < J.ia[row + 1]; ++k) {
+                if (J.ja[k] < nc) {
+                    r -= J.sa[k]*pressure_increment_[J.ja[k]];
+                }
+            }
+            pressure_increment_[row] = schur_dinv_[w]*r;
+        }
+    }
+
+
+
+
     namespace {
         template <class FI>
         double infnorm(FI beg, FI end)
@@ -21,6 +21,8 @@
 #define OPM_COMPRESSIBLETPFA_HEADER_INCLUDED
 
 
+#include <opm/core/props/PhaseConfiguration.hpp>
+#include <opm/core/utility/MemoryUsage.hpp>
 #include <vector>
 
 struct UnstructuredGrid;
@@ -41,7 +43,7 @@ namespace Opm
     /// Supports gravity, wells and simple sources as driving forces.
     /// Below we use the shortcuts D for the number of dimensions, N
     /// for the number of cells and F for the number of faces.
-    class CompressibleTpfa
+    class CompressibleTpfa : public MemoryUsageInterface
     {
     public:
         /// Construct solver.
@@ -61,6 +63,27 @@ namespace Opm
         ///                                   and completions does not change during the
         ///                                   run. However, controls (only) are allowed
         ///                                   to change.
+        /// \param[in] forcing_max      If positive, the relative tolerance of the
+        ///                             linear solver is chosen adaptively in each
+        ///                             Newton iteration (Eisenstat-Walker forcing
+        ///                             terms), never looser than this value
+        ///                             nor tighter than the tolerance of linsolver.
+        ///                             This needs the constructor taking linsolver
+        ///                             by non-const reference; otherwise, and if
+        ///                             forcing_max is not positive, the tolerance of
+        ///                             linsolver is used unchanged.
+        /// \param[in] max_backtracks   Maximum number of times the Newton step is
+        ///                             halved when it does not decrease the residual.
+        /// \param[in] well_schur       If true, the well bhp unknowns that can be
+        ///                             eliminated (Schur complement) without fill are
+        ///                             removed before calling the linear solver, and
+        ///                             their increments recovered afterwards. Only
+        ///                             bhp controlled and single-perforation wells are
+        ///                             eliminated. Rate controlled wells with several
+        ///                             perforations, such as long horizontal wells,
+        ///                             stay in the system as dense bordered rows and
+        ///                             columns. No effect on linear solver cost has
+        ///                             been measured.
         CompressibleTpfa(const UnstructuredGrid& grid,
                          const BlackoilPropertiesInterface& props,
                          const RockCompressibility* rock_comp_props,
@@ -69,7 +92,27 @@ namespace Opm
                          const double change_tol,
                          const int maxiter,
                          const double* gravity,
-                         const Wells* wells);
+                         const Wells* wells,
+                         const double forcing_max = 0.0,
+                         const int max_backtracks = 0,
+                         const bool well_schur = false);
+
+        /// Construct solver that may change the tolerance of linsolver.
+        /// If forcing_max is positive the tolerance of linsolver is set
+        /// from the forcing term before each linear solve and restored
+        /// afterwards. The parameters are as for the constructor above.
+        CompressibleTpfa(const UnstructuredGrid& grid,
+                         const BlackoilPropertiesInterface& props,
+                         const RockCompressibility* rock_comp_props,
+                         LinearSolverInterface& linsolver,
+                         const double residual_tol,
+                         const double change_tol,
+                         const int maxiter,
+                         const double* gravity,
+                         const Wells* wells,
+                         const double forcing_max = 0.0,
+                         const int max_backtracks = 0,
+                         const bool well_schur = false);
 
         /// Destructor.
         virtual ~CompressibleTpfa();
@@ -89,6 +132,16 @@ namespace Opm
         /// are significant.)
         bool singularPressure() const;
 
+        /// Number of linear solver iterations used by the last call to solve().
+        int linearIterations() const;
+
+        /// Number of Newton step halvings in the last call to solve().
+        int lineSearchBacktracks() const;
+
+        /// Number of bytes owned by the solver, including the
+        /// assembled Jacobian system.
+        virtual std::size_t memoryUsage() const;
+
     private:
         virtual void computePerSolveDynamicData(const double dt,
                                                 const BlackoilState& state,
@@ -108,7 +161,14 @@ namespace Opm
         void assemble(const double dt,
                       const BlackoilState& state,
                       const WellState& well_state);
-        void solveIncrement();
+        void solveIncrement(const double forcing);
+        int solveJacobianSystem();
+        bool eliminateWells();
+        void addSchurEntry(const int start, const int col, const double value);
+        void recoverWells();
+        void applyIncrement(const double step,
+                            BlackoilState& state,
+                            WellState& well_state) const;
         double residualNorm() const;
         double incrementNorm() const;
         void computeResults(BlackoilState& state,
@@ -121,11 +181,16 @@ namespace Opm
         const BlackoilPropertiesInterface& props_;
         const RockCompressibility* rock_comp_props_;
         const LinearSolverInterface& linsolver_;
+        LinearSolverInterface* tunable_linsolver_; // Same as linsolver_, or null if its tolerance is fixed.
         const double residual_tol_;
         const double change_tol_;
         const int maxiter_;
         const double* gravity_; // May be NULL
         const Wells* wells_;    // May be NULL, outside may modify controls (only) between calls to solve().
+        const double forcing_max_;
+        const int max_backtracks_;
+        const bool well_schur_;
+        const PhaseConfiguration phase_config_;
         std::vector<double> htrans_;
         std::vector<double> trans_ ;
         std::vector<int> allcells_;
@@ -143,6 +208,7 @@ namespace Opm
         std::vector<double> cell_viscosity_;
         std::vector<double> cell_phasemob_;
         std::vector<double> cell_voldisc_;
+        std::vector<double> cell_rho_;  // Empty unless gravity is active.
         std::vector<double> face_A_;
         std::vector<double> face_phasemob_;
         std::vector<double> face_gravcap_;
@@ -157,6 +223,18 @@ namespace Opm
         // if everything is incompressible and there are no pressure
         // conditions.
         bool singular_;
+        // Well-eliminated system, see eliminateWells().
+        std::vector<int> schur_well_;
+        std::vector<int> schur_ia_;
+        std::vector<int> schur_ja_;
+        std::vector<double> schur_sa_;
+        std::vector<double> schur_rhs_;
+        std::vector<double> schur_dinv_;
+        std::vector<int> schur_pos_;
+        // Linear iterations used by the last call to solve().
+        int linear_iterations_;
+        // Number of step halvings in the last solve().
+        int backtracks_;
     };
 
 } // namespace Opm
@@ -147,6 +147,31 @@ namespace Opm
 
 
 
+    std::size_t IncompTpfa::memoryUsage() const
+    {
+        return Opm::memoryUsage(htrans_) + Opm::memoryUsage(gpress_)
+            + Opm::memoryUsage(allcells_) + Opm::memoryUsage(trans_)
+            + Opm::memoryUsage(wdp_) + Opm::memoryUsage(totmob_)
+            + Opm::memoryUsage(omega_) + Opm::memoryUsage(gpress_omegaweighted_)
+            + Opm::memoryUsage(initial_porevol_) + Opm::memoryUsage(porevol_)
+            + Opm::memoryUsage(rock_comp_) + Opm::memoryUsage(pressures_)
+            + ifs_tpfa_memory_usage(h_);
+    }
+
+
+
+
+    void IncompTpfa::setParallelInformation(const boost::any& parallel_info)
+    {
+        if (wells_ != 0 && !parallel_info.empty()) {
+            OPM_THROW(std::runtime_error, "IncompTpfa does not support wells in parallel runs.");
+        }
+        parallel_info_ = parallel_info;
+    }
+
+
+
+
     /// Solve the pressure equation. If there is no pressure
     /// dependency introduced by rock compressibility effects,
     /// the equation is linear, and it is solved directly.
@@ -183,7 +208,7 @@ namespace Opm
         }
 
         // Solve.
-        linsolver_.solve(h_->A, h_->b, h_->x);
+        linsolver_.solve(h_->A, h_->b, h_->x, parallel_info_);
 
         // Obtain solution.
         assert(int(state.pressure().size()) == grid_.number_of_cells);
@@ -420,7 +445,7 @@ namespace Opm
     {
         // Increment is equal to -J^{-1}R.
         // The Jacobian is in h_->A, residual in h_->b.
-        linsolver_.solve(h_->A, h_->b, h_->x);
+        linsolver_.solve(h_->A, h_->b, h_->x, parallel_info_);
         // It is not necessary to negate the increment,
         // apparently the system for the increment is generated,
         // not the Jacobian and residual as such.
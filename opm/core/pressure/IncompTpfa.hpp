@@ -22,6 +22,8 @@
 
 
 #include <opm/core/pressure/tpfa/ifs_tpfa.h>
+#include <opm/core/utility/MemoryUsage.hpp>
+#include <boost/any.hpp>
 #include <vector>
 
 struct UnstructuredGrid;
@@ -44,7 +46,7 @@ namespace Opm
     /// iterations are handled.
     /// Below we use the shortcuts D for the number of dimensions, N
     /// for the number of cells and F for the number of faces.
-    class IncompTpfa
+    class IncompTpfa : public MemoryUsageInterface
     {
     public:
 	/// Construct solver for incompressible case.
@@ -116,9 +118,23 @@ namespace Opm
                    WellState& well_state);
 
 
+        /// Set the parallel information passed on to the linear
+        /// solver, such as a ParallelISTLInformation set up for a
+        /// SubdomainGrid by buildParallelInformation(). In that case
+        /// the grid given in the constructor must be the subdomain
+        /// grid, and the pressure in ghost cells is updated by the
+        /// linear solver. Wells are not supported in parallel runs,
+        /// and nonlinear convergence checks (with rock
+        /// compressibility) use local norms only.
+        void setParallelInformation(const boost::any& parallel_info);
+
         /// Expose read-only reference to internal half-transmissibility.
         const std::vector<double>& getHalfTrans() const { return htrans_; }
 
+        /// Number of bytes owned by the solver, including the
+        /// assembled linear system.
+        virtual std::size_t memoryUsage() const;
+
     protected:
         // Solve with no rock compressibility (linear eqn).
         void solveIncomp(const double dt,
@@ -159,6 +175,7 @@ namespace Opm
         const Wells* wells_;    // May be NULL, outside may modify controls (only) between calls to solve().
         const std::vector<double>& src_;
         const FlowBoundaryConditions* bcs_;
+        boost::any parallel_info_;
 	std::vector<double> htrans_;
 	std::vector<double> gpress_;
         std::vector<int> allcells_;
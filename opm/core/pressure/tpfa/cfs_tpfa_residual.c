@@ -27,6 +27,8 @@
 
 struct densrat_util {
     MAT_SIZE_T *ipiv;
+    size_t      np;
+    size_t      alloc_sz;
 
     double      residual;
     double     *lu;
@@ -58,6 +60,7 @@ struct cfs_tpfa_res_impl {
 
     /* Linear storage */
     double *ddata;
+    size_t  ddata_sz;
 };
 
 
@@ -99,6 +102,9 @@ allocate_densrat(size_t max_conn, int np)
         ratio->ipiv = malloc(np       * sizeof *ratio->ipiv);
         ratio->lu   = malloc(alloc_sz * sizeof *ratio->lu  );
 
+        ratio->np       = np;
+        ratio->alloc_sz = alloc_sz;
+
         if ((ratio->ipiv == NULL) || (ratio->lu == NULL)) {
             deallocate_densrat(ratio);
             ratio = NULL;
@@ -168,8 +174,9 @@ impl_allocate(struct UnstructuredGrid   *G       ,
     new = malloc(1 * sizeof *new);
 
     if (new != NULL) {
-        new->ddata = malloc(ddata_sz * sizeof *new->ddata);
-        new->ratio = allocate_densrat(max_conn, np);
+        new->ddata    = malloc(ddata_sz * sizeof *new->ddata);
+        new->ddata_sz = ddata_sz;
+        new->ratio    = allocate_densrat(max_conn, np);
 
         if (new->ddata == NULL || new->ratio == NULL) {
             impl_deallocate(new);
@@ -1162,6 +1169,38 @@ cfs_tpfa_res_destroy(struct cfs_tpfa_res_data *h)
 }
 
 
+/* ---------------------------------------------------------------------- */
+size_t
+cfs_tpfa_res_memory_usage(const struct cfs_tpfa_res_data *h)
+/* ---------------------------------------------------------------------- */
+{
+    size_t nbytes;
+
+    const struct densrat_util *ratio;
+
+    nbytes = 0;
+
+    if (h != NULL) {
+        nbytes += sizeof *h;
+        nbytes += csrmatrix_memory_usage(h->J);
+
+        if (h->pimpl != NULL) {
+            nbytes += sizeof *h->pimpl;
+            nbytes += h->pimpl->ddata_sz * sizeof *h->pimpl->ddata;
+
+            ratio = h->pimpl->ratio;
+            if (ratio != NULL) {
+                nbytes += sizeof *ratio;
+                nbytes += ratio->np       * sizeof *ratio->ipiv;
+                nbytes += ratio->alloc_sz * sizeof *ratio->lu;
+            }
+        }
+    }
+
+    return nbytes;
+}
+
+
 /* ---------------------------------------------------------------------- */
 struct cfs_tpfa_res_data *
 cfs_tpfa_res_construct(struct UnstructuredGrid   *G      ,
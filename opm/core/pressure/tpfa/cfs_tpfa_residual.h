@@ -143,6 +143,19 @@ void
 cfs_tpfa_res_destroy(struct cfs_tpfa_res_data *h);
 
 
+/**
+ * Compute number of bytes of dynamically allocated storage held by an
+ * assembler, including the Jacobian matrix.
+ *
+ * @param[in] h Assembler obtained from cfs_tpfa_res_construct().
+ *              May be @c NULL.
+ *
+ * @return Total storage in bytes.  Zero if <CODE>h == NULL</CODE>.
+ */
+size_t
+cfs_tpfa_res_memory_usage(const struct cfs_tpfa_res_data *h);
+
+
 /**
  * Assemble system of linear equations by linearising the residual around the
  * current pressure point.  Assume incompressible rock (i.e., that the
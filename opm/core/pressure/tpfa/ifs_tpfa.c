@@ -39,6 +39,7 @@ struct ifs_tpfa_impl {
 
     /* Linear storage */
     double *ddata;
+    size_t  ddata_sz;
 };
 
 
@@ -78,7 +79,8 @@ impl_allocate(struct UnstructuredGrid *G,
     new = malloc(1 * sizeof *new);
 
     if (new != NULL) {
-        new->ddata = malloc(ddata_sz * sizeof *new->ddata);
+        new->ddata    = malloc(ddata_sz * sizeof *new->ddata);
+        new->ddata_sz = ddata_sz;
 
         if (new->ddata == NULL) {
             impl_deallocate(new);
@@ -861,6 +863,29 @@ ifs_tpfa_press_flux(struct UnstructuredGrid      *G    ,
 }
 
 
+/* ---------------------------------------------------------------------- */
+size_t
+ifs_tpfa_memory_usage(const struct ifs_tpfa_data *h)
+/* ---------------------------------------------------------------------- */
+{
+    size_t nbytes;
+
+    nbytes = 0;
+
+    if (h != NULL) {
+        nbytes += sizeof *h;
+        nbytes += csrmatrix_memory_usage(h->A);
+
+        if (h->pimpl != NULL) {
+            nbytes += sizeof *h->pimpl;
+            nbytes += h->pimpl->ddata_sz * sizeof *h->pimpl->ddata;
+        }
+    }
+
+    return nbytes;
+}
+
+
 /* ---------------------------------------------------------------------- */
 void
 ifs_tpfa_destroy(struct ifs_tpfa_data *h)
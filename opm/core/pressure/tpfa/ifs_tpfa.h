@@ -141,6 +141,16 @@ ifs_tpfa_press_flux(struct UnstructuredGrid      *G    ,
 void
 ifs_tpfa_destroy(struct ifs_tpfa_data *h);
 
+/**
+ * Compute number of bytes of dynamically allocated storage held by a TPFA
+ * management structure, including the coefficient matrix.
+ *
+ * @param[in] h TPFA management structure.  May be @c NULL.
+ * @return Total storage in bytes.  Zero if <CODE>h == NULL</CODE>.
+ */
+size_t
+ifs_tpfa_memory_usage(const struct ifs_tpfa_data *h);
+
 #ifdef __cplusplus
 }
 #endif
@@ -28,6 +28,113 @@
 namespace Opm
 {
 
+    namespace
+    {
+        // Computes A = RB^{-1} and, if dAdp is non-null, its pressure
+        // derivative for n data points, see matrix() for the formulas.
+        struct FormationMatrixKernel
+        {
+            int n;
+            int np;
+            bool oil_and_gas;
+            int o;
+            int g;
+            const double* B;
+            const double* R;
+            const double* dB;
+            const double* dR;
+            double* A;
+            double* dAdp;
+
+            template <PhaseConfiguration Config>
+            void apply() const
+            {
+                typedef PhaseTraits<Config> Traits;
+                const int np = Traits::numPhases(this->np);
+                const bool oil_and_gas = Traits::NumPhases > 0 ? Traits::Gas >= 0 : this->oil_and_gas;
+                const int o = Traits::NumPhases > 0 ? Traits::Oil : this->o;
+                const int g = Traits::NumPhases > 0 ? Traits::Gas : this->g;
+
+                // Compute A matrix
+                for (int i = 0; i < n; ++i) {
+                    double* m = A + i*np*np;
+                    std::fill(m, m + np*np, 0.0);
+                    // Diagonal entries.
+                    for (int phase = 0; phase < np; ++phase) {
+                        m[phase + phase*np] = 1.0/B[i*np + phase];
+                    }
+                    // Off-diagonal entries.
+                    if (oil_and_gas) {
+                        m[o + g*np] = R[i*np + g]/B[i*np + g];
+                        m[g + o*np] = R[i*np + o]/B[i*np + o];
+                    }
+                }
+
+                if (dAdp) {
+                    for (int i = 0; i < n; ++i) {
+                        const double* a  = A + i*np*np;
+                        double*       m  = dAdp + i*np*np;
+
+                        // (1), (2): dA/dp <- -A*(dB/dp)
+                        const double* dBi = dB + i*np;
+                        for (int col = 0; col < np; ++col) {
+                            for (int row = 0; row < np; ++row) {
+                                m[col*np + row] = -a[col*np + row]*dBi[col]; // Note sign.
+                            }
+                        }
+
+                        if (oil_and_gas) {
+                            // (2b): dA/dp += dR/dp (== dR/dp - A*(dB/dp))
+                            const double* dRi = dR + i*np;
+
+                            m[o*np + g] += dRi[ o ];
+                            m[g*np + o] += dRi[ g ];
+                        }
+
+                        // (3): dA/dp *= inv(B) (== final result)
+                        const double* Bi = B + i*np;
+                        for (int col = 0; col < np; ++col) {
+                            for (int row = 0; row < np; ++row) {
+                                m[col*np + row] /= Bi[ col ];
+                            }
+                        }
+                    }
+                }
+            }
+        };
+
+        // Computes the phase densities rho = A^T rho_surface for n
+        // data points.
+        struct DensityKernel
+        {
+            int n;
+            int np;
+            const double* A;
+            const int* cells;
+            const int* pvtTableIdx;
+            const BlackoilPvtProperties* pvt;
+            double* rho;
+
+            template <PhaseConfiguration Config>
+            void apply() const
+            {
+                const int np = PhaseTraits<Config>::numPhases(this->np);
+                for (int i = 0; i < n; ++i) {
+                    const int cellIdx = cells ? cells[i] : i;
+                    const int pvtRegionIdx = pvtTableIdx ? pvtTableIdx[cellIdx] : 0;
+                    const double* sdens = pvt->surfaceDensities(pvtRegionIdx);
+                    for (int phase = 0; phase < np; ++phase) {
+                        double r = 0.0;
+                        for (int comp = 0; comp < np; ++comp) {
+                            r += A[i*np*np + np*phase + comp]*sdens[comp];
+                        }
+                        rho[np*i + phase] = r;
+                    }
+                }
+            }
+        };
+    } // anonymous namespace
+
     BlackoilPropertiesFromDeck::BlackoilPropertiesFromDeck(Opm::DeckConstPtr deck,
                                                            Opm::EclipseStateConstPtr eclState,
                                                            const UnstructuredGrid& grid,
@@ -134,6 +241,7 @@ namespace Opm
            rock_.init(eclState, number_of_cells, global_cell, cart_dims);
         }
         pvt_.init(deck, eclState, /*numSamples=*/0);
+        phase_config_ = phaseConfiguration(pvt_.phaseUsage());
         SaturationPropsFromDeck* ptr
             = new SaturationPropsFromDeck();
         ptr->init(phaseUsageFromDeck(deck), materialLawManager);
@@ -164,6 +272,7 @@ namespace Opm
 
         const int pvt_samples = param.getDefault("pvt_tab_size", -1);
         pvt_.init(deck, eclState, pvt_samples);
+        phase_config_ = phaseConfiguration(pvt_.phaseUsage());
 
         // Unfortunate lack of pointer smartness here...
         std::string threephase_model = param.getDefault<std::string>("threephase_model", "gwseg");
@@ -295,26 +404,8 @@ namespace Opm
             pvt_.R(n, &pvtTableIdx[0], p, z, &R_[0]);
         }
         const int* phase_pos = pvt_.phasePosition();
-        bool oil_and_gas = pvt_.phaseUsed()[BlackoilPhases::Liquid] &&
+        const bool oil_and_gas = pvt_.phaseUsed()[BlackoilPhases::Liquid] &&
             pvt_.phaseUsed()[BlackoilPhases::Vapour];
-        const int o = phase_pos[BlackoilPhases::Liquid];
-        const int g = phase_pos[BlackoilPhases::Vapour];
-
-        // Compute A matrix
-// #pragma omp parallel for
-        for (int i = 0; i < n; ++i) {
-            double* m = A + i*np*np;
-            std::fill(m, m + np*np, 0.0);
-            // Diagonal entries.
-            for (int phase = 0; phase < np; ++phase) {
-                m[phase + phase*np] = 1.0/B_[i*np + phase];
-            }
-            // Off-diagonal entries.
-            if (oil_and_gas) {
-                m[o + g*np] = R_[i*np + g]/B_[i*np + g];
-                m[g + o*np] = R_[i*np + o]/B_[i*np + o];
-            }
-        }
 
         // Derivative of A matrix.
         // A     = R*inv(B) whence
@@ -324,40 +415,14 @@ namespace Opm
         //       = (dR/dp - A*(dB/dp)) * inv(B)
         //
         // The B matrix is diagonal and that fact is exploited in the
-        // following implementation.
-        if (dAdp) {
-// #pragma omp parallel for
-            // (1): dA/dp <- A
-            std::copy(A, A + n*np*np, dAdp);
-
-            for (int i = 0; i < n; ++i) {
-                double*       m  = dAdp + i*np*np;
-
-                // (2): dA/dp <- -dA/dp*(dB/dp) == -A*(dB/dp)
-                const double* dB = & dB_[i * np];
-                for (int col = 0; col < np; ++col) {
-                    for (int row = 0; row < np; ++row) {
-                        m[col*np + row] *= - dB[ col ]; // Note sign.
-                    }
-                }
-
-                if (oil_and_gas) {
-                    // (2b): dA/dp += dR/dp (== dR/dp - A*(dB/dp))
-                    const double* dR = & dR_[i * np];
-
-                    m[o*np + g] += dR[ o ];
-                    m[g*np + o] += dR[ g ];
-                }
-
-                // (3): dA/dp *= inv(B) (== final result)
-                const double* B = & B_[i * np];
-                for (int col = 0; col < np; ++col) {
-                    for (int row = 0; row < np; ++row) {
-                        m[col*np + row] /= B[ col ];
-                    }
-                }
-            }
-        }
+        // kernel, which is specialised for the active phases.
+        const FormationMatrixKernel kernel = {
+            n, np, oil_and_gas,
+            phase_pos[BlackoilPhases::Liquid], phase_pos[BlackoilPhases::Vapour],
+            &B_[0], &R_[0], dAdp ? &dB_[0] : 0, dAdp ? &dR_[0] : 0,
+            A, dAdp
+        };
+        dispatchPhaseConfiguration(phase_config_, kernel);
     }
 
     /// \param[in]  n      Number of data points.
@@ -372,19 +437,10 @@ namespace Opm
                                              const int* cells,
                                              double* rho) const
     {
-        const int np = numPhases();
-// #pragma omp parallel for
-        for (int i = 0; i < n; ++i) {
-            int cellIdx = cells?cells[i]:i;
-            int pvtRegionIdx = getTableIndex_(cellPvtRegionIndex(), cellIdx);
-            const double* sdens = pvt_.surfaceDensities(pvtRegionIdx);
-            for (int phase = 0; phase < np; ++phase) {
-                rho[np*i + phase] = 0.0;
-                for (int comp = 0; comp < np; ++comp) {
-                    rho[np*i + phase] += A[i*np*np + np*phase + comp]*sdens[comp];
-                }
-            }
-        }
+        const DensityKernel kernel = {
+            n, numPhases(), A, cells, cellPvtRegionIndex(), &pvt_, rho
+        };
+        dispatchPhaseConfiguration(phase_config_, kernel);
     }
 
     /// Densities of stock components at surface conditions.
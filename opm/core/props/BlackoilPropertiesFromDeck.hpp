@@ -22,6 +22,7 @@
 
 
 #include <opm/core/props/BlackoilPropertiesInterface.hpp>
+#include <opm/core/props/PhaseConfiguration.hpp>
 #include <opm/core/props/rock/RockFromDeck.hpp>
 #include <opm/core/props/pvt/BlackoilPvtProperties.hpp>
 #include <opm/core/props/satfunc/SaturationPropsFromDeck.hpp>
@@ -267,6 +268,7 @@ namespace Opm
         RockFromDeck rock_;
         std::vector<int> cellPvtRegionIdx_;
         BlackoilPvtProperties pvt_;
+        PhaseConfiguration phase_config_;
         std::shared_ptr<MaterialLawManager> materialLawManager_;
         std::shared_ptr<SaturationPropsInterface> satprops_;
         mutable std::vector<double> B_;
@@ -0,0 +1,131 @@
+/*
+  Copyright 2015 SINTEF ICT, Applied Mathematics.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OPM_PHASECONFIGURATION_HEADER_INCLUDED
+#define OPM_PHASECONFIGURATION_HEADER_INCLUDED
+
+#include <opm/core/props/BlackoilPhases.hpp>
+
+namespace Opm
+{
+
+    /// Phase sets for which the property and pressure kernels are
+    /// specialised at compile time.  With the number and positions
+    /// of the phases known to the compiler the per-cell loops over
+    /// phases are fully unrolled.  Any other set of phases uses the
+    /// generic kernels, which take the number of phases at run time.
+    enum PhaseConfiguration {
+        GenericPhases,
+        WaterOilPhases,
+        OilGasPhases,
+        WaterOilGasPhases
+    };
+
+
+    /// Classify a set of active phases, typically the result of
+    /// phaseUsageFromDeck().
+    inline PhaseConfiguration phaseConfiguration(const PhaseUsage& pu)
+    {
+        const bool water = pu.phase_used[BlackoilPhases::Aqua];
+        const bool oil = pu.phase_used[BlackoilPhases::Liquid];
+        const bool gas = pu.phase_used[BlackoilPhases::Vapour];
+        if (water && oil && gas) {
+            return WaterOilGasPhases;
+        } else if (water && oil && !gas) {
+            return WaterOilPhases;
+        } else if (!water && oil && gas) {
+            return OilGasPhases;
+        }
+        return GenericPhases;
+    }
+
+
+    /// Compile-time description of a phase configuration.  The
+    /// phases are always stored in the order aqua, liquid, vapour,
+    /// skipping unused phases, as in PhaseUsage::phase_pos.
+    template <PhaseConfiguration Config>
+    struct PhaseTraits
+    {
+        /// Number of phases, zero if only known at run time.
+        static const int NumPhases = 0;
+        /// Positions of the oil and gas phases, -1 if unused or unknown.
+        static const int Oil = -1;
+        static const int Gas = -1;
+
+        /// The number of phases, given the run-time value np.
+        static int numPhases(const int np) { return np; }
+    };
+
+    template <>
+    struct PhaseTraits<WaterOilPhases>
+    {
+        static const int NumPhases = 2;
+        static const int Oil = 1;
+        static const int Gas = -1;
+        static int numPhases(const int) { return NumPhases; }
+    };
+
+    template <>
+    struct PhaseTraits<OilGasPhases>
+    {
+        static const int NumPhases = 2;
+        static const int Oil = 0;
+        static const int Gas = 1;
+        static int numPhases(const int) { return NumPhases; }
+    };
+
+    template <>
+    struct PhaseTraits<WaterOilGasPhases>
+    {
+        static const int NumPhases = 3;
+        static const int Oil = 1;
+        static const int Gas = 2;
+        static int numPhases(const int) { return NumPhases; }
+    };
+
+
+    /// Run a kernel specialised for a phase configuration.  The
+    /// kernel must provide a member function template
+    ///     template <PhaseConfiguration Config> void apply() const;
+    /// which is instantiated for every configuration, so the choice
+    /// made at setup costs a single switch per call rather than one
+    /// per cell.
+    template <class Kernel>
+    void dispatchPhaseConfiguration(const PhaseConfiguration config,
+                                    const Kernel& kernel)
+    {
+        switch (config) {
+        case WaterOilPhases:
+            kernel.template apply<WaterOilPhases>();
+            break;
+        case OilGasPhases:
+            kernel.template apply<OilGasPhases>();
+            break;
+        case WaterOilGasPhases:
+            kernel.template apply<WaterOilGasPhases>();
+            break;
+        default:
+            kernel.template apply<GenericPhases>();
+            break;
+        }
+    }
+
+} // namespace Opm
+
+#endif // OPM_PHASECONFIGURATION_HEADER_INCLUDED
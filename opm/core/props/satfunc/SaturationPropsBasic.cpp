@@ -30,13 +30,15 @@ namespace Opm
 
     namespace {
 
+        // The relperm functions are closed-form and branch-free, so
+        // that the loops below vectorise.
         struct KrFunConstant
         {
-            double kr(double)
+            static double kr(double)
             {
                 return 1.0;
             }
-            double dkrds(double)
+            static double dkrds(double)
             {
                 return 0.0;
             }
@@ -44,11 +46,11 @@ namespace Opm
 
         struct KrFunLinear
         {
-            double kr(double s)
+            static double kr(double s)
             {
                 return s;
             }
-            double dkrds(double)
+            static double dkrds(double)
             {
                 return 1.0;
             }
@@ -56,40 +58,70 @@ namespace Opm
 
         struct KrFunQuadratic
         {
-            double kr(double s)
+            static double kr(double s)
             {
                 return s*s;
             }
-            double dkrds(double s)
+            static double dkrds(double s)
             {
                 return 2.0*s;
             }
         };
 
 
-        template <class Fun>
-        static inline void evalAllKrDeriv(const int n, const int np,
-                                          const double* s, double* kr, double* dkrds, Fun fun)
+        // Evaluate kr and, if dkrds is non-null, the derivative matrices
+        // of n data points with NP phases.  NP == 0 means that the number
+        // of phases is np, known only at run time.  The output arrays
+        // must not overlap s.
+        template <int NP, class Fun>
+        static inline void evalKrDerivKernel(const int n, const int np_runtime,
+                                          const double* s, double* kr, double* dkrds)
         {
+            const int np = NP > 0 ? NP : np_runtime;
+            const int nvals = n*np;
             if (dkrds == 0) {
-// #pragma omp parallel for
-                for (int i = 0; i < n*np; ++i) {
-                    kr[i] = fun.kr(s[i]);
+#if defined(_OPENMP) && _OPENMP >= 201307
+#pragma omp simd
+#endif
+                for (int i = 0; i < nvals; ++i) {
+                    kr[i] = Fun::kr(s[i]);
                 }
                 return;
             }
-// #pragma omp parallel for
+#if defined(_OPENMP) && _OPENMP >= 201307
+#pragma omp simd
+#endif
             for (int i = 0; i < n; ++i) {
-                std::fill(dkrds + i*np*np, dkrds + (i+1)*np*np, 0.0);
                 for (int phase = 0; phase < np; ++phase) {
-                    kr[i*np + phase] = fun.kr(s[i*np + phase]);
+                    const double si = s[i*np + phase];
+                    kr[i*np + phase] = Fun::kr(si);
                     // Only diagonal elements in derivative.
-                    dkrds[i*np*np + phase*np + phase] = fun.dkrds(s[i*np + phase]);
+                    for (int col = 0; col < np; ++col) {
+                        dkrds[i*np*np + col*np + phase] = (col == phase) ? Fun::dkrds(si) : 0.0;
+                    }
                 }
             }
         }
 
 
+        template <class Fun>
+        static inline void evalAllKrDeriv(const int n, const int np,
+                                          const double* s, double* kr, double* dkrds)
+        {
+            switch (np) {
+            case 1:
+                evalKrDerivKernel<1, Fun>(n, np, s, kr, dkrds);
+                break;
+            case 2:
+                evalKrDerivKernel<2, Fun>(n, np, s, kr, dkrds);
+                break;
+            default:
+                evalKrDerivKernel<0, Fun>(n, np, s, kr, dkrds);
+                break;
+            }
+        }
+
+
     } // anon namespace
 
 
@@ -160,17 +192,17 @@ namespace Opm
         switch (relperm_func_) {
         case Constant:
             {
-                evalAllKrDeriv(n, num_phases_, s, kr, dkrds, KrFunConstant());
+                evalAllKrDeriv<KrFunConstant>(n, num_phases_, s, kr, dkrds);
                 break;
             }
         case Linear:
             {
-                evalAllKrDeriv(n, num_phases_, s, kr, dkrds, KrFunLinear());
+                evalAllKrDeriv<KrFunLinear>(n, num_phases_, s, kr, dkrds);
                 break;
             }
         case Quadratic:
             {
-                evalAllKrDeriv(n, num_phases_, s, kr, dkrds, KrFunQuadratic());
+                evalAllKrDeriv<KrFunQuadratic>(n, num_phases_, s, kr, dkrds);
                 break;
             }
         default:
@@ -37,13 +37,128 @@
 namespace Opm
 {
 
+    typedef SaturationPropsFromDeck::MaterialLawManager MaterialLawManager;
     typedef SaturationPropsFromDeck::MaterialLawManager::MaterialLaw MaterialLaw;
 
+    namespace
+    {
+        // Evaluates the relative permeabilities, and their saturation
+        // derivatives if dkrds is non-null, of n data points.
+        struct RelpermKernel
+        {
+            int n;
+            const double* s;
+            const int* cells;
+            double* kr;
+            double* dkrds;
+            const PhaseUsage& phaseUsage;
+            const MaterialLawManager& materialLawManager;
+
+            template <PhaseConfiguration Config>
+            void apply() const
+            {
+                const int np = PhaseTraits<Config>::numPhases(phaseUsage.num_phases);
+                if (dkrds) {
+                    ExplicitArraysSatDerivativesFluidState fluidState(phaseUsage);
+                    fluidState.setSaturationArray(s);
+
+                    typedef ExplicitArraysSatDerivativesFluidState::Evaluation Evaluation;
+                    Evaluation relativePerms[BlackoilPhases::MaxNumPhases];
+                    for (int i = 0; i < n; ++i) {
+                        fluidState.setIndex(i);
+                        const auto& params = materialLawManager.materialLawParams(cells[i]);
+                        MaterialLaw::relativePermeabilities(relativePerms, params, fluidState);
+
+                        // copy the values calculated using opm-material to the target arrays
+                        for (int krPhaseIdx = 0; krPhaseIdx < np; ++krPhaseIdx) {
+                            kr[np*i + krPhaseIdx] = relativePerms[krPhaseIdx].value;
+
+                            for (int satPhaseIdx = 0; satPhaseIdx < np; ++satPhaseIdx)
+                                dkrds[np*np*i + satPhaseIdx*np + krPhaseIdx] = relativePerms[krPhaseIdx].derivatives[satPhaseIdx];
+                        }
+                    }
+                } else {
+                    ExplicitArraysFluidState fluidState(phaseUsage);
+                    fluidState.setSaturationArray(s);
+
+                    double relativePerms[BlackoilPhases::MaxNumPhases];
+                    for (int i = 0; i < n; ++i) {
+                        fluidState.setIndex(i);
+                        const auto& params = materialLawManager.materialLawParams(cells[i]);
+                        MaterialLaw::relativePermeabilities(relativePerms, params, fluidState);
+
+                        // copy the values calculated using opm-material to the target arrays
+                        for (int krPhaseIdx = 0; krPhaseIdx < np; ++krPhaseIdx) {
+                            kr[np*i + krPhaseIdx] = relativePerms[krPhaseIdx];
+                        }
+                    }
+                }
+            }
+        };
+
+        // Evaluates the capillary pressures, and their saturation
+        // derivatives if dpcds is non-null, of n data points.
+        struct CapPressKernel
+        {
+            int n;
+            const double* s;
+            const int* cells;
+            double* pc;
+            double* dpcds;
+            const PhaseUsage& phaseUsage;
+            const MaterialLawManager& materialLawManager;
+
+            template <PhaseConfiguration Config>
+            void apply() const
+            {
+                const int np = PhaseTraits<Config>::numPhases(phaseUsage.num_phases);
+                if (dpcds) {
+                    ExplicitArraysSatDerivativesFluidState fluidState(phaseUsage);
+                    typedef ExplicitArraysSatDerivativesFluidState::Evaluation Evaluation;
+                    fluidState.setSaturationArray(s);
+
+                    Evaluation capillaryPressures[BlackoilPhases::MaxNumPhases];
+                    for (int i = 0; i < n; ++i) {
+                        fluidState.setIndex(i);
+                        const auto& params = materialLawManager.materialLawParams(cells[i]);
+                        MaterialLaw::capillaryPressures(capillaryPressures, params, fluidState);
+
+                        // copy the values calculated using opm-material to the target arrays
+                        for (int pcPhaseIdx = 0; pcPhaseIdx < np; ++pcPhaseIdx) {
+                            double sign = (pcPhaseIdx == BlackoilPhases::Aqua)? -1.0 : 1.0;
+                            pc[np*i + pcPhaseIdx] = sign*capillaryPressures[pcPhaseIdx].value;
+
+                            for (int satPhaseIdx = 0; satPhaseIdx < np; ++satPhaseIdx)
+                                dpcds[np*np*i + satPhaseIdx*np + pcPhaseIdx] = sign*capillaryPressures[pcPhaseIdx].derivatives[satPhaseIdx];
+                        }
+                    }
+                } else {
+                    ExplicitArraysFluidState fluidState(phaseUsage);
+                    fluidState.setSaturationArray(s);
+
+                    double capillaryPressures[BlackoilPhases::MaxNumPhases];
+                    for (int i = 0; i < n; ++i) {
+                        fluidState.setIndex(i);
+                        const auto& params = materialLawManager.materialLawParams(cells[i]);
+                        MaterialLaw::capillaryPressures(capillaryPressures, params, fluidState);
+
+                        // copy the values calculated using opm-material to the target arrays
+                        for (int pcPhaseIdx = 0; pcPhaseIdx < np; ++pcPhaseIdx) {
+                            double sign = (pcPhaseIdx == BlackoilPhases::Aqua)? -1.0 : 1.0;
+                            pc[np*i + pcPhaseIdx] = sign*capillaryPressures[pcPhaseIdx];
+                        }
+                    }
+                }
+            }
+        };
+    } // anonymous namespace
+
     // ----------- Methods of SaturationPropsFromDeck ---------
 
 
     /// Default constructor.
     SaturationPropsFromDeck::SaturationPropsFromDeck()
+        : phase_config_(GenericPhases)
     {
     }
 
@@ -52,6 +167,7 @@ namespace Opm
                                        std::shared_ptr<MaterialLawManager> materialLawManager)
     {
         phaseUsage_ = phaseUsage;
+        phase_config_ = phaseConfiguration(phaseUsage);
         materialLawManager_ = materialLawManager;
     }
 
@@ -82,42 +198,10 @@ namespace Opm
     {
         assert(cells != 0);
 
-        const int np = numPhases();
-        if (dkrds) {
-            ExplicitArraysSatDerivativesFluidState fluidState(phaseUsage_);
-            fluidState.setSaturationArray(s);
-
-            typedef ExplicitArraysSatDerivativesFluidState::Evaluation Evaluation;
-            Evaluation relativePerms[BlackoilPhases::MaxNumPhases];
-            for (int i = 0; i < n; ++i) {
-                fluidState.setIndex(i);
-                const auto& params = materialLawManager_->materialLawParams(cells[i]);
-                MaterialLaw::relativePermeabilities(relativePerms, params, fluidState);
-
-                // copy the values calculated using opm-material to the target arrays
-                for (int krPhaseIdx = 0; krPhaseIdx < np; ++krPhaseIdx) {
-                    kr[np*i + krPhaseIdx] = relativePerms[krPhaseIdx].value;
-
-                    for (int satPhaseIdx = 0; satPhaseIdx < np; ++satPhaseIdx)
-                        dkrds[np*np*i + satPhaseIdx*np + krPhaseIdx] = relativePerms[krPhaseIdx].derivatives[satPhaseIdx];
-                }
-            }
-        } else {
-            ExplicitArraysFluidState fluidState(phaseUsage_);
-            fluidState.setSaturationArray(s);
-
-            double relativePerms[BlackoilPhases::MaxNumPhases];
-            for (int i = 0; i < n; ++i) {
-                fluidState.setIndex(i);
-                const auto& params = materialLawManager_->materialLawParams(cells[i]);
-                MaterialLaw::relativePermeabilities(relativePerms, params, fluidState);
-
-                // copy the values calculated using opm-material to the target arrays
-                for (int krPhaseIdx = 0; krPhaseIdx < np; ++krPhaseIdx) {
-                    kr[np*i + krPhaseIdx] = relativePerms[krPhaseIdx];
-                }
-            }
-        }
+        const RelpermKernel kernel = {
+            n, s, cells, kr, dkrds, phaseUsage_, *materialLawManager_
+        };
+        dispatchPhaseConfiguration(phase_config_, kernel);
     }
 
 
@@ -141,44 +225,10 @@ namespace Opm
     {
         assert(cells != 0);
 
-        const int np = numPhases();
-        if (dpcds) {
-            ExplicitArraysSatDerivativesFluidState fluidState(phaseUsage_);
-            typedef ExplicitArraysSatDerivativesFluidState::Evaluation Evaluation;
-            fluidState.setSaturationArray(s);
-
-            Evaluation capillaryPressures[BlackoilPhases::MaxNumPhases];
-            for (int i = 0; i < n; ++i) {
-                fluidState.setIndex(i);
-                const auto& params = materialLawManager_->materialLawParams(cells[i]);
-                MaterialLaw::capillaryPressures(capillaryPressures, params, fluidState);
-
-                // copy the values calculated using opm-material to the target arrays
-                for (int pcPhaseIdx = 0; pcPhaseIdx < np; ++pcPhaseIdx) {
-                    double sign = (pcPhaseIdx == BlackoilPhases::Aqua)? -1.0 : 1.0;
-                    pc[np*i + pcPhaseIdx] = sign*capillaryPressures[pcPhaseIdx].value;
-
-                    for (int satPhaseIdx = 0; satPhaseIdx < np; ++satPhaseIdx)
-                        dpcds[np*np*i + satPhaseIdx*np + pcPhaseIdx] = sign*capillaryPressures[pcPhaseIdx].derivatives[satPhaseIdx];
-                }
-            }
-        } else {
-            ExplicitArraysFluidState fluidState(phaseUsage_);
-            fluidState.setSaturationArray(s);
-
-            double capillaryPressures[BlackoilPhases::MaxNumPhases];
-            for (int i = 0; i < n; ++i) {         
-                fluidState.setIndex(i);
-                const auto& params = materialLawManager_->materialLawParams(cells[i]);
-                MaterialLaw::capillaryPressures(capillaryPressures, params, fluidState);
-
-                // copy the values calculated using opm-material to the target arrays
-                for (int pcPhaseIdx = 0; pcPhaseIdx < np; ++pcPhaseIdx) {
-                    double sign = (pcPhaseIdx == BlackoilPhases::Aqua)? -1.0 : 1.0;
-                    pc[np*i + pcPhaseIdx] = sign*capillaryPressures[pcPhaseIdx];
-                }
-            }
-        }
+        const CapPressKernel kernel = {
+            n, s, cells, pc, dpcds, phaseUsage_, *materialLawManager_
+        };
+        dispatchPhaseConfiguration(phase_config_, kernel);
     }
 
 
@@ -23,6 +23,7 @@
 #include <opm/core/props/satfunc/SaturationPropsInterface.hpp>
 #include <opm/core/utility/parameters/ParameterGroup.hpp>
 #include <opm/core/props/BlackoilPhases.hpp>
+#include <opm/core/props/PhaseConfiguration.hpp>
 #include <opm/core/props/phaseUsageFromDeck.hpp>
 #include <opm/core/grid.h>
 
@@ -136,6 +137,7 @@ namespace Opm
     private:
         std::shared_ptr<MaterialLawManager> materialLawManager_;
         PhaseUsage phaseUsage_;
+        PhaseConfiguration phase_config_;
     };
 
 
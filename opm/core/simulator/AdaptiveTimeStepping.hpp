@@ -89,6 +89,7 @@ namespace Opm {
         const bool timestep_verbose_;         //!< timestep verbosity
         double suggested_next_timestep_;      //!< suggested size of next timestep
         bool full_timestep_initially_;        //!< beginning with the size of the time step from data file
+        const bool fused_relative_change_;    //!< compute relative change in a single sweep over the states instead of asking the model
     };
 }
 
@@ -26,6 +26,8 @@
 #include <opm/core/simulator/SimulatorTimer.hpp>
 #include <opm/core/simulator/AdaptiveSimulatorTimer.hpp>
 #include <opm/core/simulator/TimeStepControl.hpp>
+#include <opm/core/simulator/RelativeChange.hpp>
+#include <opm/core/utility/StopWatch.hpp>
 #include <dune/istl/istlexception.hh>
 #include <dune/istl/ilu.hh> // For MatrixBlockException
 
@@ -54,6 +56,28 @@ namespace Opm {
                 return solver_.model().relativeChange( previous_, current_ );
             }
         };
+
+        template <class State>
+        class FusedRelativeChangeWrapper : public RelativeChangeInterface
+        {
+            const State&  previous_;
+            const State&  current_;
+        public:
+            FusedRelativeChangeWrapper( const State&  previous,
+                                        const State&  current )
+              : previous_( previous ),
+                current_( current )
+            {}
+
+            /// return the largest || u^n+1 - u^n || / || u^n+1 || of
+            /// pressure, saturations and Rs/Rv, computed in a single sweep
+            double relativeChange() const
+            {
+                FusedRelativeChange change;
+                change.compute( previous_, current_ );
+                return change.relativeChange();
+            }
+        };
     }
 
     // AdaptiveTimeStepping
@@ -72,8 +96,9 @@ namespace Opm {
         , timestep_verbose_( param.getDefault("timestep.verbose", bool(true) ) && terminal_output )
         , suggested_next_timestep_( -1.0 )
         , full_timestep_initially_( param.getDefault("full_timestep_initially", bool(false) ) )
+        , fused_relative_change_( param.getDefault("timestep.control.fused_relative_change", bool(false) ) )
     {
-        // valid are "pid" and "pid+iteration"
+        // valid are "pid", "pid+iteration", "iterationcount" and "throughput"
         std::string control = param.getDefault("timestep.control", std::string("pid") );
         // iterations is the accumulation of all linear iterations over all newton steops per time step
         const int defaultTargetIterations = 30;
@@ -94,6 +119,13 @@ namespace Opm {
             const double growthrate = param.getDefault("timestep.control.growthrate", double(1.25) );
             timeStepControl_ = TimeStepControlType( new SimpleIterationCountTimeStepControl( iterations, decayrate, growthrate ) );
         }
+        else if ( control == "throughput" )
+        {
+            // tol <= 0 means that the step size is chosen for throughput only
+            const double throughputTol = param.getDefault("timestep.control.throughput.tol", tol );
+            const int history = param.getDefault("timestep.control.throughput.history", int(20) );
+            timeStepControl_ = TimeStepControlType( new ThroughputTimeStepControl( throughputTol, history, max_growth_ ) );
+        }
         else
             OPM_THROW(std::runtime_error,"Unsupported time step control selected "<< control );
 
@@ -161,6 +193,8 @@ namespace Opm {
             }
 
             int linearIterations = -1;
+            time::StopWatch stepTimer;
+            stepTimer.start();
             try {
                 // (linearIterations < 0 means on convergence in solver)
                 linearIterations = solver.step( dt, state, well_state);
@@ -187,15 +221,24 @@ namespace Opm {
                 // this can be thrown by ISTL's ILU0 in block mode, yet is not an ISTLError
             }
 
+            // record the cost of the attempt, whether it converged or not
+            timeStepControl_->recordStepCost( dt, stepTimer.secsSinceStart(), linearIterations >= 0 );
+
             // (linearIterations < 0 means no convergence in solver)
             if( linearIterations >= 0 )
             {
                 // advance by current dt
                 ++substepTimer;
 
-                // create object to compute the time error, simply forwards the call to the model
+                // create object to compute the time error, either forwarding the call to the
+                // model or using the fused single-sweep computation on the states
                 detail::SolutionTimeErrorSolverWrapper< Solver, State >
-                    relativeChange( solver, last_state, state );
+                    modelRelativeChange( solver, last_state, state );
+                detail::FusedRelativeChangeWrapper< State >
+                    fusedRelativeChange( last_state, state );
+                const RelativeChangeInterface& relativeChange = fused_relative_change_
+                    ? static_cast< const RelativeChangeInterface& >( fusedRelativeChange )
+                    : static_cast< const RelativeChangeInterface& >( modelRelativeChange );
 
                 // compute new time step estimate
                 double dtEstimate =
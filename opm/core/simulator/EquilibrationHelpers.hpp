@@ -27,6 +27,7 @@
 #include <opm/core/utility/RootFinders.hpp>
 
 #include <memory>
+#include <vector>
 
 
 /*
@@ -62,6 +63,16 @@ namespace Opm
                                 const int cell,
                                 const double target_pc,
                                 const bool increasing = false);
+
+        struct PcEqBatch;
+
+        inline void satFromPc(const BlackoilPropertiesInterface& props,
+                              const int phase,
+                              const int n,
+                              const int* cells,
+                              const double* target_pc,
+                              double* sat,
+                              const bool increasing = false);
         struct PcEqSum
         inline double satFromSumOfPcs(const BlackoilPropertiesInterface& props,
                                       const int phase1,
@@ -790,6 +801,123 @@ namespace Opm
         }
 
 
+        /// Batch functor for inverting capillary pressure functions in
+        /// several cells at once, for use with RegulaFalsi::solveBatch().
+        /// Function represented for problem i is
+        ///   f_i(s) = pc(s, cells[i]) - target_pc[i]
+        /// Each evaluation makes a single capPress() call for all
+        /// problems requested.
+        struct PcEqBatch
+        {
+            PcEqBatch(const BlackoilPropertiesInterface& props,
+                      const int phase,
+                      const int* cells,
+                      const double* target_pc)
+                : props_(props),
+                  phase_(phase),
+                  cells_(cells),
+                  target_pc_(target_pc)
+            {
+            }
+            void operator()(const int num, const int* lanes,
+                            const double* s, double* fs) const
+            {
+                const int np = props_.numPhases();
+                s_.assign(num*np, 0.0);
+                pc_.resize(num*np);
+                cell_.resize(num);
+                for (int k = 0; k < num; ++k) {
+                    s_[k*np + phase_] = s[k];
+                    cell_[k] = cells_[lanes[k]];
+                }
+                props_.capPress(num, &s_[0], &cell_[0], &pc_[0], 0);
+                for (int k = 0; k < num; ++k) {
+                    fs[k] = pc_[k*np + phase_] - target_pc_[lanes[k]];
+                }
+            }
+        private:
+            const BlackoilPropertiesInterface& props_;
+            const int phase_;
+            const int* cells_;
+            const double* target_pc_;
+            mutable std::vector<double> s_;
+            mutable std::vector<double> pc_;
+            mutable std::vector<int> cell_;
+        };
+
+
+
+        /// Compute saturations of some phase corresponding to given
+        /// capillary pressures in n cells. Equivalent to calling the
+        /// single-cell satFromPc() for each cell, but evaluates the
+        /// capillary pressure for all unconverged cells in one call
+        /// per iteration.
+        inline void satFromPc(const BlackoilPropertiesInterface& props,
+                              const int phase,
+                              const int n,
+                              const int* cells,
+                              const double* target_pc,
+                              double* sat,
+                              const bool increasing = false)
+        {
+            if (n <= 0) {
+                return;
+            }
+            const int np = props.numPhases();
+
+            // Find minimum and maximum saturations.
+            std::vector<double> smin(n*np), smax(n*np);
+            props.satRange(n, cells, &smin[0], &smax[0]);
+            std::vector<double> s0(n), s1(n);
+            for (int i = 0; i < n; ++i) {
+                s0[i] = increasing ? smax[i*np + phase] : smin[i*np + phase];
+                s1[i] = increasing ? smin[i*np + phase] : smax[i*np + phase];
+            }
+
+            // Evaluate f(s) = pc(s) - target_pc at both ends.
+            std::vector<int> all(n);
+            for (int i = 0; i < n; ++i) {
+                all[i] = i;
+            }
+            const PcEqBatch f_all(props, phase, cells, target_pc);
+            std::vector<double> f0(n), f1(n);
+            f_all(n, &all[0], &s0[0], &f0[0]);
+            f_all(n, &all[0], &s1[0], &f1[0]);
+
+            // Collect the cells that need an iterative solve.
+            std::vector<int> solve_idx, solve_cells;
+            std::vector<double> solve_pc, a, b;
+            for (int i = 0; i < n; ++i) {
+                if (f0[i] <= 0.0) {
+                    sat[i] = s0[i];
+                } else if (f1[i] > 0.0) {
+                    sat[i] = s1[i];
+                } else {
+                    solve_idx.push_back(i);
+                    solve_cells.push_back(cells[i]);
+                    solve_pc.push_back(target_pc[i]);
+                    a.push_back(std::min(s0[i], s1[i]));
+                    b.push_back(std::max(s0[i], s1[i]));
+                }
+            }
+            if (solve_idx.empty()) {
+                return;
+            }
+
+            const int m = solve_idx.size();
+            const int max_iter = 30;
+            const double tol = 1e-6;
+            std::vector<double> sol(m);
+            std::vector<int> iter_used(m);
+            const PcEqBatch f(props, phase, &solve_cells[0], &solve_pc[0]);
+            typedef RegulaFalsi<ThrowOnError> ScalarSolver;
+            ScalarSolver::solveBatch(f, m, &a[0], &b[0], max_iter, tol, &sol[0], &iter_used[0]);
+            for (int j = 0; j < m; ++j) {
+                sat[solve_idx[j]] = sol[j];
+            }
+        }
+
+
         /// Functor for inverting a sum of capillary pressure functions.
         /// Function represented is
         ///   f(s) = pc1(s) + pc2(1 - s) - target_pc
@@ -0,0 +1,109 @@
+/*
+  Copyright 2015 SINTEF ICT, Applied Mathematics.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "config.h"
+#include <opm/core/simulator/PressureUpdatePolicy.hpp>
+#include <opm/core/props/IncompPropertiesInterface.hpp>
+#include <opm/core/props/rock/RockCompressibility.hpp>
+#include <opm/core/utility/miscUtilities.hpp>
+#include <opm/core/utility/MemoryUsage.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+namespace Opm
+{
+
+    PressureUpdatePolicy::PressureUpdatePolicy(const IncompPropertiesInterface& props,
+                                               const RockCompressibility* rock_comp_props,
+                                               const double* gravity,
+                                               const bool check_well_controls,
+                                               const double tolerance)
+        : props_(props),
+          enabled_(tolerance > 0.0 && !check_well_controls),
+          tolerance_(tolerance),
+          last_change_(0.0)
+    {
+        if (rock_comp_props && rock_comp_props->isActive()) {
+            enabled_ = false;
+        }
+        if (gravity) {
+            for (int dd = 0; dd < props.numDimensions(); ++dd) {
+                if (gravity[dd] != 0.0) {
+                    enabled_ = false;
+                }
+            }
+        }
+        if (enabled_) {
+            allcells_.resize(props.numCells());
+            for (int cell = 0; cell < props.numCells(); ++cell) {
+                allcells_[cell] = cell;
+            }
+        }
+    }
+
+
+
+    bool PressureUpdatePolicy::enabled() const
+    {
+        return enabled_;
+    }
+
+
+
+    bool PressureUpdatePolicy::pressureNeeded(const std::vector<double>& saturation)
+    {
+        last_change_ = 0.0;
+        if (!enabled_) {
+            return true;
+        }
+        computeTotalMobility(props_, allcells_, saturation, totmob_);
+        if (reference_totmob_.empty()) {
+            reference_totmob_ = totmob_;
+            return true;
+        }
+        const int num_cells = totmob_.size();
+        for (int cell = 0; cell < num_cells; ++cell) {
+            const double change = std::fabs(totmob_[cell] - reference_totmob_[cell])
+                / reference_totmob_[cell];
+            last_change_ = std::max(last_change_, change);
+        }
+        if (last_change_ < tolerance_) {
+            return false;
+        }
+        reference_totmob_.swap(totmob_);
+        return true;
+    }
+
+
+
+    double PressureUpdatePolicy::lastChange() const
+    {
+        return last_change_;
+    }
+
+
+
+    std::size_t PressureUpdatePolicy::memoryUsage() const
+    {
+        return Opm::memoryUsage(allcells_) + Opm::memoryUsage(reference_totmob_)
+            + Opm::memoryUsage(totmob_);
+    }
+
+} // namespace Opm
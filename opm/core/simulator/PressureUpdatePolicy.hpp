@@ -0,0 +1,86 @@
+/*
+  Copyright 2015 SINTEF ICT, Applied Mathematics.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OPM_PRESSUREUPDATEPOLICY_HEADER_INCLUDED
+#define OPM_PRESSUREUPDATEPOLICY_HEADER_INCLUDED
+
+#include <cstddef>
+#include <vector>
+
+namespace Opm
+{
+    class IncompPropertiesInterface;
+    class RockCompressibility;
+
+    /// Decides when the pressure of an incompressible two-phase
+    /// simulation must be solved again.
+    ///
+    /// Without gravity, compressible rock or well control switching,
+    /// the fluxes only change through the total mobility. While that
+    /// stays within a relative tolerance (per cell) of its value at the
+    /// last pressure solve, transport may continue on the old fluxes.
+    /// With gravity the fluxes also depend on the saturation through
+    /// the phase density weights of the cells and the well bores, so
+    /// the policy is disabled and every step solves pressure.
+    class PressureUpdatePolicy
+    {
+    public:
+        /// Construct policy.
+        /// \param[in] props                fluid and rock properties
+        /// \param[in] rock_comp_props      if non-null and active, the policy is disabled
+        /// \param[in] gravity              if non-null and nonzero, the policy is disabled
+        /// \param[in] check_well_controls  if true, the policy is disabled
+        /// \param[in] tolerance            largest relative change in total mobility
+        ///                                 that does not require a pressure solve,
+        ///                                 zero or negative disables the policy
+        PressureUpdatePolicy(const IncompPropertiesInterface& props,
+                             const RockCompressibility* rock_comp_props,
+                             const double* gravity,
+                             const bool check_well_controls,
+                             const double tolerance);
+
+        /// True if pressure solves may be skipped at all.
+        bool enabled() const;
+
+        /// Decide whether pressure must be solved for the given saturations.
+        /// If so, their total mobility becomes the reference for later steps.
+        /// Always true when disabled and for the first call.
+        /// \param[in] saturation  saturations, two per cell
+        bool pressureNeeded(const std::vector<double>& saturation);
+
+        /// Largest relative total mobility change found by the last call
+        /// to pressureNeeded(), zero if there was no reference to compare to.
+        double lastChange() const;
+
+        /// Number of bytes owned by the policy.
+        std::size_t memoryUsage() const;
+
+    private:
+        const IncompPropertiesInterface& props_;
+        bool enabled_;
+        double tolerance_;
+        double last_change_;
+        std::vector<int> allcells_;
+        std::vector<double> reference_totmob_; // empty before the first solve
+        std::vector<double> totmob_;
+    };
+
+} // namespace Opm
+
+#endif // OPM_PRESSUREUPDATEPOLICY_HEADER_INCLUDED
@@ -0,0 +1,163 @@
+/*
+  Copyright 2015 SINTEF ICT, Applied Mathematics.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "config.h"
+#include <opm/core/simulator/RelativeChange.hpp>
+#include <opm/core/simulator/SimulatorState.hpp>
+#include <opm/core/simulator/BlackoilState.hpp>
+#include <opm/common/ErrorMacros.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+namespace Opm
+{
+
+    namespace
+    {
+        /// Sums of squared differences and squared values for all fields
+        /// in one pass over the cells. Rs and Rv are skipped if null.
+        void fusedSums(const int num_cells,
+                       const int num_phases,
+                       const double* p0, const double* p1,
+                       const double* s0, const double* s1,
+                       const double* rs0, const double* rs1,
+                       const double* rv0, const double* rv1,
+                       double* diff2, double* norm2)
+        {
+            double dp = 0.0, np = 0.0, ds = 0.0, ns = 0.0;
+            double drs = 0.0, nrs = 0.0, drv = 0.0, nrv = 0.0;
+            const bool has_rs = rs0 != 0 && rs1 != 0;
+            const bool has_rv = rv0 != 0 && rv1 != 0;
+#ifdef _OPENMP
+#pragma omp parallel for reduction(+:dp,np,ds,ns,drs,nrs,drv,nrv)
+#endif
+            for (int c = 0; c < num_cells; ++c) {
+                const double d = p1[c] - p0[c];
+                dp += d*d;
+                np += p1[c]*p1[c];
+                for (int phase = 0; phase < num_phases; ++phase) {
+                    const int i = c*num_phases + phase;
+                    const double e = s1[i] - s0[i];
+                    ds += e*e;
+                    ns += s1[i]*s1[i];
+                }
+                if (has_rs) {
+                    const double e = rs1[c] - rs0[c];
+                    drs += e*e;
+                    nrs += rs1[c]*rs1[c];
+                }
+                if (has_rv) {
+                    const double e = rv1[c] - rv0[c];
+                    drv += e*e;
+                    nrv += rv1[c]*rv1[c];
+                }
+            }
+            diff2[FusedRelativeChange::Pressure]     = dp;
+            norm2[FusedRelativeChange::Pressure]     = np;
+            diff2[FusedRelativeChange::Saturation]   = ds;
+            norm2[FusedRelativeChange::Saturation]   = ns;
+            diff2[FusedRelativeChange::DissolvedGas] = drs;
+            norm2[FusedRelativeChange::DissolvedGas] = nrs;
+            diff2[FusedRelativeChange::VaporizedOil] = drv;
+            norm2[FusedRelativeChange::VaporizedOil] = nrv;
+        }
+
+        void checkSizes(const SimulatorState& previous, const SimulatorState& current)
+        {
+            if (previous.numCells() != current.numCells()
+                || previous.numPhases() != current.numPhases()) {
+                OPM_THROW(std::runtime_error, "Relative change of states with different sizes requested.");
+            }
+        }
+
+        const double* dataOrNull(const std::vector<double>& v, const int num_cells)
+        {
+            return (num_cells > 0 && int(v.size()) == num_cells) ? &v[0] : 0;
+        }
+    } // anonymous namespace
+
+
+
+    FusedRelativeChange::FusedRelativeChange()
+    {
+        reset();
+    }
+
+
+
+    void FusedRelativeChange::reset()
+    {
+        std::fill(diff2_, diff2_ + NumFields, 0.0);
+        std::fill(norm2_, norm2_ + NumFields, 0.0);
+    }
+
+
+
+    void FusedRelativeChange::compute(const SimulatorState& previous, const SimulatorState& current)
+    {
+        checkSizes(previous, current);
+        reset();
+        const int nc = current.numCells();
+        if (nc == 0) {
+            return;
+        }
+        fusedSums(nc, current.numPhases(),
+                  &previous.pressure()[0], &current.pressure()[0],
+                  &previous.saturation()[0], &current.saturation()[0],
+                  0, 0, 0, 0, diff2_, norm2_);
+    }
+
+
+
+    void FusedRelativeChange::compute(const BlackoilState& previous, const BlackoilState& current)
+    {
+        checkSizes(previous, current);
+        reset();
+        const int nc = current.numCells();
+        if (nc == 0) {
+            return;
+        }
+        fusedSums(nc, current.numPhases(),
+                  &previous.pressure()[0], &current.pressure()[0],
+                  &previous.saturation()[0], &current.saturation()[0],
+                  dataOrNull(previous.gasoilratio(), nc), dataOrNull(current.gasoilratio(), nc),
+                  dataOrNull(previous.rv(), nc), dataOrNull(current.rv(), nc),
+                  diff2_, norm2_);
+    }
+
+
+
+    double FusedRelativeChange::relativeChange(const Field field) const
+    {
+        return norm2_[field] > 0.0 ? std::sqrt(diff2_[field] / norm2_[field]) : 0.0;
+    }
+
+
+
+    double FusedRelativeChange::relativeChange() const
+    {
+        double change = 0.0;
+        for (int field = 0; field < NumFields; ++field) {
+            change = std::max(change, relativeChange(Field(field)));
+        }
+        return change;
+    }
+
+} // namespace Opm
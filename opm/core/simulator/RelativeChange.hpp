@@ -0,0 +1,75 @@
+/*
+  Copyright 2015 SINTEF ICT, Applied Mathematics.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OPM_RELATIVECHANGE_HEADER_INCLUDED
+#define OPM_RELATIVECHANGE_HEADER_INCLUDED
+
+#include <opm/core/simulator/TimeStepControlInterface.hpp>
+
+namespace Opm
+{
+    class SimulatorState;
+    class BlackoilState;
+
+    ///////////////////////////////////////////////////////////////////
+    ///
+    ///  FusedRelativeChange
+    ///
+    ///  Computes the relative change || u^n+1 - u^n || / || u^n+1 ||
+    ///  of pressure, saturations and (for blackoil states) Rs and Rv
+    ///  in a single, OpenMP parallel sweep over the cells, instead of
+    ///  one sweep per field.
+    ///
+    ///////////////////////////////////////////////////////////////////
+    class FusedRelativeChange : public RelativeChangeInterface
+    {
+    public:
+        /// Fields tracked by the computation.
+        enum Field { Pressure = 0, Saturation = 1, DissolvedGas = 2, VaporizedOil = 3, NumFields = 4 };
+
+        /// Construct with all sums zero.
+        FusedRelativeChange();
+
+        /// Clear all sums.
+        void reset();
+
+        /// Compute the change of pressure and saturation between two
+        /// states in one sweep. Previously computed sums are discarded.
+        void compute(const SimulatorState& previous, const SimulatorState& current);
+
+        /// Compute the change of pressure, saturation, Rs and Rv between
+        /// two blackoil states in one sweep. Previously computed sums
+        /// are discarded.
+        void compute(const BlackoilState& previous, const BlackoilState& current);
+
+        /// \return || u^n+1 - u^n || / || u^n+1 || for a single field,
+        ///         zero if the field has not been computed.
+        double relativeChange(const Field field) const;
+
+        /// \return the largest relative change over all computed fields.
+        double relativeChange() const;
+
+    private:
+        double diff2_[NumFields];
+        double norm2_[NumFields];
+    };
+
+} // namespace Opm
+
+#endif // OPM_RELATIVECHANGE_HEADER_INCLUDED
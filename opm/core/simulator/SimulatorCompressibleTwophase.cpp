@@ -34,6 +34,7 @@
 #include <opm/core/simulator/SimulatorReport.hpp>
 #include <opm/core/simulator/SimulatorTimer.hpp>
 #include <opm/core/utility/StopWatch.hpp>
+#include <opm/core/utility/MemoryUsage.hpp>
 #include <opm/core/io/vtk/writeVtkData.hpp>
 #include <opm/core/utility/miscUtilities.hpp>
 #include <opm/core/utility/miscUtilitiesBlackoil.hpp>
@@ -52,6 +53,7 @@
 #include <memory>
 #include <boost/lexical_cast.hpp>
 
+#include <algorithm>
 #include <numeric>
 #include <fstream>
 #include <iostream>
@@ -78,6 +80,9 @@ namespace Opm
                             WellState& well_state);
 
     private:
+        // Bytes owned by grid, wells and solvers.
+        std::size_t memoryUsage() const;
+
         // Data.
 
         // Parameters for output.
@@ -253,10 +258,14 @@ namespace Opm
                    param.getDefault("nl_pressure_residual_tolerance", 0.0),
                    param.getDefault("nl_pressure_change_tolerance", 1.0),
                    param.getDefault("nl_pressure_maxiter", 10),
-                   gravity, wells_manager.c_wells() /*, src, bcs*/),
+                   gravity, wells_manager.c_wells() /*, src, bcs*/,
+                   param.getDefault("nl_pressure_forcing_max", 0.0),
+                   param.getDefault("nl_pressure_max_backtracks", 0),
+                   param.getDefault("nl_pressure_well_schur", false)),
           tsolver_(grid, props,
                    param.getDefault("nl_tolerance", 1e-9),
-                   param.getDefault("nl_maxiter", 30))
+                   param.getDefault("nl_maxiter", 30),
+                   param.getDefault("transport_level_parallel", false))
     {
         // For output.
         output_ = param.getDefault("output", true);
@@ -297,6 +306,16 @@ namespace Opm
 
 
 
+    std::size_t SimulatorCompressibleTwophase::Impl::memoryUsage() const
+    {
+        return Opm::memoryUsage(grid_) + wells_manager_.memoryUsage()
+            + psolver_.memoryUsage() + tsolver_.memoryUsage()
+            + Opm::memoryUsage(columns_) + Opm::memoryUsage(allcells_);
+    }
+
+
+
+
     SimulatorReport SimulatorCompressibleTwophase::Impl::run(SimulatorTimer& timer,
                                                              BlackoilState& state,
                                                              WellState& well_state)
@@ -321,6 +340,9 @@ namespace Opm
         Opm::time::StopWatch step_timer;
         Opm::time::StopWatch total_timer;
         total_timer.start();
+        std::size_t max_memory_usage = 0;
+        const unsigned long allocations_init = AllocationCounter::allocations();
+        const unsigned long allocated_bytes_init = AllocationCounter::bytesAllocated();
         double init_surfvol[2] = { 0.0 };
         double inplace_surfvol[2] = { 0.0 };
         double tot_injected[2] = { 0.0 };
@@ -354,6 +376,8 @@ namespace Opm
             }
 
             SimulatorReport sreport;
+            const unsigned long step_allocations = AllocationCounter::allocations();
+            const unsigned long step_allocated_bytes = AllocationCounter::bytesAllocated();
 
             // Solve pressure equation.
             if (check_well_controls_) {
@@ -508,6 +532,10 @@ namespace Opm
                                 well_state.bhp(), well_state.perfRates());
             }
             sreport.total_time =  step_timer.secsSinceStart();
+            sreport.memory_usage = memoryUsage();
+            sreport.total_allocations = AllocationCounter::allocations() - step_allocations;
+            sreport.total_allocated_bytes = AllocationCounter::bytesAllocated() - step_allocated_bytes;
+            max_memory_usage = std::max(max_memory_usage, sreport.memory_usage);
             if (output_) {
                 sreport.reportParam(tstep_os);
             }
@@ -531,6 +559,9 @@ namespace Opm
         report.pressure_time = ptime;
         report.transport_time = ttime;
         report.total_time = total_timer.secsSinceStart();
+        report.memory_usage = max_memory_usage;
+        report.total_allocations = AllocationCounter::allocations() - allocations_init;
+        report.total_allocated_bytes = AllocationCounter::bytesAllocated() - allocated_bytes_init;
         return report;
     }
 
@@ -53,9 +53,21 @@ namespace Opm
         ///     nl_pressure_residual_tolerance (0.0) pressure solver residual tolerance (in Pascal)
         ///     nl_pressure_change_tolerance (1.0)   pressure solver change tolerance (in Pascal)
         ///     nl_pressure_maxiter (10)       max nonlinear iterations in pressure
+        ///     nl_pressure_forcing_max (0.0)  if positive, adapt the linear solver tolerance
+        ///                                    to the pressure residual, up to this value
+        ///     nl_pressure_max_backtracks (0) max step halvings in pressure line search
+        ///     nl_pressure_well_schur (false) eliminate well bhps that add no fill
+        ///                                    before the pressure linear solve (bhp
+        ///                                    controlled and single-perforation wells
+        ///                                    only; rate controlled multi-perforation
+        ///                                    wells stay in the system)
         ///     nl_maxiter (30)                max nonlinear iterations in transport
         ///     nl_tolerance (1e-9)            transport solver absolute residual tolerance
         ///     num_transport_substeps (1)     number of transport steps per pressure step
+        ///     transport_level_parallel (false) solve transport one upwind level at a time,
+        ///                                    in parallel if OpenMP is enabled; only
+        ///                                    pays off with several cores, on one core
+        ///                                    the serial sweep is faster
         ///     use_segregation_split (false)  solve for gravity segregation (if false,
         ///                                    segregation is ignored).
         ///
@@ -33,8 +33,10 @@
 #include <opm/core/pressure/flow_bc.h>
 
 #include <opm/core/simulator/SimulatorReport.hpp>
+#include <opm/core/simulator/PressureUpdatePolicy.hpp>
 #include <opm/core/simulator/SimulatorTimer.hpp>
 #include <opm/core/utility/StopWatch.hpp>
+#include <opm/core/utility/MemoryUsage.hpp>
 #include <opm/core/io/vtk/writeVtkData.hpp>
 #include <opm/core/utility/miscUtilities.hpp>
 #include <opm/core/utility/Event.hpp>
@@ -50,10 +52,13 @@
 #include <opm/core/simulator/WellState.hpp>
 #include <opm/core/transport/reorder/TransportSolverTwophaseReorder.hpp>
 #include <opm/core/transport/implicit/TransportSolverTwophaseImplicit.hpp>
+#include <opm/core/transport/minimal/TransportSolverTwophaseExplicitLts.hpp>
 #include <boost/filesystem.hpp>
 #include <memory>
 
 #include <iostream>
+#include <algorithm>
+#include <cmath>
 #include <numeric>
 #include <fstream>
 
@@ -77,6 +82,9 @@ namespace Opm
                             TwophaseState& state,
                             WellState& well_state);
 
+        // Bytes owned by grid, wells and solvers.
+        std::size_t memoryUsage() const;
+
         // Data.
         // Parameters for output.
         std::ostream* log_;
@@ -89,6 +97,7 @@ namespace Opm
         int max_well_control_iterations_;
         // Parameters for transport solver.
         int num_transport_substeps_;
+        bool use_explicit_lts_;
         bool use_reorder_;
         bool use_segregation_split_;
         // Observed objects.
@@ -102,6 +111,7 @@ namespace Opm
         // Solvers
         IncompTpfa psolver_;
         std::unique_ptr<TransportSolverTwophaseInterface> tsolver_;
+        PressureUpdatePolicy pressure_update_;
         // Misc. data
         std::vector<int> allcells_;
 
@@ -332,7 +342,8 @@ namespace Opm
                                         const FlowBoundaryConditions* bcs,
                                         LinearSolverInterface& linsolver,
                                         const double* gravity)
-        : use_reorder_(param.getDefault("use_reorder", true)),
+        : use_explicit_lts_(param.getDefault("transport_explicit_lts", false)),
+          use_reorder_(param.getDefault("use_reorder", true) && !use_explicit_lts_),
           use_segregation_split_(param.getDefault("use_segregation_split", false)),
           grid_(grid),
           props_(props),
@@ -345,15 +356,28 @@ namespace Opm
                    param.getDefault("nl_pressure_residual_tolerance", 0.0),
                    param.getDefault("nl_pressure_change_tolerance", 1.0),
                    param.getDefault("nl_pressure_maxiter", 10),
-                   gravity, wells_manager.c_wells(), src, bcs)
+                   gravity, wells_manager.c_wells(), src, bcs),
+          pressure_update_(props, rock_comp_props, gravity,
+                           param.getDefault("check_well_controls", false),
+                           param.getDefault("pressure_update_tolerance", 0.0))
     {
         // Initialize transport solver.
-        if (use_reorder_) {
+        if (use_explicit_lts_) {
+            if (use_segregation_split_) {
+                OPM_THROW(std::runtime_error, "The explicit transport solver is not set up to use segregation splitting.");
+            }
+            tsolver_.reset(new Opm::TransportSolverTwophaseExplicitLts(grid,
+                                                                       props,
+                                                                       param.getDefault("transport_lts_cfl", 0.5),
+                                                                       param.getDefault("transport_lts_max_level", 6),
+                                                                       param.getDefault("transport_lts_table_size", 201)));
+        } else if (use_reorder_) {
             tsolver_.reset(new Opm::TransportSolverTwophaseReorder(grid,
                                                                    props,
                                                                    use_segregation_split_ ? gravity : NULL,
                                                                    param.getDefault("nl_tolerance", 1e-9),
-                                                                   param.getDefault("nl_maxiter", 30)));
+                                                                   param.getDefault("nl_maxiter", 30),
+                                                                   param.getDefault("transport_newton_min_scc_size", 0)));
 
         } else {
             if (rock_comp_props && rock_comp_props->isActive()) {
@@ -407,6 +431,21 @@ namespace Opm
 
 
 
+    std::size_t SimulatorIncompTwophase::Impl::memoryUsage() const
+    {
+        std::size_t bytes = Opm::memoryUsage(grid_) + wells_manager_.memoryUsage()
+            + psolver_.memoryUsage() + Opm::memoryUsage(allcells_)
+            + pressure_update_.memoryUsage();
+        const MemoryUsageInterface* tsolver_mem = dynamic_cast<const MemoryUsageInterface*>(tsolver_.get());
+        if (tsolver_mem) {
+            bytes += tsolver_mem->memoryUsage();
+        }
+        return bytes;
+    }
+
+
+
+
     SimulatorReport SimulatorIncompTwophase::Impl::run(SimulatorTimer& timer,
                                                        TwophaseState& state,
                                                        WellState& well_state)
@@ -433,6 +472,10 @@ namespace Opm
         Opm::time::StopWatch step_timer;
         Opm::time::StopWatch total_timer;
         total_timer.start();
+        std::size_t max_memory_usage = 0;
+        const unsigned long allocations_init = AllocationCounter::allocations();
+        const unsigned long allocated_bytes_init = AllocationCounter::bytesAllocated();
+        unsigned int pressure_solves = 0;
         double init_satvol[2] = { 0.0 };
         double satvol[2] = { 0.0 };
         double tot_injected[2] = { 0.0 };
@@ -472,75 +515,90 @@ namespace Opm
             }
 
             SimulatorReport sreport;
-
-            // Solve pressure equation.
-            if (check_well_controls_) {
-                computeFractionalFlow(props_, allcells_, state.saturation(), fractional_flows);
-                wells_manager_.applyExplicitReinjectionControls(well_resflows_phase, well_resflows_phase);
+            const unsigned long step_allocations = AllocationCounter::allocations();
+            const unsigned long step_allocated_bytes = AllocationCounter::bytesAllocated();
+
+            // Decide whether the pressure must be updated, see
+            // PressureUpdatePolicy for when a solve may be skipped.
+            const bool solve_pressure = pressure_update_.pressureNeeded(state.saturation());
+            if (pressure_update_.enabled()) {
+                *log_ << "Total mobility change since last pressure solve: "
+                      << pressure_update_.lastChange() << std::endl;
             }
-            bool well_control_passed = !check_well_controls_;
-            int well_control_iteration = 0;
-            do {
-                // Run solver.
-                pressure_timer.start();
-                std::vector<double> initial_pressure = state.pressure();
-                psolver_.solve(timer.currentStepLength(), state, well_state);
-
-                // Renormalize pressure if rock is incompressible, and
-                // there are no pressure conditions (bcs or wells).
-                // It is deemed sufficient for now to renormalize
-                // using geometric volume instead of pore volume.
-                if ((rock_comp_props_ == NULL || !rock_comp_props_->isActive())
-                    && allNeumannBCs(bcs_) && allRateWells(wells_)) {
-                    // Compute average pressures of previous and last
-                    // step, and total volume.
-                    double av_prev_press = 0.0;
-                    double av_press = 0.0;
-                    double tot_vol = 0.0;
-                    const int num_cells = grid_.number_of_cells;
-                    for (int cell = 0; cell < num_cells; ++cell) {
-                        av_prev_press += initial_pressure[cell]*grid_.cell_volumes[cell];
-                        av_press      += state.pressure()[cell]*grid_.cell_volumes[cell];
-                        tot_vol       += grid_.cell_volumes[cell];
-                    }
-                    // Renormalization constant
-                    const double ren_const = (av_prev_press - av_press)/tot_vol;
-                    for (int cell = 0; cell < num_cells; ++cell) {
-                        state.pressure()[cell] += ren_const;
-                    }
-                    const int num_wells = (wells_ == NULL) ? 0 : wells_->number_of_wells;
-                    for (int well = 0; well < num_wells; ++well) {
-                        well_state.bhp()[well] += ren_const;
-                    }
-                }
-
-                // Stop timer and report.
-                pressure_timer.stop();
-                double pt = pressure_timer.secsSinceStart();
-                *log_ << "Pressure solver took:  " << pt << " seconds." << std::endl;
-                ptime += pt;
-                sreport.pressure_time = pt;
 
-                // Optionally, check if well controls are satisfied.
+            // Solve pressure equation.
+            if (!solve_pressure) {
+                *log_ << "Reusing fluxes from last pressure solve." << std::endl;
+            } else {
                 if (check_well_controls_) {
-                    Opm::computePhaseFlowRatesPerWell(*wells_,
-                                                      well_state.perfRates(),
-                                                      fractional_flows,
-                                                      well_resflows_phase);
-                    *log_ << "Checking well conditions." << std::endl;
-                    // For testing we set surface := reservoir
-                    well_control_passed = wells_manager_.conditionsMet(well_state.bhp(), well_resflows_phase, well_resflows_phase);
-                    ++well_control_iteration;
-                    if (!well_control_passed && well_control_iteration > max_well_control_iterations_) {
-                        OPM_THROW(std::runtime_error, "Could not satisfy well conditions in " << max_well_control_iterations_ << " tries.");
+                    computeFractionalFlow(props_, allcells_, state.saturation(), fractional_flows);
+                    wells_manager_.applyExplicitReinjectionControls(well_resflows_phase, well_resflows_phase);
+                }
+                bool well_control_passed = !check_well_controls_;
+                int well_control_iteration = 0;
+                do {
+                    // Run solver.
+                    pressure_timer.start();
+                    std::vector<double> initial_pressure = state.pressure();
+                    psolver_.solve(timer.currentStepLength(), state, well_state);
+
+                    // Renormalize pressure if rock is incompressible, and
+                    // there are no pressure conditions (bcs or wells).
+                    // It is deemed sufficient for now to renormalize
+                    // using geometric volume instead of pore volume.
+                    if ((rock_comp_props_ == NULL || !rock_comp_props_->isActive())
+                        && allNeumannBCs(bcs_) && allRateWells(wells_)) {
+                        // Compute average pressures of previous and last
+                        // step, and total volume.
+                        double av_prev_press = 0.0;
+                        double av_press = 0.0;
+                        double tot_vol = 0.0;
+                        const int num_cells = grid_.number_of_cells;
+                        for (int cell = 0; cell < num_cells; ++cell) {
+                            av_prev_press += initial_pressure[cell]*grid_.cell_volumes[cell];
+                            av_press      += state.pressure()[cell]*grid_.cell_volumes[cell];
+                            tot_vol       += grid_.cell_volumes[cell];
+                        }
+                        // Renormalization constant
+                        const double ren_const = (av_prev_press - av_press)/tot_vol;
+                        for (int cell = 0; cell < num_cells; ++cell) {
+                            state.pressure()[cell] += ren_const;
+                        }
+                        const int num_wells = (wells_ == NULL) ? 0 : wells_->number_of_wells;
+                        for (int well = 0; well < num_wells; ++well) {
+                            well_state.bhp()[well] += ren_const;
+                        }
                     }
-                    if (!well_control_passed) {
-                        *log_ << "Well controls not passed, solving again." << std::endl;
-                    } else {
-                        *log_ << "Well conditions met." << std::endl;
+
+                    // Stop timer and report.
+                    pressure_timer.stop();
+                    double pt = pressure_timer.secsSinceStart();
+                    *log_ << "Pressure solver took:  " << pt << " seconds." << std::endl;
+                    ptime += pt;
+                    sreport.pressure_time = pt;
+
+                    // Optionally, check if well controls are satisfied.
+                    if (check_well_controls_) {
+                        Opm::computePhaseFlowRatesPerWell(*wells_,
+                                                          well_state.perfRates(),
+                                                          fractional_flows,
+                                                          well_resflows_phase);
+                        *log_ << "Checking well conditions." << std::endl;
+                        // For testing we set surface := reservoir
+                        well_control_passed = wells_manager_.conditionsMet(well_state.bhp(), well_resflows_phase, well_resflows_phase);
+                        ++well_control_iteration;
+                        if (!well_control_passed && well_control_iteration > max_well_control_iterations_) {
+                            OPM_THROW(std::runtime_error, "Could not satisfy well conditions in " << max_well_control_iterations_ << " tries.");
+                        }
+                        if (!well_control_passed) {
+                            *log_ << "Well controls not passed, solving again." << std::endl;
+                        } else {
+                            *log_ << "Well conditions met." << std::endl;
+                        }
                     }
-                }
-            } while (!well_control_passed);
+                } while (!well_control_passed);
+                ++pressure_solves;
+            }
 
             // Update pore volumes if rock is compressible.
             if (rock_comp_props_ && rock_comp_props_->isActive()) {
@@ -603,6 +661,10 @@ namespace Opm
                           injected, produced,
                           init_satvol);
             sreport.total_time =  step_timer.secsSinceStart();
+            sreport.memory_usage = memoryUsage();
+            sreport.total_allocations = AllocationCounter::allocations() - step_allocations;
+            sreport.total_allocated_bytes = AllocationCounter::bytesAllocated() - step_allocated_bytes;
+            max_memory_usage = std::max(max_memory_usage, sreport.memory_usage);
             if (output_) {
                 sreport.reportParam(tstep_os);
             }
@@ -640,8 +702,12 @@ namespace Opm
 
         SimulatorReport report;
         report.pressure_time = ptime;
+        report.pressure_solves = pressure_solves;
         report.transport_time = ttime;
         report.total_time = total_timer.secsSinceStart() - time_in_callbacks;
+        report.memory_usage = max_memory_usage;
+        report.total_allocations = AllocationCounter::allocations() - allocations_init;
+        report.total_allocated_bytes = AllocationCounter::bytesAllocated() - allocated_bytes_init;
         return report;
     }
 
@@ -55,11 +55,29 @@ namespace Opm
         ///     nl_pressure_residual_tolerance (0.0) pressure solver residual tolerance (in Pascal)
         ///     nl_pressure_change_tolerance (1.0)   pressure solver change tolerance (in Pascal)
         ///     nl_pressure_maxiter (10)       max nonlinear iterations in pressure
+        ///     pressure_update_tolerance (0.0) if positive, the pressure is only solved
+        ///                                    again when the total mobility of some cell
+        ///                                    has changed by this fraction since the
+        ///                                    last solve (ignored with gravity,
+        ///                                    compressible rock or check_well_controls)
         ///     nl_maxiter (30)                max nonlinear iterations in transport
         ///     nl_tolerance (1e-9)            transport solver absolute residual tolerance
         ///     num_transport_substeps (1)     number of transport steps per pressure step
+        ///     transport_newton_min_scc_size (0) if positive, reorder transport solves
+        ///                                    strongly connected components with at least
+        ///                                    this many cells by Newton instead of
+        ///                                    Gauss-Seidel; off by default since it is
+        ///                                    slower than Gauss-Seidel on 100x100 grids
         ///     use_segregation_split (false)  solve for gravity segregation (if false,
         ///                                    segregation is ignored).
+        ///     transport_explicit_lts (false) use explicit upwind transport with local
+        ///                                    time steps instead of the reorder or
+        ///                                    implicit solver (overrides use_reorder).
+        ///                                    Mobilities are tabulated from cell 0
+        ///     transport_lts_cfl (0.5)        target CFL number of each local step
+        ///     transport_lts_max_level (6)    local steps are at least dt/2^level; longer
+        ///                                    steps are split in halves
+        ///     transport_lts_table_size (201) number of mobility table samples
         ///
         /// \param[in] grid          grid data structure
         /// \param[in] props         fluid and rock properties
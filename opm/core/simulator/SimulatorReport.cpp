@@ -19,6 +19,7 @@
 
 #include "config.h"
 #include <opm/core/simulator/SimulatorReport.hpp>
+#include <algorithm>
 #include <ostream>
 
 namespace Opm
@@ -27,8 +28,12 @@ namespace Opm
         : pressure_time(0.0),
           transport_time(0.0),
           total_time(0.0),
+          pressure_solves( 0 ),
           total_newton_iterations( 0 ),
           total_linear_iterations( 0 ),
+          memory_usage( 0 ),
+          total_allocations( 0 ),
+          total_allocated_bytes( 0 ),
           verbose_(verbose)
     {
     }
@@ -38,8 +43,12 @@ namespace Opm
         pressure_time += sr.pressure_time;
         transport_time += sr.transport_time;
         total_time += sr.total_time;
+        pressure_solves += sr.pressure_solves;
         total_newton_iterations += sr.total_newton_iterations;
         total_linear_iterations += sr.total_linear_iterations;
+        memory_usage = std::max(memory_usage, sr.memory_usage);
+        total_allocations += sr.total_allocations;
+        total_allocated_bytes += sr.total_allocated_bytes;
     }
 
     void SimulatorReport::report(std::ostream& os)
@@ -52,6 +61,10 @@ namespace Opm
                << "\n  Overall Newton Iterations:  " << total_newton_iterations
                << "\n  Overall Linear Iterations:  " << total_linear_iterations
                << std::endl;
+            if (pressure_solves > 0) {
+                os << "  Pressure solves:  " << pressure_solves << std::endl;
+            }
+            reportMemory(os);
         }
     }
 
@@ -64,6 +77,7 @@ namespace Opm
                << "\nOverall Newton Iterations:   " << total_newton_iterations
                << "\nOverall Linear Iterations:   " << total_linear_iterations
                << std::endl;
+            reportMemory(os);
         }
     }
 
@@ -73,12 +87,27 @@ namespace Opm
         {
             os << "/timing/total_time=" << total_time
                << "\n/timing/pressure/total_time=" << pressure_time
+               << "\n/timing/pressure/solves=" << pressure_solves
                << "\n/timing/transport/total_time=" << transport_time
                << "\n/timing/newton/iterations=" << total_newton_iterations
                << "\n/timing/linear/iterations=" << total_linear_iterations
+               << "\n/memory/usage=" << memory_usage
+               << "\n/memory/allocations=" << total_allocations
+               << "\n/memory/allocated_bytes=" << total_allocated_bytes
                << std::endl;
         }
     }
 
+    void SimulatorReport::reportMemory(std::ostream& os)
+    {
+        if (memory_usage > 0) {
+            os << "Memory held by solvers (MB):  " << double(memory_usage)/(1024.0*1024.0) << std::endl;
+        }
+        if (total_allocations > 0) {
+            os << "Heap allocations:             " << total_allocations
+               << "  (" << double(total_allocated_bytes)/(1024.0*1024.0) << " MB)" << std::endl;
+        }
+    }
+
 
 } // namespace Opm
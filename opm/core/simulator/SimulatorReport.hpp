@@ -20,6 +20,7 @@
 #ifndef OPM_SIMULATORREPORT_HEADER_INCLUDED
 #define OPM_SIMULATORREPORT_HEADER_INCLUDED
 
+#include <cstddef>
 #include <iosfwd>
 
 namespace Opm
@@ -31,10 +32,22 @@ namespace Opm
         double pressure_time;
         double transport_time;
         double total_time;
+        /// Number of pressure solves in sequential simulators.
+        unsigned int pressure_solves;
 
         unsigned int total_newton_iterations;
         unsigned int total_linear_iterations;
 
+        /// Bytes owned by the solver components (grid, wells,
+        /// pressure and transport solvers). When reports are
+        /// accumulated, the largest value is kept.
+        std::size_t memory_usage;
+        /// Heap allocations and bytes allocated, as registered by
+        /// AllocationCounter. Zero unless allocation counting is
+        /// enabled.
+        unsigned long total_allocations;
+        unsigned long total_allocated_bytes;
+
         /// Default constructor initializing all times to 0.0.
         SimulatorReport(bool verbose=true);
         /// Increment this report's times by those in sr.
@@ -45,6 +58,8 @@ namespace Opm
         void reportFullyImplicit(std::ostream& os);
         void reportParam(std::ostream& os);
     private:
+        // Print memory usage and allocation counts, if available.
+        void reportMemory(std::ostream& os);
         // Whether to print statistics to std::cout
         bool verbose_;
     };
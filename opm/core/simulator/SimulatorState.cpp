@@ -1,5 +1,6 @@
 #include <opm/common/ErrorMacros.hpp>
 #include <opm/core/simulator/SimulatorState.hpp>
+#include <opm/core/simulator/StateComparison.hpp>
 #include <opm/core/grid.h>
 
 #include <cmath>
@@ -26,19 +27,7 @@ bool
 SimulatorState::vectorApproxEqual(const std::vector<double>& v1,
                                   const std::vector<double>& v2,
                                   double epsilon) {
-    if (v1.size() != v2.size()) {
-        return false;
-    }
-
-    for (size_t i = 0; i < v1.size(); i++) {
-        const double diff = std::abs(v1[i] - v2[i]);
-        const double scale = std::abs(v1[i]) + std::abs(v2[i]);
-        if (diff > epsilon * scale) {
-            return false;
-        }
-    }
-
-    return true;
+    return ApproxComparator(epsilon, 0.0, true).compare("", v1, v2).equal();
 }
 
 void
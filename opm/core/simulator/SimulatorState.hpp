@@ -107,6 +107,8 @@ namespace Opm
          *
          * @return True if every element is within the margin, false if
          *         there is at least one that is not.
+         *
+         * See ApproxComparator for a comparison that reports the errors.
          */
         static bool vectorApproxEqual(const std::vector<double>& v1,
                                       const std::vector<double>& v2,
@@ -0,0 +1,303 @@
+/*
+  Copyright 2015 SINTEF ICT, Applied Mathematics.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "config.h"
+
+#include <opm/core/simulator/StateComparison.hpp>
+#include <opm/core/simulator/SimulatorState.hpp>
+#include <opm/core/simulator/WellState.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <ostream>
+
+namespace Opm
+{
+
+    namespace
+    {
+        // Elements per block. Large enough to amortise the scheduling,
+        // small enough that early exit stops soon after a mismatch.
+        const std::size_t BlockSize = 4096;
+
+        struct BlockResult
+        {
+            bool processed;
+            std::size_t num_mismatches;
+            double max_abs;
+            double max_rel;
+            double sum_sq;
+        };
+
+        inline bool mismatch(const double x, const double y,
+                             const double rel_tol, const double abs_tol)
+        {
+            const double diff = std::fabs(x - y);
+            const double scale = std::fabs(x) + std::fabs(y);
+            return !((x == y) | (diff <= abs_tol) | (diff <= rel_tol*scale)
+                     | ((x != x) & (y != y)));
+        }
+
+        // Branch-free comparison of one block. The error statistics
+        // are skipped when only the number of mismatches is needed.
+        template <bool Stats>
+        BlockResult compareBlock(const double* a, const double* b,
+                                 const std::size_t begin, const std::size_t end,
+                                 const double rel_tol, const double abs_tol)
+        {
+            // Counted in floating point to keep the loop in one vector type.
+            double count = 0.0;
+            double max_abs = 0.0;
+            double max_rel = 0.0;
+            double sum_sq = 0.0;
+#if defined(_OPENMP) && _OPENMP >= 201307
+#pragma omp simd reduction(+:count,sum_sq) reduction(max:max_abs,max_rel)
+#endif
+            for (std::size_t i = begin; i < end; ++i) {
+                const double x = a[i];
+                const double y = b[i];
+                const double diff = std::fabs(x - y);
+                const double scale = std::fabs(x) + std::fabs(y);
+                count += mismatch(x, y, rel_tol, abs_tol) ? 1.0 : 0.0;
+                if (Stats) {
+                    // NaN differences fail all comparisons and are dropped.
+                    max_abs = (diff > max_abs) ? diff : max_abs;
+                    const double rel = (scale > 0.0) ? diff / scale : 0.0;
+                    max_rel = (rel > max_rel) ? rel : max_rel;
+                    sum_sq += (diff == diff) ? diff*diff : 0.0;
+                }
+            }
+            BlockResult result = { true, std::size_t(count), max_abs, max_rel, sum_sq };
+            return result;
+        }
+
+        int readBlock(const int& block)
+        {
+            int val;
+#ifdef _OPENMP
+#pragma omp atomic read
+#endif
+            val = block;
+            return val;
+        }
+
+        // Lower the index of the first block with a mismatch.
+        void lowerBlock(int& block, const int blk)
+        {
+#ifdef _OPENMP
+#pragma omp critical(StateComparisonFirstBlock)
+#endif
+            {
+                if (blk < block) {
+#ifdef _OPENMP
+#pragma omp atomic write
+#endif
+                    block = blk;
+                }
+            }
+        }
+
+        ArrayComparison missingField(const std::string& name)
+        {
+            ArrayComparison c;
+            c.name = name;
+            c.size_mismatch = true;
+            return c;
+        }
+
+        template <class Names, class Data>
+        void compareFields(const ApproxComparator& comparator,
+                           const Names& names_a, const Data& data_a,
+                           const Names& names_b, const Data& data_b,
+                           std::vector<ArrayComparison>& result)
+        {
+            for (std::size_t i = 0; i < names_a.size(); ++i) {
+                const typename Names::const_iterator it
+                    = std::find(names_b.begin(), names_b.end(), names_a[i]);
+                if (it == names_b.end()) {
+                    result.push_back(missingField(names_a[i]));
+                } else {
+                    result.push_back(comparator.compare(names_a[i], data_a[i],
+                                                        data_b[it - names_b.begin()]));
+                }
+            }
+            for (std::size_t i = 0; i < names_b.size(); ++i) {
+                if (std::find(names_a.begin(), names_a.end(), names_b[i]) == names_a.end()) {
+                    result.push_back(missingField(names_b[i]));
+                }
+            }
+        }
+    } // anonymous namespace
+
+
+    ArrayComparison::ArrayComparison()
+        : size(0),
+          size_mismatch(false),
+          complete(true),
+          num_mismatches(0),
+          max_abs_error(0.0),
+          max_rel_error(0.0),
+          rms_error(0.0)
+    {
+    }
+
+
+    std::ostream& operator<<(std::ostream& os, const ArrayComparison& c)
+    {
+        os << c.name << ": ";
+        if (c.size_mismatch) {
+            return os << "size mismatch or missing field";
+        }
+        os << (c.equal() ? "equal" : "DIFFERENT") << " (" << c.num_mismatches
+           << (c.complete ? "" : "+") << " of " << c.size << " outside tolerance"
+           << ", max abs error " << c.max_abs_error
+           << ", max rel error " << c.max_rel_error
+           << ", rms error " << c.rms_error << ")";
+        if (!c.first_mismatches.empty()) {
+            os << ", first at";
+            for (std::size_t i = 0; i < c.first_mismatches.size(); ++i) {
+                os << ' ' << c.first_mismatches[i];
+            }
+        }
+        return os;
+    }
+
+
+    bool allEqual(const std::vector<ArrayComparison>& comparisons)
+    {
+        for (std::size_t i = 0; i < comparisons.size(); ++i) {
+            if (!comparisons[i].equal()) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+
+    ApproxComparator::ApproxComparator(const double rel_tol,
+                                       const double abs_tol,
+                                       const bool early_exit,
+                                       const std::size_t max_reported)
+        : rel_tol_(rel_tol),
+          abs_tol_(abs_tol),
+          early_exit_(early_exit),
+          max_reported_(max_reported)
+    {
+    }
+
+
+    ArrayComparison ApproxComparator::compare(const std::string& name,
+                                              const double* a,
+                                              const double* b,
+                                              const std::size_t n) const
+    {
+        ArrayComparison c;
+        c.name = name;
+        c.size = n;
+
+        const int num_blocks = (n + BlockSize - 1) / BlockSize;
+        const BlockResult skipped = { false, 0, 0.0, 0.0, 0.0 };
+        std::vector<BlockResult> blocks(num_blocks, skipped);
+        // Blocks after a block with a mismatch are skipped with early
+        // exit, but the blocks before it are always compared, so that
+        // the first mismatches are found regardless of thread timing.
+        int first_block = num_blocks;
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static) if (num_blocks > 1)
+#endif
+        for (int blk = 0; blk < num_blocks; ++blk) {
+            if (early_exit_ && blk > readBlock(first_block)) {
+                continue;
+            }
+            const std::size_t begin = blk*BlockSize;
+            const std::size_t end = std::min(n, begin + BlockSize);
+            blocks[blk] = early_exit_
+                ? compareBlock<false>(a, b, begin, end, rel_tol_, abs_tol_)
+                : compareBlock<true>(a, b, begin, end, rel_tol_, abs_tol_);
+            if (blocks[blk].num_mismatches > 0) {
+                lowerBlock(first_block, blk);
+            }
+        }
+
+        // Merge in block order, so that the reported indices are the
+        // first ones among the processed blocks.
+        double sum_sq = 0.0;
+        std::size_t num_compared = 0;
+        for (int blk = 0; blk < num_blocks; ++blk) {
+            const BlockResult& r = blocks[blk];
+            if (!r.processed) {
+                c.complete = false;
+                continue;
+            }
+            const std::size_t begin = blk*BlockSize;
+            const std::size_t end = std::min(n, begin + BlockSize);
+            num_compared += end - begin;
+            c.num_mismatches += r.num_mismatches;
+            c.max_abs_error = std::max(c.max_abs_error, r.max_abs);
+            c.max_rel_error = std::max(c.max_rel_error, r.max_rel);
+            sum_sq += r.sum_sq;
+            for (std::size_t i = begin; r.num_mismatches > 0 && i < end
+                     && c.first_mismatches.size() < max_reported_; ++i) {
+                if (mismatch(a[i], b[i], rel_tol_, abs_tol_)) {
+                    c.first_mismatches.push_back(i);
+                }
+            }
+        }
+        c.rms_error = num_compared > 0 ? std::sqrt(sum_sq / num_compared) : 0.0;
+        return c;
+    }
+
+
+    ArrayComparison ApproxComparator::compare(const std::string& name,
+                                              const std::vector<double>& a,
+                                              const std::vector<double>& b) const
+    {
+        if (a.size() != b.size()) {
+            return missingField(name);
+        }
+        return compare(name, a.empty() ? 0 : &a[0], b.empty() ? 0 : &b[0], a.size());
+    }
+
+
+    std::vector<ArrayComparison> ApproxComparator::compare(const SimulatorState& a,
+                                                           const SimulatorState& b) const
+    {
+        std::vector<ArrayComparison> result;
+        compareFields(*this, a.cellDataNames(), a.cellData(),
+                      b.cellDataNames(), b.cellData(), result);
+        compareFields(*this, a.faceDataNames(), a.faceData(),
+                      b.faceDataNames(), b.faceData(), result);
+        return result;
+    }
+
+
+    std::vector<ArrayComparison> ApproxComparator::compare(const WellState& a,
+                                                           const WellState& b) const
+    {
+        std::vector<ArrayComparison> result;
+        result.push_back(compare("BHP", a.bhp(), b.bhp()));
+        result.push_back(compare("THP", a.thp(), b.thp()));
+        result.push_back(compare("TEMPERATURE", a.temperature(), b.temperature()));
+        result.push_back(compare("WELLRATES", a.wellRates(), b.wellRates()));
+        result.push_back(compare("PERFRATES", a.perfRates(), b.perfRates()));
+        result.push_back(compare("PERFPRESS", a.perfPress(), b.perfPress()));
+        return result;
+    }
+
+} // namespace Opm
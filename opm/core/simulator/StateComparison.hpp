@@ -0,0 +1,132 @@
+/*
+  Copyright 2015 SINTEF ICT, Applied Mathematics.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OPM_STATECOMPARISON_HEADER_INCLUDED
+#define OPM_STATECOMPARISON_HEADER_INCLUDED
+
+#include <cstddef>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+namespace Opm
+{
+    class SimulatorState;
+    class WellState;
+
+    /// Outcome of an approximate element-wise comparison of two arrays.
+    struct ArrayComparison
+    {
+        ArrayComparison();
+
+        /// Name of the compared field.
+        std::string name;
+        /// Number of elements compared.
+        std::size_t size;
+        /// True if the arrays differ in length, or the field is missing
+        /// in one of two states. No elements are compared then.
+        bool size_mismatch;
+        /// False if the comparison stopped at the first mismatch, in
+        /// which case the counts and errors cover only part of the array.
+        bool complete;
+        /// Number of elements outside the tolerance.
+        std::size_t num_mismatches;
+        /// Largest |a_i - b_i|.
+        double max_abs_error;
+        /// Largest |a_i - b_i| / (|a_i| + |b_i|).
+        double max_rel_error;
+        /// Root mean square of a_i - b_i.
+        double rms_error;
+        /// Indices of the first mismatching elements, in increasing order.
+        std::vector<std::size_t> first_mismatches;
+
+        /// \return true if the arrays have equal length and all elements
+        ///         are within the tolerance.
+        bool equal() const { return !size_mismatch && num_mismatches == 0; }
+    };
+
+    /// Print a one-line summary and the first mismatching elements.
+    std::ostream& operator<<(std::ostream& os, const ArrayComparison& c);
+
+    /// \return true if all comparisons are equal().
+    bool allEqual(const std::vector<ArrayComparison>& comparisons);
+
+
+    ///////////////////////////////////////////////////////////////////
+    ///
+    ///  ApproxComparator
+    ///
+    ///  Approximate comparison of raw arrays, simulator states and well
+    ///  states. Elements a_i and b_i match if
+    ///      |a_i - b_i| <= abs_tol  or  |a_i - b_i| <= rel_tol (|a_i| + |b_i|),
+    ///  or if they are equal or both NaN. A NaN compared with a number
+    ///  is a mismatch; NaNs do not contribute to the error norms.
+    ///
+    ///  The arrays are processed in blocks with branch-free inner loops
+    ///  that the compiler vectorises, and the blocks are distributed
+    ///  over the OpenMP threads. With early exit the blocks after the
+    ///  first block with a mismatch are skipped and the error norms are
+    ///  not computed, which makes it the cheaper mode for pass/fail
+    ///  checks. The comparison is memory bound: on a single core, equal
+    ///  arrays take as long as with a plain element-by-element loop.
+    ///
+    ///////////////////////////////////////////////////////////////////
+    class ApproxComparator
+    {
+    public:
+        /// \param[in] rel_tol       relative tolerance.
+        /// \param[in] abs_tol       absolute tolerance.
+        /// \param[in] early_exit    stop at the first block with a mismatch.
+        /// \param[in] max_reported  number of mismatching indices recorded per array.
+        explicit ApproxComparator(const double rel_tol = 1e-8,
+                                  const double abs_tol = 0.0,
+                                  const bool early_exit = false,
+                                  const std::size_t max_reported = 10);
+
+        /// Compare two raw arrays of n elements.
+        ArrayComparison compare(const std::string& name,
+                                const double* a,
+                                const double* b,
+                                const std::size_t n) const;
+
+        /// Compare two vectors.
+        ArrayComparison compare(const std::string& name,
+                                const std::vector<double>& a,
+                                const std::vector<double>& b) const;
+
+        /// Compare all registered cell and face fields of two states,
+        /// matched by name.
+        std::vector<ArrayComparison> compare(const SimulatorState& a,
+                                             const SimulatorState& b) const;
+
+        /// Compare the bhp, thp, temperature, well rate, perforation rate
+        /// and perforation pressure fields of two well states.
+        std::vector<ArrayComparison> compare(const WellState& a,
+                                             const WellState& b) const;
+
+    private:
+        double rel_tol_;
+        double abs_tol_;
+        bool early_exit_;
+        std::size_t max_reported_;
+    };
+
+} // namespace Opm
+
+#endif // OPM_STATECOMPARISON_HEADER_INCLUDED
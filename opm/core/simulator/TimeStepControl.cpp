@@ -19,6 +19,7 @@
   along with OPM.  If not, see <http://www.gnu.org/licenses/>.
 */
 #include <config.h>
+#include <algorithm>
 #include <cassert>
 #include <cmath>
 #include <iostream>
@@ -155,4 +156,145 @@ namespace Opm
         return dtEstimate;
     }
 
+
+
+    ////////////////////////////////////////////////////////////
+    //
+    //  ThroughputTimeStepControl  Implementation
+    //
+    ////////////////////////////////////////////////////////////
+
+    ThroughputTimeStepControl::
+    ThroughputTimeStepControl( const double tol,
+                               const int history,
+                               const double max_growth,
+                               const bool verbose )
+        : BaseType( tol > 0.0 ? tol : 1e-1, verbose )
+        , history_( history )
+        , max_growth_( max_growth )
+        , use_pid_( tol > 0.0 )
+    {
+        if( history_ < 1 ) {
+            OPM_THROW(std::runtime_error,"ThroughputTimeStepControl: history should be >= 1 " << history_ );
+        }
+        if( max_growth_ <= 1.0 ) {
+            OPM_THROW(std::runtime_error,"ThroughputTimeStepControl: max_growth should be > 1 " << max_growth_ );
+        }
+    }
+
+    void ThroughputTimeStepControl::
+    recordStepCost( const double dt, const double seconds, const bool converged ) const
+    {
+        if( !( dt > 0.0 ) ) {
+            return;
+        }
+        StepAttempt attempt = { dt, std::max( seconds, 1e-9 ), converged };
+        attempts_.push_back( attempt );
+        if( int(attempts_.size()) > history_ ) {
+            attempts_.erase( attempts_.begin() );
+        }
+    }
+
+    double ThroughputTimeStepControl::
+    predictedCost( const double dt ) const
+    {
+        // least squares fit of log(seconds) = a + e log(dt), with the
+        // exponent pulled towards e0 when the step sizes vary little
+        const double e0     = 0.5;
+        const double lambda = 0.1;
+        double n = 0, mx = 0, my = 0;
+        for( const StepAttempt& a : attempts_ ) {
+            if( a.converged ) {
+                mx += std::log( a.dt );
+                my += std::log( a.seconds );
+                n  += 1;
+            }
+        }
+        if( n == 0 ) {
+            return -1.0;
+        }
+        mx /= n;
+        my /= n;
+        double sxx = 0, sxy = 0;
+        for( const StepAttempt& a : attempts_ ) {
+            if( a.converged ) {
+                const double x = std::log( a.dt ) - mx;
+                sxx += x * x;
+                sxy += x * ( std::log( a.seconds ) - my );
+            }
+        }
+        const double e = std::min( std::max( ( sxy + lambda * e0 ) / ( sxx + lambda ), 0.0 ), 3.0 );
+        return std::exp( my + e * ( std::log( dt ) - mx ) );
+    }
+
+    double ThroughputTimeStepControl::
+    predictedFailureCost( const double dt ) const
+    {
+        // failed attempts are too few for a fit of their own; scale the
+        // converged model by the geometric mean ratio observed in failures
+        const double converged = predictedCost( dt );
+        if( converged < 0.0 ) {
+            return -1.0;
+        }
+        double n = 0, logRatio = 0;
+        for( const StepAttempt& a : attempts_ ) {
+            if( !a.converged ) {
+                logRatio += std::log( a.seconds / predictedCost( a.dt ) );
+                n += 1;
+            }
+        }
+        return ( n > 0 ) ? converged * std::exp( logRatio / n ) : converged;
+    }
+
+    double ThroughputTimeStepControl::
+    failureProbability( const double dt ) const
+    {
+        // A failure at a step size no larger than dt, or a success at a
+        // step size no smaller than dt, counts fully; others are weighted
+        // down with their distance in log(dt). Half a prior success keeps
+        // the estimate below one.
+        const double sigma = std::log( 1.5 );
+        double failures = 0, successes = 0.5;
+        for( const StepAttempt& a : attempts_ ) {
+            const double d = std::log( dt / a.dt ) / sigma;
+            if( a.converged ) {
+                successes += ( d <= 0.0 ) ? 1.0 : std::exp( -0.5 * d * d );
+            }
+            else {
+                failures  += ( d >= 0.0 ) ? 1.0 : std::exp( -0.5 * d * d );
+            }
+        }
+        return failures / ( failures + successes );
+    }
+
+    double ThroughputTimeStepControl::
+    computeTimeStepSize( const double dt, const int iterations, const RelativeChangeInterface& relChange ) const
+    {
+        const double pidEstimate = use_pid_ ? BaseType :: computeTimeStepSize( dt, iterations, relChange ) : -1.0;
+
+        if( predictedCost( dt ) < 0.0 ) {
+            return use_pid_ ? pidEstimate : dt;
+        }
+
+        // search candidates dt * max_growth^(k/n), k = -n..n
+        const int n = 8;
+        double bestDt = dt;
+        double bestThroughput = -1.0;
+        for( int k = -n; k <= n; ++k ) {
+            const double candidate = dt * std::pow( max_growth_, double(k) / n );
+            const double p = failureProbability( candidate );
+            const double throughput = ( 1.0 - p ) * candidate
+                / ( predictedCost( candidate ) + p * predictedFailureCost( candidate ) );
+            if( throughput > bestThroughput ) {
+                bestThroughput = throughput;
+                bestDt = candidate;
+            }
+        }
+
+        if( verbose_ )
+            std::cout << "Computed step size (throughput): " << unit::convert::to( bestDt, unit::day ) << " (days)" << std::endl;
+
+        return use_pid_ ? std::min( bestDt, pidEstimate ) : bestDt;
+    }
+
 } // end namespace Opm
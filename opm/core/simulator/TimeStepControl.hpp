@@ -117,6 +117,66 @@ namespace Opm
         const int     target_iterations_;
     };
 
+    ///////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    ///
+    ///  Adaptive time step control maximising simulated time per wall-clock second.
+    ///
+    ///  The wall-clock cost of a converged step is modelled as c(dt) = C dt^e, fitted to the
+    ///  recent converged attempts in log-log space. The cost c_f(dt) of a failed attempt is
+    ///  c(dt) scaled by the ratio observed in recent failures. The probability p(dt) that a
+    ///  step fails is estimated from the sizes of recent failed and converged attempts. Among
+    ///  candidate step sizes around the current one, the step maximising
+    ///  (1 - p(dt)) dt / (c(dt) + p(dt) c_f(dt)) is chosen, i.e. the time wasted in failed
+    ///  attempts is charged to the step. If a positive tolerance is given, the step is further
+    ///  limited by the PID control above.
+    //
+    ///////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    class ThroughputTimeStepControl : public PIDTimeStepControl
+    {
+        typedef PIDTimeStepControl BaseType;
+    public:
+        /// \brief constructor
+        /// \param tol        tolerance for the relative changes of the numerical solution, the
+        ///                   PID control is not used if tol <= 0 (default is 1e-1)
+        /// \param history    number of recent step attempts used for the models (default is 20)
+        /// \param max_growth largest factor between a candidate and the current step size (default is 3)
+        /// \param verbose    if true get some output (default = false)
+        ThroughputTimeStepControl( const double tol = 1e-1,
+                                   const int history = 20,
+                                   const double max_growth = 3.0,
+                                   const bool verbose = false );
+
+        /// \brief \copydoc TimeStepControlInterface::computeTimeStepSize
+        double computeTimeStepSize( const double dt, const int iterations, const RelativeChangeInterface& relativeChange ) const;
+
+        /// \brief \copydoc TimeStepControlInterface::recordStepCost
+        void recordStepCost( const double dt, const double seconds, const bool converged ) const;
+
+        /// \return predicted wall-clock seconds of a converged step of size dt,
+        ///         negative if no converged step has been recorded
+        double predictedCost( const double dt ) const;
+
+        /// \return predicted wall-clock seconds of a failed attempt of size dt,
+        ///         negative if no converged step has been recorded
+        double predictedFailureCost( const double dt ) const;
+
+        /// \return estimated probability that a step of size dt fails
+        double failureProbability( const double dt ) const;
+
+    protected:
+        struct StepAttempt
+        {
+            double dt;
+            double seconds;
+            bool   converged;
+        };
+
+        const int     history_;
+        const double  max_growth_;
+        const bool    use_pid_;
+        mutable std::vector< StepAttempt > attempts_;
+    };
+
 
 } // end namespace Opm
 #endif
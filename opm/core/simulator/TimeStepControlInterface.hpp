@@ -59,6 +59,15 @@ namespace Opm
         /// \return suggested time step size for the next step
         virtual double computeTimeStepSize( const double dt, const int iterations, const RelativeChangeInterface& relativeChange ) const = 0;
 
+        /// record the wall-clock cost of an attempted time step, called before
+        /// computeTimeStepSize for converged steps and also for failed ones
+        /// \param dt          time step size attempted
+        /// \param seconds     wall-clock seconds spent on the attempt
+        /// \param converged   true if the solver converged
+        ///
+        /// The default implementation ignores the cost.
+        virtual void recordStepCost( const double /* dt */, const double /* seconds */, const bool /* converged */ ) const {}
+
         /// virtual destructor (empty)
         virtual ~TimeStepControlInterface () {}
     };
@@ -623,6 +623,9 @@ namespace Opm
                     const std::vector<double>& sg_deck = deck->getKeyword("SGAS")->getSIDoubleData();
                     const int gpos = pu.phase_pos[BlackoilPhases::Vapour];
                     const int opos = pu.phase_pos[BlackoilPhases::Liquid];
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
                     for (int c = 0; c < num_cells; ++c) {
                         int c_deck = (global_cell == NULL) ? c : global_cell[c];
                         s[2*c + gpos] = sg_deck[c_deck];
@@ -637,6 +640,9 @@ namespace Opm
                     const std::vector<double>& sw_deck = deck->getKeyword("SWAT")->getSIDoubleData();
                     const int wpos = pu.phase_pos[BlackoilPhases::Aqua];
                     const int nwpos = (wpos + 1) % 2;
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
                     for (int c = 0; c < num_cells; ++c) {
                         int c_deck = (global_cell == NULL) ? c : global_cell[c];
                         s[2*c + wpos] = sw_deck[c_deck];
@@ -654,6 +660,9 @@ namespace Opm
                 const int opos = pu.phase_pos[BlackoilPhases::Liquid];
                 const std::vector<double>& sw_deck = deck->getKeyword("SWAT")->getSIDoubleData();
                 const std::vector<double>& sg_deck = deck->getKeyword("SGAS")->getSIDoubleData();
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
                 for (int c = 0; c < num_cells; ++c) {
                     int c_deck = (global_cell == NULL) ? c : global_cell[c];
                     s[3*c + wpos] = sw_deck[c_deck];
@@ -701,6 +710,9 @@ namespace Opm
         // the outcome. This is not guaranteed unless we have only a single phase
         // per cell.
         props.matrix(nc, &state.pressure()[0], &state.temperature()[0], &state.surfacevol()[0], &allcells[0], &allA[0], 0);
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
         for (int c = 0; c < nc; ++c) {
             // Using z = As
             double* z = &state.surfacevol()[c*np];
@@ -739,103 +751,57 @@ namespace Opm
         }
         const std::vector<double>& rs = state.gasoilratio();
         const std::vector<double>& rv = state.rv();
+        const std::vector<double>& sat = state.saturation();
 
         //make input for computation of the A matrix
         state.surfacevol() = state.saturation();
-        const PhaseUsage pu = props.phaseUsage();
 
         const int np = props.numPhases();
+        const int nc = number_of_cells;
 
-        std::vector<double> allA_a(number_of_cells*np*np);
-        std::vector<double> allA_l(number_of_cells*np*np);
-        std::vector<double> allA_v(number_of_cells*np*np);
-
-        std::vector<int> allcells(number_of_cells);
-        std::vector<double> z_init(number_of_cells*np);
-        std::fill(z_init.begin(),z_init.end(),0.0);
-
-        for (int c = 0; c < number_of_cells; ++c) {
-            allcells[c] = c;
-        }
-
-        std::vector<double> capPressures(number_of_cells*np);
-        props.capPress(number_of_cells,&state.saturation()[0],&allcells[0],&capPressures[0],NULL);
-
-        std::vector<double> Pw(number_of_cells);
-        std::vector<double> Pg(number_of_cells);
-
-        for (int c = 0; c < number_of_cells; ++c){
-            Pw[c] = state.pressure()[c] + capPressures[c*np + BlackoilPhases::Aqua];
-            Pg[c] = state.pressure()[c] + capPressures[c*np + BlackoilPhases::Vapour];
-        }
-
-
-        double z_tmp;
-
-        // Water phase
-        if(pu.phase_used[BlackoilPhases::Aqua])
-           for (int c = 0; c <  number_of_cells ; ++c){
-               for (int p = 0; p < np ; ++p){
-                   if (p == BlackoilPhases::Aqua)
-                       z_tmp = 1;
-                   else
-                       z_tmp = 0;
-
-                   z_init[c*np + p] = z_tmp;
-               }
-           }
-        props.matrix(number_of_cells, &state.pressure()[0], &state.temperature()[0], &z_init[0], &allcells[0], &allA_a[0], 0);
-
-        // Liquid phase
-        if(pu.phase_used[BlackoilPhases::Liquid]){
-            for (int c = 0; c <  number_of_cells ; ++c){
-                for (int p = 0; p < np ; ++p){
-                     if(p == BlackoilPhases::Vapour){
-                         if(state.saturation()[np*c + p] > 0)
-                             z_tmp = 1e10;
-                         else
-                             z_tmp = rs[c];
-                     }
-                     else if(p == BlackoilPhases::Liquid)
-                         z_tmp = 1;
-                     else
-                         z_tmp = 0;
-
-                     z_init[c*np + p] = z_tmp;
-
-                }
-            }
-        }
-        props.matrix(number_of_cells, &state.pressure()[0], &state.temperature()[0], &z_init[0], &allcells[0], &allA_l[0], 0);
-
-        if(pu.phase_used[BlackoilPhases::Vapour]){
-            for (int c = 0; c <  number_of_cells ; ++c){
-                for (int p = 0; p < np ; ++p){
-                     if(p == BlackoilPhases::Liquid){
-                         if(state.saturation()[np*c + p] > 0)
-                             z_tmp = 1e10;
-                         else
-                             z_tmp = rv[c];
-                     }
-                     else if(p == BlackoilPhases::Vapour)
-                         z_tmp = 1;
-                     else
-                         z_tmp = 0;
-
-                     z_init[c*np + p] = z_tmp;
-
-                }
+        // The A matrices for the water, liquid and vapour z vectors are
+        // computed by a single batched property evaluation: entry
+        // k*nc + c holds the input and output for phase k in cell c.
+        const int nz = 3*nc;
+        std::vector<int> cells(nz);
+        std::vector<double> press(nz);
+        std::vector<double> temp(nz);
+        std::vector<double> z_init(nz*np, 0.0);
+        std::vector<double> allA(nz*np*np);
+
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+        for (int c = 0; c < nc; ++c) {
+            for (int k = 0; k < 3; ++k) {
+                cells[k*nc + c] = c;
+                press[k*nc + c] = state.pressure()[c];
+                temp[k*nc + c] = state.temperature()[c];
             }
+            // Water phase
+            double* z_a = &z_init[c*np];
+            z_a[BlackoilPhases::Aqua] = 1.0;
+            // Liquid phase
+            double* z_l = &z_init[(nc + c)*np];
+            z_l[BlackoilPhases::Liquid] = 1.0;
+            z_l[BlackoilPhases::Vapour] = (sat[np*c + BlackoilPhases::Vapour] > 0) ? 1e10 : rs[c];
+            // Vapour phase
+            double* z_v = &z_init[(2*nc + c)*np];
+            z_v[BlackoilPhases::Vapour] = 1.0;
+            z_v[BlackoilPhases::Liquid] = (sat[np*c + BlackoilPhases::Liquid] > 0) ? 1e10 : rv[c];
         }
-        props.matrix(number_of_cells, &state.pressure()[0], &state.temperature()[0], &z_init[0], &allcells[0], &allA_v[0], 0);
+        props.matrix(nz, &press[0], &temp[0], &z_init[0], &cells[0], &allA[0], 0);
 
-        for (int c = 0; c < number_of_cells; ++c) {
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+        for (int c = 0; c < nc; ++c) {
             // Using z = As
             double* z = &state.surfacevol()[c*np];
-            const double* s = &state.saturation()[c*np];
-            const double* A_a = &allA_a[c*np*np];
-            const double* A_l = &allA_l[c*np*np];
-            const double* A_v = &allA_v[c*np*np];
+            const double* s = &sat[c*np];
+            const double* A_a = &allA[c*np*np];
+            const double* A_l = &allA[(nc + c)*np*np];
+            const double* A_v = &allA[(2*nc + c)*np*np];
 
             for (int row = 0; row < np; ++row) { z[row] = 0.0; }
 
@@ -886,6 +852,9 @@ namespace Opm
         if (deck->hasKeyword("RS")) {
             const std::vector<double>& rs_deck = deck->getKeyword("RS")->getSIDoubleData();
             const int num_cells = number_of_cells;
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
             for (int c = 0; c < num_cells; ++c) {
                 int c_deck = (global_cell == NULL) ? c : global_cell[c];
                 state.gasoilratio()[c] = rs_deck[c_deck];
@@ -895,6 +864,9 @@ namespace Opm
         } else if (deck->hasKeyword("RV")){
             const std::vector<double>& rv_deck = deck->getKeyword("RV")->getSIDoubleData();
             const int num_cells = number_of_cells;
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
             for (int c = 0; c < num_cells; ++c) {
                 int c_deck = (global_cell == NULL) ? c : global_cell[c];
                 state.rv()[c] = rv_deck[c_deck];
@@ -0,0 +1,133 @@
+/*
+  Copyright 2015 SINTEF ICT, Applied Mathematics.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#if HAVE_CONFIG_H
+#include "config.h"
+#endif // HAVE_CONFIG_H
+
+#include <opm/core/transport/minimal/TransportSolverTwophaseExplicitLts.hpp>
+#include <opm/core/transport/minimal/spu_explicit.h>
+#include <opm/core/props/IncompPropertiesInterface.hpp>
+#include <opm/core/simulator/TwophaseState.hpp>
+#include <opm/common/ErrorMacros.hpp>
+#include <opm/core/grid.h>
+
+#include <stdexcept>
+
+namespace Opm
+{
+
+    namespace
+    {
+        // Number of times a step may be halved before giving up.
+        const int max_step_halvings = 20;
+    }
+
+    TransportSolverTwophaseExplicitLts::TransportSolverTwophaseExplicitLts(const UnstructuredGrid& grid,
+                                                                           const IncompPropertiesInterface& props,
+                                                                           const double cfl,
+                                                                           const int max_level,
+                                                                           const int table_size)
+        : grid_(grid),
+          cfl_(cfl),
+          max_level_(max_level),
+          tab_(2*table_size),
+          gflux_(grid.number_of_faces, 0.0),
+          num_updates_(0)
+    {
+        if (props.numPhases() != 2) {
+            OPM_THROW(std::runtime_error, "Property object must have 2 phases");
+        }
+        if (table_size < 2) {
+            OPM_THROW(std::runtime_error, "Mobility tables need at least 2 samples, got " << table_size);
+        }
+        if (cfl <= 0.0 || max_level < 0) {
+            OPM_THROW(std::runtime_error, "Need a positive cfl and a nonnegative max_level.");
+        }
+
+        // Sample the saturation functions of cell 0 uniformly on [0, 1].
+        std::vector<double> s(2*table_size), kr(2*table_size);
+        std::vector<int> cells(table_size, 0);
+        for (int i = 0; i < table_size; ++i) {
+            s[2*i] = double(i)/double(table_size - 1);
+            s[2*i + 1] = 1.0 - s[2*i];
+        }
+        props.relperm(table_size, &s[0], &cells[0], &kr[0], 0);
+        const double* mu = props.viscosity();
+        for (int i = 0; i < table_size; ++i) {
+            tab_[i] = kr[2*i]/mu[0];
+            tab_[table_size + i] = kr[2*i + 1]/mu[1];
+        }
+    }
+
+    /// Solve for saturation at next timestep.
+    /// \param[in]      porevolume   Array of pore volumes.
+    /// \param[in]      source       Transport source term. For interpretation see Opm::computeTransportSource().
+    /// \param[in]      dt           Time step.
+    /// \param[in, out] state        Reservoir state. Calling solve() will read state.faceflux() and
+    ///                              read and write state.saturation().
+    void TransportSolverTwophaseExplicitLts::solve(const double* porevolume,
+                                                   const double* source,
+                                                   const double dt,
+                                                   TwophaseState& state)
+    {
+        const int nc = grid_.number_of_cells;
+        std::vector<double>& sat = state.saturation();
+        src_.assign(source, source + nc);
+        pv_.assign(porevolume, porevolume + nc);
+        sw_.resize(nc);
+        sw_new_.resize(nc);
+        for (int cell = 0; cell < nc; ++cell) {
+            sw_[cell] = sat[2*cell];
+        }
+        num_updates_ = 0;
+        advance(&state.faceflux()[0], dt, 0);
+        for (int cell = 0; cell < nc; ++cell) {
+            sat[2*cell] = sw_[cell];
+            sat[2*cell + 1] = 1.0 - sw_[cell];
+        }
+    }
+
+    int TransportSolverTwophaseExplicitLts::getCellUpdates() const
+    {
+        return num_updates_;
+    }
+
+    void TransportSolverTwophaseExplicitLts::advance(double* dflux, const double dt, const int depth)
+    {
+        const int ntab = tab_.size()/2;
+        const int nupdates = spu_explicit_lts(const_cast<UnstructuredGrid*>(&grid_),
+                                              &sw_[0], &sw_new_[0],
+                                              1.0/(ntab - 1), 0.0, ntab, &tab_[0],
+                                              dflux, &gflux_[0], &src_[0], &pv_[0],
+                                              dt, cfl_, max_level_, 0);
+        if (nupdates >= 0) {
+            sw_.swap(sw_new_);
+            num_updates_ += nupdates;
+            return;
+        }
+        if (depth == max_step_halvings) {
+            OPM_THROW(std::runtime_error, "Explicit transport step of " << dt
+                      << " s is still too long after " << depth << " halvings.");
+        }
+        advance(dflux, 0.5*dt, depth + 1);
+        advance(dflux, 0.5*dt, depth + 1);
+    }
+
+} // namespace Opm
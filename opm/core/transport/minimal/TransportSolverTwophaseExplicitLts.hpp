@@ -0,0 +1,92 @@
+/*
+  Copyright 2015 SINTEF ICT, Applied Mathematics.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OPM_TRANSPORTSOLVERTWOPHASEEXPLICITLTS_HEADER_INCLUDED
+#define OPM_TRANSPORTSOLVERTWOPHASEEXPLICITLTS_HEADER_INCLUDED
+
+#include <opm/core/transport/TransportSolverTwophaseInterface.hpp>
+
+#include <vector>
+
+struct UnstructuredGrid;
+
+namespace Opm
+{
+
+    class IncompPropertiesInterface;
+
+    /// Explicit single-point upwind transport solver with local time
+    /// steps, wrapping spu_explicit_lts().
+    ///
+    /// The phase mobilities are tabulated once from the saturation
+    /// functions and viscosities of cell 0, so the solver assumes a
+    /// single saturation region. Gravity segregation is ignored. A
+    /// step that needs more than 2^max_level local steps in its
+    /// fastest cells is split in halves until it fits.
+    class TransportSolverTwophaseExplicitLts : public TransportSolverTwophaseInterface
+    {
+    public:
+        /// Construct solver.
+        /// \param[in] grid        A 2d or 3d grid.
+        /// \param[in] props       Rock and fluid properties.
+        /// \param[in] cfl         Target CFL number of each local step.
+        /// \param[in] max_level   Finest rate class, i.e. steps are at least dt/2^max_level.
+        /// \param[in] table_size  Number of uniform saturation samples in the mobility tables.
+        TransportSolverTwophaseExplicitLts(const UnstructuredGrid& grid,
+                                           const IncompPropertiesInterface& props,
+                                           const double cfl,
+                                           const int max_level,
+                                           const int table_size);
+
+        /// Solve for saturation at next timestep.
+        /// \param[in]      porevolume   Array of pore volumes.
+        /// \param[in]      source       Transport source term. For interpretation see Opm::computeTransportSource().
+        /// \param[in]      dt           Time step.
+        /// \param[in, out] state        Reservoir state. Calling solve() will read state.faceflux() and
+        ///                              read and write state.saturation().
+        virtual void solve(const double* porevolume,
+                           const double* source,
+                           const double dt,
+                           TwophaseState& state);
+
+        /// Number of single-cell updates in the last call to solve().
+        int getCellUpdates() const;
+
+    private:
+        // Disallow copying and assignment.
+        TransportSolverTwophaseExplicitLts(const TransportSolverTwophaseExplicitLts&);
+        TransportSolverTwophaseExplicitLts& operator=(const TransportSolverTwophaseExplicitLts&);
+
+        void advance(double* dflux, const double dt, const int depth);
+
+        const UnstructuredGrid& grid_;
+        const double cfl_;
+        const int max_level_;
+        std::vector<double> tab_;    // Water mobilities followed by oil mobilities.
+        std::vector<double> gflux_;  // Always zero.
+        std::vector<double> src_;
+        std::vector<double> pv_;
+        std::vector<double> sw_;
+        std::vector<double> sw_new_;
+        int num_updates_;
+    };
+
+} // namespace Opm
+
+#endif // OPM_TRANSPORTSOLVERTWOPHASEEXPLICITLTS_HEADER_INCLUDED
@@ -5,10 +5,62 @@
 
 #include "config.h"
 #include <assert.h>
+#include <math.h>
 #include <stdio.h>
+#include <stdlib.h>
 
 #include <opm/core/grid.h>
 #include <opm/core/transport/minimal/spu_explicit.h>
+#include <opm/core/transport/minimal/spu_tables.h>
+
+
+/* Water flux from c1 to c2 across a face with mobilities mob1 in c1
+ * and mob2 in c2, using phase upwinding. */
+static double
+upwind_water_flux(double dflux, double gflux,
+                  const double *mob1, const double *mob2)
+{
+    double m1, m2;
+
+    if ((dflux>0.0 && gflux>0.0) ||
+        (dflux<0.0 && gflux<0.0) ) {
+        /* Water mobility */
+        if (dflux>0) {
+            m1 = mob1[0];
+        }
+        else {
+            m1 = mob2[0];
+        }
+        /* Oil mobility */
+        if (dflux - m1*gflux>0) {
+            m2 = mob1[1];
+        }
+        else {
+            m2 = mob2[1];
+        }
+    }
+
+    else {
+        /* Oil mobility */
+        if (dflux>0) {
+            m2 = mob1[1];
+        }
+        else {
+            m2 = mob2[1];
+        }
+        /* Water mobility */
+        if (dflux+m2*gflux>0) {
+            m1 = mob1[0];
+        }
+        else {
+            m1 = mob2[0];
+        }
+    }
+
+    /* Water flux */
+    assert(m1+m2>0.0);
+    return m1/(m1+m2)*(dflux + m2*gflux);
+}
 
 
 /* Twophase mobility-weighted upwind */
@@ -48,46 +100,195 @@ spu_explicit(struct UnstructuredGrid *g, double *s0, double *s, double *mob,
         c2 = g->face_cells[2*f+1];
         if ((c1 !=-1) && (c2 !=-1)) {
 
-            if ((dflux[f]>0.0 && gflux[f]>0.0) ||
-                (dflux[f]<0.0 && gflux[f]<0.0) ) {
-                /* Water mobility */
-                if (dflux[f]>0) {
-                    m1 = mob[2*c1];
-                }
-                else {
-                    m1 = mob[2*c2];
-                }
-                /* Oil mobility */
-                if (dflux[f] - m1*gflux[f]>0) {
-                    m2 = mob[2*c1+1];
-                }
-                else {
-                    m2 = mob[2*c2+1];
-                }
+            flux = upwind_water_flux(dflux[f], gflux[f],
+                                     mob + 2*c1, mob + 2*c2);
+            s[c1] -= flux*dt;
+            s[c2] += flux*dt;
+        }
+    }
+}
+
+
+/* Water volume rate of the source term in a cell with mobilities mob. */
+static double
+source_water_rate(double src, const double *mob)
+{
+    /* Assume sat==1.0 in source, and f(1.0)=1.0; */
+    if (src > 0.0) {
+        return src;
+    }
+    return src * mob[0]/(mob[0] + mob[1]);
+}
+
+
+/* Coarsest level with a step boundary at micro step m of 2^nlevel;
+ * all finer levels have one there as well. */
+static int
+coarsest_active_level(int m, int nlevel)
+{
+    int k = nlevel;
+    while (k > 0 && m % (1 << (nlevel-k+1)) == 0) {
+        --k;
+    }
+    return k;
+}
+
+
+/* Sort the entities with level lev[i] into buckets pos/ix by level.
+ * Array pos must hold nlevel+3 entries. */
+static void
+bucket_by_level(int n, const int *lev, int nlevel, int *pos, int *ix)
+{
+    int i, k;
+
+    for (k=0; k<nlevel+3; ++k) {
+        pos[k] = 0;
+    }
+    for (i=0; i<n; ++i) {
+        if (lev[i] >= 0) {
+            ++pos[lev[i]+2];
+        }
+    }
+    for (k=2; k<nlevel+3; ++k) {
+        pos[k] += pos[k-1];
+    }
+    for (i=0; i<n; ++i) {
+        if (lev[i] >= 0) {
+            ix[pos[lev[i]+1]++] = i;
+        }
+    }
+}
+
+
+/* Twophase mobility-weighted upwind with local time steps */
+int
+spu_explicit_lts(struct UnstructuredGrid *g, double *s0, double *s,
+                 double h, double x0, int ntab, double *tab,
+                 double *dflux, double *gflux, double *src, double *pv,
+                 double dt, double cfl, int maxlevel, int *level)
+{
+    int i, j, k, f, c, c1, c2, m, kmin, nlevel, nupdates;
+    int nc = g->number_of_cells;
+    int nf = g->number_of_faces;
+
+    int    *cell_level, *face_level, *cellpos, *cells, *facepos, *faces;
+    double *mob, *dv;
+    double  mobmax, rate, hk, flux;
+
+    /* Largest oil mobility, bounding the gravity contribution */
+    mobmax = 0.0;
+    for (i=0; i<ntab; ++i) {
+        mobmax = tab[ntab+i] > mobmax ? tab[ntab+i] : mobmax;
+    }
+
+    cell_level = calloc(nc, sizeof *cell_level);
+    face_level = calloc(nf, sizeof *face_level);
+    cells      = malloc(nc * sizeof *cells);
+    faces      = malloc(nf * sizeof *faces);
+    cellpos    = malloc((maxlevel+3) * sizeof *cellpos);
+    facepos    = malloc((maxlevel+3) * sizeof *facepos);
+    mob        = malloc(2 * nc * sizeof *mob);
+    dv         = malloc(nc * sizeof *dv);
+    assert(cell_level && face_level && cells && faces &&
+           cellpos && facepos && mob && dv);
+
+    /* Rate class of each cell from its throughput */
+    nlevel   = 0;
+    nupdates = 0;
+    for (c=0; c<nc; ++c) {
+        rate = fabs(src[c]);
+        for (j=g->cell_facepos[c]; j<g->cell_facepos[c+1]; ++j) {
+            f = g->cell_faces[j];
+            if (g->face_cells[2*f+0] != -1 && g->face_cells[2*f+1] != -1) {
+                rate += fabs(dflux[f]) + mobmax*fabs(gflux[f]);
             }
+        }
+        rate *= 0.5;
+
+        k = 0;
+        while (k <= maxlevel && dt*rate > cfl*pv[c]*(1 << k)) {
+            ++k;
+        }
+        if (k > maxlevel) {
+            nupdates = -1;
+            break;
+        }
+        cell_level[c] = k;
+        nlevel = k > nlevel ? k : nlevel;
+    }
 
+    if (nupdates == 0) {
+        /* Faces advance with the faster of their cells */
+        for (f=0; f<nf; ++f) {
+            c1 = g->face_cells[2*f+0];
+            c2 = g->face_cells[2*f+1];
+            if ((c1 !=-1) && (c2 !=-1)) {
+                face_level[f] = cell_level[c1] > cell_level[c2] ?
+                    cell_level[c1] : cell_level[c2];
+            }
             else {
-                /* Oil mobility */
-                if (dflux[f]>0) {
-                    m2 = mob[2*c1+1];
-                }
-                else {
-                    m2 = mob[2*c2+1];
+                face_level[f] = -1;
+            }
+        }
+        bucket_by_level(nc, cell_level, nlevel, cellpos, cells);
+        bucket_by_level(nf, face_level, nlevel, facepos, faces);
+
+        for (c=0; c<nc; ++c) {
+            s[c]       = s0[c];
+            mob[2*c+0] = spu_interpolate(ntab, h, x0, tab,        s[c]);
+            mob[2*c+1] = spu_interpolate(ntab, h, x0, tab + ntab, s[c]);
+            dv[c]      = 0.0;
+        }
+
+        for (m=0; m < (1 << nlevel); ++m) {
+            /* Accumulate the water volumes of the steps starting now */
+            kmin = coarsest_active_level(m, nlevel);
+            for (k=kmin; k<=nlevel; ++k) {
+                hk = dt / (1 << k);
+                for (j=facepos[k]; j<facepos[k+1]; ++j) {
+                    f  = faces[j];
+                    c1 = g->face_cells[2*f+0];
+                    c2 = g->face_cells[2*f+1];
+                    flux = upwind_water_flux(dflux[f], gflux[f],
+                                             mob + 2*c1, mob + 2*c2);
+                    dv[c1] -= flux*hk;
+                    dv[c2] += flux*hk;
                 }
-                /* Water mobility */
-                if (dflux[f]+m2*gflux[f]>0) {
-                    m1 = mob[2*c1];
+                for (j=cellpos[k]; j<cellpos[k+1]; ++j) {
+                    c = cells[j];
+                    dv[c] += hk*source_water_rate(src[c], mob + 2*c);
                 }
-                else {
-                    m1 = mob[2*c2];
+            }
+
+            /* Update the cells whose steps end now */
+            kmin = coarsest_active_level(m+1, nlevel);
+            for (k=kmin; k<=nlevel; ++k) {
+                for (j=cellpos[k]; j<cellpos[k+1]; ++j) {
+                    c = cells[j];
+                    s[c] += dv[c]/pv[c];
+                    dv[c] = 0.0;
+                    mob[2*c+0] = spu_interpolate(ntab, h, x0, tab,        s[c]);
+                    mob[2*c+1] = spu_interpolate(ntab, h, x0, tab + ntab, s[c]);
                 }
+                nupdates += cellpos[k+1] - cellpos[k];
             }
+        }
 
-            /* Water flux */
-            assert(m1+m2>0.0);
-            flux = m1/(m1+m2)*(dflux[f] + m2*gflux[f]);
-            s[c1] -= flux*dt;
-            s[c2] += flux*dt;
+        if (level != NULL) {
+            for (c=0; c<nc; ++c) {
+                level[c] = cell_level[c];
+            }
         }
     }
+
+    free(dv);
+    free(mob);
+    free(facepos);
+    free(cellpos);
+    free(faces);
+    free(cells);
+    free(face_level);
+    free(cell_level);
+
+    return nupdates;
 }
@@ -5,6 +5,13 @@
 
 #ifndef SPU_EXPLICIT_H_INCLUDED
 #define SPU_EXPLICIT_H_INCLUDED
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct UnstructuredGrid;
+
 void
 spu_explicit(struct UnstructuredGrid *g,
              double *s0,
@@ -15,5 +22,45 @@ spu_explicit(struct UnstructuredGrid *g,
              double *src,
              double dt);
 
+/*
+ * Multirate variant of spu_explicit() with local time steps.
+ *
+ * The cells are grouped into rate classes by their local CFL number:
+ * a cell in class k advances with step dt/2^k, where k is the smallest
+ * level for which the step is at most cfl times the time needed to
+ * flush the pore volume pv[c] of the cell.  Each internal face
+ * advances with the step of the fastest of its two cells, and the
+ * water volume it transports is accumulated in both neighbours, so the
+ * scheme is conservative also across class interfaces.  Cells are
+ * updated, and their mobilities re-evaluated from the tables tab
+ * (water mobility followed by oil mobility, ntab uniformly spaced
+ * values each, starting at x0 with spacing h), only at the end of
+ * their own steps.
+ *
+ * Unlike spu_explicit(), s0 and s are saturations and the fluxes are
+ * divided by the pore volumes.  The optional array level receives the
+ * rate class of each cell.
+ *
+ * Returns the total number of cell updates, or -1 (leaving s
+ * untouched) if some cell needs more than maxlevel levels.
+ */
+int
+spu_explicit_lts(struct UnstructuredGrid *g,
+                 double *s0,
+                 double *s,
+                 double h, double x0, int ntab, double *tab,
+                 double *dflux,
+                 double *gflux,
+                 double *src,
+                 double *pv,
+                 double dt,
+                 double cfl,
+                 int maxlevel,
+                 int *level);
+
+#ifdef __cplusplus
+}
+#endif
+
 #endif /* SPU_EXPLICIT_H_INCLUDED */
 
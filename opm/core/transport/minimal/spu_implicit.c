@@ -13,38 +13,11 @@
 
 #include <opm/core/grid.h>
 #include <opm/core/transport/minimal/spu_implicit.h>
+#include <opm/core/transport/minimal/spu_tables.h>
 
 
 
 
-/* Assume uniformly spaced table. */
-static double
-interpolate(int n, double h, double x0, double *tab, double x)
-{
-    int           i;
-    double        a;
-
-    assert(h > 0);
-    assert((x-x0) < h*INT_MAX);
-    assert((x-x0) > h*INT_MIN);
-
-    if ( x < x0  ) {
-        return tab[0];
-    }
-
-    i = ((x-x0)/h);
-
-    assert(i>=0);
-
-    if (i+1 > n-1) {
-        return tab[n-1];
-    }
-
-    a = (x-x0 - i*h) / h;
-
-    return (1-a) * tab[i] + a * tab[i+1];
-}
-
 /* Assume uniformly spaced table. */
 static double
 differentiate(int n, double h, double x0, double *tab, double x)
@@ -79,8 +52,8 @@ compute_mobilities(int n, double *s, double *mob, double *dmob, int ntab, double
 
     int i;
     for (i=0; i<n; ++i) {
-        *mob++  = interpolate  (ntab, h, x0, tabw, *s);
-        *mob++  = interpolate  (ntab, h, x0, tabo, *s);
+        *mob++  = spu_interpolate(ntab, h, x0, tabw, *s);
+        *mob++  = spu_interpolate(ntab, h, x0, tabo, *s);
         *dmob++ = differentiate(ntab, h, x0, tabw, *s);
         *dmob++ = differentiate(ntab, h, x0, tabo, *s++);
     }
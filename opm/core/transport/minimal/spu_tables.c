@@ -0,0 +1,39 @@
+/*
+ * Copyright 2010 (c) SINTEF ICT, Applied Mathematics.
+ * Jostein R. Natvig <Jostein.R.Natvig at sintef.no>
+ */
+
+#include "config.h"
+#include <assert.h>
+#include <limits.h>
+
+#include <opm/core/transport/minimal/spu_tables.h>
+
+
+/* Assume uniformly spaced table. */
+double
+spu_interpolate(int n, double h, double x0, double *tab, double x)
+{
+    int           i;
+    double        a;
+
+    assert(h > 0);
+    assert((x-x0) < h*INT_MAX);
+    assert((x-x0) > h*INT_MIN);
+
+    if ( x < x0  ) {
+        return tab[0];
+    }
+
+    i = ((x-x0)/h);
+
+    assert(i>=0);
+
+    if (i+1 > n-1) {
+        return tab[n-1];
+    }
+
+    a = (x-x0 - i*h) / h;
+
+    return (1-a) * tab[i] + a * tab[i+1];
+}
@@ -0,0 +1,26 @@
+/*
+ * Copyright 2010 (c) SINTEF ICT, Applied Mathematics.
+ * Jostein R. Natvig <Jostein.R.Natvig at sintef.no>
+ */
+
+#ifndef SPU_TABLES_H_INCLUDED
+#define SPU_TABLES_H_INCLUDED
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Piecewise linear interpolation in the table tab of n values sampled
+ * uniformly with spacing h from x0.  Values outside the table range
+ * are clamped to the first or last entry.  Shared by the minimal
+ * upwind transport solvers.
+ */
+double
+spu_interpolate(int n, double h, double x0, double *tab, double x);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SPU_TABLES_H_INCLUDED */
@@ -22,21 +22,42 @@
 #include <opm/core/transport/reorder/reordersequence.h>
 #include <opm/core/grid.h>
 #include <opm/core/utility/StopWatch.hpp>
+#include <opm/core/utility/MemoryUsage.hpp>
 
+#include <algorithm>
+#include <exception>
+#include <numeric>
 #include <vector>
 #include <cassert>
 #include <iostream>
 
 
+void Opm::ReorderSolverInterface::setComponentAlgorithm(const ComponentAlgorithm algorithm)
+{
+    component_algorithm_ = algorithm;
+}
+
+
+int Opm::ReorderSolverInterface::computeSequence(const UnstructuredGrid& grid, const double* darcyflux)
+{
+    int ncomponents;
+    if (component_algorithm_ == ParallelTrimColour) {
+        compute_sequence_parallel(&grid, darcyflux, &sequence_[0], &components_[0], &ncomponents);
+    } else {
+        compute_sequence(&grid, darcyflux, &sequence_[0], &components_[0], &ncomponents);
+    }
+    return ncomponents;
+}
+
+
 void Opm::ReorderSolverInterface::reorderAndTransport(const UnstructuredGrid& grid, const double* darcyflux)
 {
     // Compute reordered sequence of single-cell problems
     sequence_.resize(grid.number_of_cells);
     components_.resize(grid.number_of_cells + 1);
-    int ncomponents;
     time::StopWatch clock;
     clock.start();
-    compute_sequence(&grid, darcyflux, &sequence_[0], &components_[0], &ncomponents);
+    const int ncomponents = computeSequence(grid, darcyflux);
     clock.stop();
     std::cout << "Topological sort took: " << clock.secsSinceStart() << " seconds." << std::endl;
 
@@ -65,6 +86,120 @@ void Opm::ReorderSolverInterface::reorderAndTransport(const UnstructuredGrid& gr
 }
 
 
+void Opm::ReorderSolverInterface::reorderAndTransportByLevels(const UnstructuredGrid& grid, const double* darcyflux)
+{
+    // Compute reordered sequence of single-cell problems
+    const int nc = grid.number_of_cells;
+    sequence_.resize(nc);
+    components_.resize(nc + 1);
+    time::StopWatch clock;
+    clock.start();
+    const int ncomponents = computeSequence(grid, darcyflux);
+    components_.resize(ncomponents + 1);
+
+    // The level of a component is one more than the highest level of
+    // its upwind components. Since components are topologically
+    // sorted, upwind components are always visited first.
+    std::vector<int> comp_of(nc);
+    for (int comp = 0; comp < ncomponents; ++comp) {
+        for (int i = components_[comp]; i < components_[comp + 1]; ++i) {
+            comp_of[sequence_[i]] = comp;
+        }
+    }
+    std::vector<int> comp_level(ncomponents, 0);
+    int num_levels = 0;
+    for (int comp = 0; comp < ncomponents; ++comp) {
+        int level = 0;
+        for (int i = components_[comp]; i < components_[comp + 1]; ++i) {
+            const int cell = sequence_[i];
+            for (int j = grid.cell_facepos[cell]; j < grid.cell_facepos[cell + 1]; ++j) {
+                const int f = grid.cell_faces[j];
+                const int c0 = grid.face_cells[2*f + 0];
+                const int c1 = grid.face_cells[2*f + 1];
+                int upwind = -1;
+                if (cell == c0 && darcyflux[f] < 0.0) {
+                    upwind = c1;
+                } else if (cell == c1 && darcyflux[f] > 0.0) {
+                    upwind = c0;
+                }
+                if (upwind != -1 && comp_of[upwind] != comp) {
+                    level = std::max(level, comp_level[comp_of[upwind]] + 1);
+                }
+            }
+        }
+        comp_level[comp] = level;
+        num_levels = std::max(num_levels, level + 1);
+    }
+
+    // Bucket components by level, keeping the sequence order within
+    // each level.
+    level_start_.assign(num_levels + 1, 0);
+    for (int comp = 0; comp < ncomponents; ++comp) {
+        ++level_start_[comp_level[comp] + 1];
+    }
+    std::partial_sum(level_start_.begin(), level_start_.end(), level_start_.begin());
+    level_components_.resize(ncomponents);
+    std::vector<int> next(level_start_.begin(), level_start_.end() - 1);
+    for (int comp = 0; comp < ncomponents; ++comp) {
+        level_components_[next[comp_level[comp]]++] = comp;
+    }
+    clock.stop();
+    std::cout << "Topological sort and leveling took: " << clock.secsSinceStart()
+              << " seconds, " << num_levels << " levels." << std::endl;
+
+    // Solve one level at a time.
+    std::vector<int> single_cells;
+    std::vector<int> multi_comps;
+    for (int level = 0; level < num_levels; ++level) {
+        single_cells.clear();
+        multi_comps.clear();
+        for (int k = level_start_[level]; k < level_start_[level + 1]; ++k) {
+            const int comp = level_components_[k];
+            if (components_[comp + 1] - components_[comp] == 1) {
+                single_cells.push_back(sequence_[components_[comp]]);
+            } else {
+                multi_comps.push_back(comp);
+            }
+        }
+        if (!single_cells.empty()) {
+            solveSingleCells(single_cells.size(), &single_cells[0]);
+        }
+        // Exceptions must not escape a parallel region, so we
+        // rethrow the first one after the loop.
+        const int num_multi = multi_comps.size();
+        std::exception_ptr error;
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+        for (int m = 0; m < num_multi; ++m) {
+            const int comp = multi_comps[m];
+            try {
+                solveMultiCell(components_[comp + 1] - components_[comp],
+                               &sequence_[components_[comp]]);
+            } catch (...) {
+#ifdef _OPENMP
+#pragma omp critical
+#endif
+                if (!error) {
+                    error = std::current_exception();
+                }
+            }
+        }
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+}
+
+
+void Opm::ReorderSolverInterface::solveSingleCells(const int num_cells, const int* cells)
+{
+    for (int i = 0; i < num_cells; ++i) {
+        solveSingleCell(cells[i]);
+    }
+}
+
+
 const std::vector<int>& Opm::ReorderSolverInterface::sequence() const
 {
     return sequence_;
@@ -75,3 +210,10 @@ const std::vector<int>& Opm::ReorderSolverInterface::components() const
 {
     return components_;
 }
+
+
+std::size_t Opm::ReorderSolverInterface::orderingMemoryUsage() const
+{
+    return memoryUsage(sequence_) + memoryUsage(components_)
+        + memoryUsage(level_start_) + memoryUsage(level_components_);
+}
@@ -20,6 +20,7 @@
 #ifndef OPM_REORDERSOLVERINTERFACE_HEADER_INCLUDED
 #define OPM_REORDERSOLVERINTERFACE_HEADER_INCLUDED
 
+#include <cstddef>
 #include <vector>
 
 struct UnstructuredGrid;
@@ -35,20 +36,52 @@ namespace Opm
     /// class.) The reorderAndTransport() method is provided as an aid
     /// to implementing solve() in subclasses, together with the
     /// sequence() and components() methods for accessing the ordering.
+    ///
+    /// The reorderAndTransportByLevels() method is an alternative to
+    /// reorderAndTransport() that groups the components into levels
+    /// of mutually independent components. All single-cell components
+    /// of a level are passed to solveSingleCells() in one call, and
+    /// the multi-cell components of a level are solved in parallel if
+    /// OpenMP is enabled, so solveMultiCell() must then be safe to
+    /// call concurrently for distinct components.
+    ///
+    /// The strongly connected components of the upwind graph are
+    /// found by Tarjan's algorithm unless setComponentAlgorithm()
+    /// selects the parallel algorithm of parallel_scc(), which is
+    /// intended for very large grids where the sequential search
+    /// dominates the setup time. On a single thread parallel_scc()
+    /// is about four times slower than Tarjan's algorithm, so it only
+    /// pays off with several cores.
     class ReorderSolverInterface
     {
     public:
+        /// Algorithms for computing the strongly connected components.
+        enum ComponentAlgorithm { Tarjan, ParallelTrimColour };
+
+        ReorderSolverInterface() : component_algorithm_(Tarjan) {}
     virtual ~ReorderSolverInterface() {}
+        /// Select the algorithm used by the reorder methods.
+        void setComponentAlgorithm(const ComponentAlgorithm algorithm);
     private:
 	virtual void solveSingleCell(const int cell) = 0;
 	virtual void solveMultiCell(const int num_cells, const int* cells) = 0;
+        /// Solve a set of mutually independent single-cell problems.
+        /// The default implementation calls solveSingleCell() for each.
+        virtual void solveSingleCells(const int num_cells, const int* cells);
     protected:
 	void reorderAndTransport(const UnstructuredGrid& grid, const double* darcyflux);
+        void reorderAndTransportByLevels(const UnstructuredGrid& grid, const double* darcyflux);
         const std::vector<int>& sequence() const;
         const std::vector<int>& components() const;
+        /// Number of bytes used for storing the ordering.
+        std::size_t orderingMemoryUsage() const;
     private:
+        int computeSequence(const UnstructuredGrid& grid, const double* darcyflux);
+        ComponentAlgorithm component_algorithm_;
         std::vector<int> sequence_;
         std::vector<int> components_;
+        std::vector<int> level_start_;
+        std::vector<int> level_components_;
     };
 
 
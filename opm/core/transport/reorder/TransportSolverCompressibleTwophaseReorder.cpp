@@ -28,11 +28,17 @@
 #include <opm/core/utility/miscUtilitiesBlackoil.hpp>
 #include <opm/core/pressure/tpfa/trans_tpfa.h>
 
+#include <algorithm>
+#include <exception>
 #include <iostream>
 #include <fstream>
 #include <iterator>
 #include <numeric>
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 
 namespace Opm
 {
@@ -45,11 +51,13 @@ namespace Opm
                                                    const UnstructuredGrid& grid,
                                                    const Opm::BlackoilPropertiesInterface& props,
                                                    const double tol,
-                                                   const int maxit)
+                                                   const int maxit,
+                                                   const bool level_parallel)
         : grid_(grid),
           props_(props),
           tol_(tol),
           maxit_(maxit),
+          level_parallel_(level_parallel),
           darcyflux_(0),
           source_(0),
           dt_(0.0),
@@ -116,13 +124,30 @@ namespace Opm
         compute_sequence_graph(&grid_, &neg_darcyflux[0],
                                &seq[0], &comp[0], &ncomp,
                                &ia_downw_[0], &ja_downw_[0]);
-        reorderAndTransport(grid_, darcyflux);
+        if (level_parallel_) {
+            reorderAndTransportByLevels(grid_, darcyflux);
+        } else {
+            reorderAndTransport(grid_, darcyflux);
+        }
         toBothSat(saturation_, saturation);
 
         // Compute surface volume as a postprocessing step from saturation and A_
         computeSurfacevol(grid_.number_of_cells, props_.numPhases(), &A_[0], &saturation[0], &surfacevol[0]);
     }
 
+
+    std::size_t TransportSolverCompressibleTwophaseReorder::memoryUsage() const
+    {
+        return Opm::memoryUsage(allcells_) + Opm::memoryUsage(visc_)
+            + Opm::memoryUsage(A_) + Opm::memoryUsage(smin_) + Opm::memoryUsage(smax_)
+            + Opm::memoryUsage(saturation_) + Opm::memoryUsage(fractionalflow_)
+            + Opm::memoryUsage(trans_) + Opm::memoryUsage(density_)
+            + Opm::memoryUsage(gravflux_) + Opm::memoryUsage(mob_) + Opm::memoryUsage(s0_)
+            + Opm::memoryUsage(ia_upw_) + Opm::memoryUsage(ja_upw_)
+            + Opm::memoryUsage(ia_downw_) + Opm::memoryUsage(ja_downw_)
+            + orderingMemoryUsage();
+    }
+
     // Residual function r(s) for a single-cell implicit Euler transport
     //
     // [[ incompressible was: r(s) = s - s0 + dt/pv*( influx + outflux*f(s) ) ]]
@@ -184,8 +209,45 @@ namespace Opm
         }
         double operator()(double s) const
         {
-            // return s - s0 + dtpv*(outflux*tm.fracFlow(s, cell) + influx + s*comp_term);
-            return s - B_cell*z0 + dtpv*(outflux*tm.fracFlow(s, cell) + influx) + s*comp_term;
+            return residual(s, tm.fracFlow(s, cell));
+        }
+        // Residual given the fractional flow ff = f(s).
+        double residual(double s, double ff) const
+        {
+            // return s - s0 + dtpv*(outflux*ff + influx + s*comp_term);
+            return s - B_cell*z0 + dtpv*(outflux*ff + influx) + s*comp_term;
+        }
+    };
+
+
+    // Residuals for a set of independent cells, in the form required
+    // by RootFinder::solveBatch(). The fractional flows of all active
+    // cells are computed with a single relperm evaluation.
+    struct TransportSolverCompressibleTwophaseReorder::BatchResidual
+    {
+        std::vector<Residual> res;
+        mutable std::vector<int> active_cells;
+        mutable std::vector<double> ff;
+        mutable std::vector<double> work;
+        const TransportSolverCompressibleTwophaseReorder& tm;
+        BatchResidual(const TransportSolverCompressibleTwophaseReorder& tmodel,
+                      const int num_cells, const int* cells)
+            : active_cells(num_cells), ff(num_cells), work(4*num_cells), tm(tmodel)
+        {
+            res.reserve(num_cells);
+            for (int i = 0; i < num_cells; ++i) {
+                res.push_back(Residual(tm, cells[i]));
+            }
+        }
+        void operator()(const int num, const int* lanes, const double* s, double* r) const
+        {
+            for (int k = 0; k < num; ++k) {
+                active_cells[k] = res[lanes[k]].cell;
+            }
+            tm.fracFlow(num, s, &active_cells[0], &work[0], &ff[0]);
+            for (int k = 0; k < num; ++k) {
+                r[k] = res[lanes[k]].residual(s[k], ff[k]);
+            }
         }
     };
 
@@ -199,6 +261,64 @@ namespace Opm
     }
 
 
+    void TransportSolverCompressibleTwophaseReorder::solveSingleCells(const int num_cells, const int* cells)
+    {
+        // One batch per thread. Exceptions must not escape a parallel
+        // region, so we rethrow the first one after the loop.
+#ifdef _OPENMP
+        const int num_batches = std::min(num_cells, omp_get_max_threads());
+#else
+        const int num_batches = 1;
+#endif
+        std::exception_ptr error;
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+        for (int b = 0; b < num_batches; ++b) {
+            const int begin = (long(num_cells)*b)/num_batches;
+            const int end = (long(num_cells)*(b + 1))/num_batches;
+            try {
+                solveSingleCellBatch(end - begin, cells + begin);
+            } catch (...) {
+#ifdef _OPENMP
+#pragma omp critical
+#endif
+                if (!error) {
+                    error = std::current_exception();
+                }
+            }
+        }
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+
+
+    void TransportSolverCompressibleTwophaseReorder::solveSingleCellBatch(const int num_cells, const int* cells)
+    {
+        // Same as calling solveSingleCell() for each cell, but the
+        // cells are iterated in lockstep.
+        const BatchResidual res(*this, num_cells, cells);
+        std::vector<double> s_init(num_cells);
+        std::vector<double> lower(num_cells, 0.0);
+        std::vector<double> upper(num_cells, 1.0);
+        std::vector<double> s(num_cells);
+        std::vector<int> iters_used(num_cells);
+        for (int i = 0; i < num_cells; ++i) {
+            s_init[i] = saturation_[cells[i]];
+        }
+        RootFinder::solveBatch(res, num_cells, &s_init[0], &lower[0], &upper[0],
+                               maxit_, tol_, &s[0], &iters_used[0]);
+        std::vector<double> ff(num_cells);
+        std::vector<double> work(4*num_cells);
+        fracFlow(num_cells, &s[0], cells, &work[0], &ff[0]);
+        for (int i = 0; i < num_cells; ++i) {
+            saturation_[cells[i]] = s[i];
+            fractionalflow_[cells[i]] = ff[i];
+        }
+    }
+
+
     void TransportSolverCompressibleTwophaseReorder::solveMultiCell(const int num_cells, const int* cells)
     {
         // Experiment: when a cell changes more than the tolerance,
@@ -315,6 +435,26 @@ namespace Opm
         return mob[0]/(mob[0] + mob[1]);
     }
 
+    // Fractional flow for n cells, with a single relperm evaluation.
+    // The sat_work array must have room for 4*n values.
+    void TransportSolverCompressibleTwophaseReorder::fracFlow(const int n, const double* s, const int* cells,
+                                                              double* sat_work, double* ff) const
+    {
+        double* sat = sat_work;
+        double* mob = sat_work + 2*n;
+        for (int i = 0; i < n; ++i) {
+            sat[2*i + 0] = s[i];
+            sat[2*i + 1] = 1.0 - s[i];
+        }
+        props_.relperm(n, sat, cells, mob, 0);
+        for (int i = 0; i < n; ++i) {
+            const int cell = cells[i];
+            const double m0 = mob[2*i + 0]/visc_[2*cell + 0];
+            const double m1 = mob[2*i + 1]/visc_[2*cell + 1];
+            ff[i] = m0/(m0 + m1);
+        }
+    }
+
 
 
 
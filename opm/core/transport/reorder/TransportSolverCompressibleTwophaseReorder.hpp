@@ -21,6 +21,7 @@
 #define OPM_TRANSPORTSOLVERCOMPRESSIBLETWOPHASEREORDER_HEADER_INCLUDED
 
 #include <opm/core/transport/reorder/ReorderSolverInterface.hpp>
+#include <opm/core/utility/MemoryUsage.hpp>
 #include <vector>
 
 struct UnstructuredGrid;
@@ -32,7 +33,8 @@ namespace Opm
 
     /// Implements a reordering transport solver for compressible,
     /// non-miscible two-phase flow.
-    class TransportSolverCompressibleTwophaseReorder : public ReorderSolverInterface
+    class TransportSolverCompressibleTwophaseReorder : public ReorderSolverInterface,
+                                                       public MemoryUsageInterface
     {
     public:
         /// Construct solver.
@@ -40,10 +42,17 @@ namespace Opm
         /// \param[in] props     Rock and fluid properties.
         /// \param[in] tol       Tolerance used in the solver.
         /// \param[in] maxit     Maximum number of non-linear iterations used.
+        /// \param[in] level_parallel If true, solve all independent cells of
+        ///                           an upwind level together, evaluating
+        ///                           relperm once per level and iteration,
+        ///                           and in parallel if OpenMP is enabled.
+        ///                           Requires that props.relperm() is safe
+        ///                           to call concurrently.
         TransportSolverCompressibleTwophaseReorder(const UnstructuredGrid& grid,
                                            const Opm::BlackoilPropertiesInterface& props,
                                            const double tol,
-                                           const int maxit);
+                                           const int maxit,
+                                           const bool level_parallel = false);
 
         /// Solve for saturation at next timestep.
         /// \param[in] darcyflux         Array of signed face fluxes.
@@ -84,9 +93,15 @@ namespace Opm
                           std::vector<double>& saturation,
                           std::vector<double>& surfacevol);
 
+        /// Number of bytes owned by the solver, including the
+        /// reordering sequence.
+        virtual std::size_t memoryUsage() const;
+
     private:
         virtual void solveSingleCell(const int cell);
         virtual void solveMultiCell(const int num_cells, const int* cells);
+        virtual void solveSingleCells(const int num_cells, const int* cells);
+        void solveSingleCellBatch(const int num_cells, const int* cells);
         void solveSingleCellGravity(const std::vector<int>& cells,
                                     const int pos,
                                     const double* gravflux);
@@ -103,6 +118,7 @@ namespace Opm
         std::vector<double> smax_;
         double tol_;
         int maxit_;
+        bool level_parallel_;
 
         const double* darcyflux_;   // one flux per grid face
         const double* surfacevol0_; // one per phase per cell
@@ -127,7 +143,10 @@ namespace Opm
         std::vector<int> ja_downw_;
 
         struct Residual;
+        struct BatchResidual;
         double fracFlow(double s, int cell) const;
+        void fracFlow(const int n, const double* s, const int* cells,
+                      double* sat_work, double* ff) const;
 
         struct GravityResidual;
         void mobility(double s, int cell, double* mob) const;
@@ -27,10 +27,13 @@
 #include <opm/core/utility/miscUtilities.hpp>
 #include <opm/core/pressure/tpfa/trans_tpfa.h>
 
+#include <algorithm>
 #include <iostream>
 #include <fstream>
 #include <iterator>
 #include <numeric>
+#include <functional>
+#include <utility>
 
 
 #define EXPERIMENT_GAUSS_SEIDEL
@@ -47,7 +50,8 @@ namespace Opm
                                                                    const Opm::IncompPropertiesInterface& props,
                                                                    const double* gravity,
                                                                    const double tol,
-                                                                   const int maxit)
+                                                                   const int maxit,
+                                                                   const int newton_min_scc_size)
         : grid_(grid),
           props_(props),
           tol_(tol),
@@ -58,7 +62,9 @@ namespace Opm
           saturation_(grid.number_of_cells, -1.0),
           fractionalflow_(grid.number_of_cells, -1.0),
           reorder_iterations_(grid.number_of_cells, 0),
-          mob_(2*grid.number_of_cells, -1.0)
+          mob_(2*grid.number_of_cells, -1.0),
+          newton_min_scc_size_(newton_min_scc_size),
+          scc_pos_(grid.number_of_cells, -1)
 #ifdef EXPERIMENT_GAUSS_SEIDEL
         , ia_upw_(grid.number_of_cells + 1, -1),
           ja_upw_(grid.number_of_faces, -1),
@@ -78,6 +84,11 @@ namespace Opm
             cells[i] = i;
         }
         props.satRange(props.numCells(), &cells[0], &smin_[0], &smax_[0]);
+        multicell_stats_.gauss_seidel_components = 0;
+        multicell_stats_.gauss_seidel_sweeps = 0;
+        multicell_stats_.newton_components = 0;
+        multicell_stats_.newton_iterations = 0;
+        multicell_stats_.newton_failures = 0;
         if (gravity) {
             initGravity(gravity);
             initColumns();
@@ -127,6 +138,27 @@ namespace Opm
     }
 
 
+    const TransportSolverTwophaseReorder::MultiCellStatistics&
+    TransportSolverTwophaseReorder::multiCellStatistics() const
+    {
+        return multicell_stats_;
+    }
+
+
+    std::size_t TransportSolverTwophaseReorder::memoryUsage() const
+    {
+        return Opm::memoryUsage(smin_) + Opm::memoryUsage(smax_)
+            + Opm::memoryUsage(saturation_) + Opm::memoryUsage(fractionalflow_)
+            + Opm::memoryUsage(reorder_iterations_) + Opm::memoryUsage(gravflux_)
+            + Opm::memoryUsage(mob_) + Opm::memoryUsage(s0_)
+            + Opm::memoryUsage(columns_)
+            + Opm::memoryUsage(ia_upw_) + Opm::memoryUsage(ja_upw_)
+            + Opm::memoryUsage(ia_downw_) + Opm::memoryUsage(ja_downw_)
+            + Opm::memoryUsage(scc_pos_)
+            + orderingMemoryUsage();
+    }
+
+
     // Residual function r(s) for a single-cell implicit Euler transport
     //
     //     r(s) = s - s0 + dt/pv*( influx + outflux*f(s) )
@@ -242,6 +274,14 @@ namespace Opm
 
     void TransportSolverTwophaseReorder::solveMultiCell(const int num_cells, const int* cells)
     {
+        if (newton_min_scc_size_ > 0 && num_cells >= newton_min_scc_size_) {
+            if (solveMultiCellNewton(num_cells, cells)) {
+                return;
+            }
+            ++multicell_stats_.newton_failures;
+        }
+        ++multicell_stats_.gauss_seidel_components;
+
         // std::ofstream os("dump");
         // std::copy(cells, cells + num_cells, std::ostream_iterator<double>(os, "\n"));
 
@@ -414,6 +454,7 @@ namespace Opm
             OPM_THROW(std::runtime_error, "In solveMultiCell(), we did not converge after "
                   << num_iters << " iterations. Remaining update count = " << update_count);
         }
+        multicell_stats_.gauss_seidel_sweeps += num_iters + 1;
         std::cout << "Solved " << num_cells << " cell multicell problem in "
                   << num_iters << " iterations." << std::endl;
 
@@ -450,11 +491,247 @@ namespace Opm
             OPM_THROW(std::runtime_error, "In solveMultiCell(), we did not converge after "
                   << num_iters << " iterations. Delta s = " << max_s_change);
         }
+        multicell_stats_.gauss_seidel_sweeps += num_iters + 1;
         std::cout << "Solved " << num_cells << " cell multicell problem in "
                   << num_iters << " iterations." << std::endl;
 #endif // EXPERIMENT_GAUSS_SEIDEL
     }
 
+    namespace
+    {
+        /// Sparse LU factorisation without pivoting, computed row by row.
+        /// The Jacobian of a strongly connected component is, after scaling
+        /// each row by pv/dt, column diagonally dominant (the diagonal holds
+        /// the total outflux times f', the off-diagonals the influxes from
+        /// upstream cells), so elimination is stable without pivoting.
+        class ComponentLU
+        {
+        public:
+            typedef std::vector<std::pair<int, double> > Row;
+
+            /// Factor the matrix given by its rows, with the diagonal
+            /// present in every row. Returns false if the number of
+            /// nonzeros would exceed max_nnz.
+            bool factor(const std::vector<Row>& rows, const std::size_t max_nnz)
+            {
+                const int n = rows.size();
+                lower_.assign(n, Row());
+                upper_.assign(n, Row());
+                work_.assign(n, 0.0);
+                used_.assign(n, 0);
+                std::size_t nnz = 0;
+                std::vector<int> nz;
+                // Min-heap of the columns left of the diagonal still to be eliminated.
+                std::vector<int> pending;
+                const std::greater<int> later;
+                for (int i = 0; i < n; ++i) {
+                    nz.clear();
+                    for (std::size_t k = 0; k < rows[i].size(); ++k) {
+                        const int j = rows[i][k].first;
+                        if (!used_[j]) {
+                            used_[j] = 1;
+                            nz.push_back(j);
+                            if (j < i) {
+                                pending.push_back(j);
+                                std::push_heap(pending.begin(), pending.end(), later);
+                            }
+                        }
+                        work_[j] += rows[i][k].second;
+                    }
+                    // Eliminate entries left of the diagonal in increasing order.
+                    while (!pending.empty()) {
+                        std::pop_heap(pending.begin(), pending.end(), later);
+                        const int k = pending.back();
+                        pending.pop_back();
+                        const double l = work_[k] / upper_[k][0].second;
+                        lower_[i].push_back(std::make_pair(k, l));
+                        for (std::size_t m = 1; m < upper_[k].size(); ++m) {
+                            const int j = upper_[k][m].first;
+                            if (!used_[j]) {
+                                used_[j] = 1;
+                                nz.push_back(j);
+                                if (j < i) {
+                                    pending.push_back(j);
+                                    std::push_heap(pending.begin(), pending.end(), later);
+                                }
+                            }
+                            work_[j] -= l * upper_[k][m].second;
+                        }
+                    }
+                    // Store the upper part with the diagonal first.
+                    std::sort(nz.begin(), nz.end());
+                    for (std::size_t k = 0; k < nz.size(); ++k) {
+                        const int j = nz[k];
+                        if (j >= i) {
+                            upper_[i].push_back(std::make_pair(j, work_[j]));
+                        }
+                        work_[j] = 0.0;
+                        used_[j] = 0;
+                    }
+                    nnz += lower_[i].size() + upper_[i].size();
+                    if (upper_[i].empty() || upper_[i][0].first != i
+                        || upper_[i][0].second == 0.0 || nnz > max_nnz) {
+                        return false;
+                    }
+                }
+                return true;
+            }
+
+            /// Solve LUx = b, overwriting b with x.
+            void solve(std::vector<double>& b) const
+            {
+                const int n = upper_.size();
+                for (int i = 0; i < n; ++i) {
+                    for (std::size_t k = 0; k < lower_[i].size(); ++k) {
+                        b[i] -= lower_[i][k].second * b[lower_[i][k].first];
+                    }
+                }
+                for (int i = n - 1; i >= 0; --i) {
+                    for (std::size_t k = 1; k < upper_[i].size(); ++k) {
+                        b[i] -= upper_[i][k].second * b[upper_[i][k].first];
+                    }
+                    b[i] /= upper_[i][0].second;
+                }
+            }
+
+        private:
+            std::vector<Row> lower_;
+            std::vector<Row> upper_;
+            std::vector<double> work_;
+            std::vector<int> used_;
+        };
+    } // anonymous namespace
+
+
+
+    // Solve all cells of a strongly connected component simultaneously,
+    // with residuals
+    //
+    //     r_i(s) = s_i - s0_i + dt/pv_i*( influx_i + sum_{j in comp} v_ij*f(s_j) + outflux_i*f(s_i) )
+    //
+    // where influx_i holds the source term and the influx from upstream
+    // cells outside the component, which are already solved, and v_ij < 0
+    // are the fluxes from upstream cells inside the component. Returns
+    // false, leaving the saturations unchanged, if Newton does not converge.
+    bool TransportSolverTwophaseReorder::solveMultiCellNewton(const int num_cells, const int* component)
+    {
+        const int max_iters = 25;
+        const double max_ds = 0.2;
+        const std::size_t max_fill = 100;
+
+        // Number the cells by global index rather than in the order given
+        // by the component search; on grids with a natural cell numbering
+        // this keeps the Jacobian banded and limits fill in the factors.
+        std::vector<int> cells(component, component + num_cells);
+        std::sort(cells.begin(), cells.end());
+        for (int i = 0; i < num_cells; ++i) {
+            scc_pos_[cells[i]] = i;
+        }
+
+        // Split the fluxes of the single-cell residuals into the parts
+        // from inside and outside the component.
+        std::vector<double> s(num_cells), s0(num_cells), influx(num_cells),
+            outflux(num_cells), dtpv(num_cells);
+        std::vector<int> ia(num_cells + 1, 0);
+        std::vector<int> ja;
+        std::vector<double> va;
+        for (int i = 0; i < num_cells; ++i) {
+            const int cell = cells[i];
+            fractionalflow_[cell] = fracFlow(saturation_[cell], cell);
+        }
+        for (int i = 0; i < num_cells; ++i) {
+            const int cell = cells[i];
+            Residual res(*this, cell);
+            s0[i] = res.s0;
+            s[i] = saturation_[cell];
+            outflux[i] = res.outflux;
+            dtpv[i] = res.dtpv;
+            influx[i] = res.influx;
+            for (int hf = grid_.cell_facepos[cell]; hf < grid_.cell_facepos[cell+1]; ++hf) {
+                const int f = grid_.cell_faces[hf];
+                const bool first = (cell == grid_.face_cells[2*f]);
+                const double flux = first ? darcyflux_[f] : -darcyflux_[f];
+                const int other = grid_.face_cells[2*f + (first ? 1 : 0)];
+                if (other != -1 && flux < 0.0 && scc_pos_[other] != -1) {
+                    influx[i] -= flux*fractionalflow_[other];
+                    ja.push_back(scc_pos_[other]);
+                    va.push_back(flux);
+                }
+            }
+            ia[i + 1] = ja.size();
+        }
+
+        std::vector<double> f(num_cells), df(num_cells), r(num_cells);
+        std::vector<ComponentLU::Row> rows(num_cells);
+        ComponentLU lu;
+        bool converged = false;
+        int iter = 0;
+        for (; iter < max_iters; ++iter) {
+            const double h = 1e-7;
+            for (int i = 0; i < num_cells; ++i) {
+                const int cell = cells[i];
+                f[i] = fracFlow(s[i], cell);
+                const double s_lo = std::max(s[i] - h, 0.0);
+                const double s_hi = std::min(s[i] + h, 1.0);
+                df[i] = (fracFlow(s_hi, cell) - fracFlow(s_lo, cell)) / (s_hi - s_lo);
+            }
+            double max_r = 0.0;
+            for (int i = 0; i < num_cells; ++i) {
+                double in = influx[i];
+                for (int k = ia[i]; k < ia[i + 1]; ++k) {
+                    in += va[k]*f[ja[k]];
+                }
+                r[i] = s[i] - s0[i] + dtpv[i]*(outflux[i]*f[i] + in);
+                max_r = std::max(max_r, std::fabs(r[i]));
+            }
+            if (max_r < tol_) {
+                converged = true;
+                break;
+            }
+            for (int i = 0; i < num_cells; ++i) {
+                rows[i].clear();
+                rows[i].push_back(std::make_pair(i, 1.0 + dtpv[i]*outflux[i]*df[i]));
+                for (int k = ia[i]; k < ia[i + 1]; ++k) {
+                    rows[i].push_back(std::make_pair(ja[k], dtpv[i]*va[k]*df[ja[k]]));
+                }
+            }
+            if (!lu.factor(rows, max_fill*num_cells)) {
+                break;
+            }
+            for (int i = 0; i < num_cells; ++i) {
+                r[i] = -r[i];
+            }
+            lu.solve(r);
+            // Limit the saturation change, then project onto [0, 1].
+            double max_change = 0.0;
+            for (int i = 0; i < num_cells; ++i) {
+                max_change = std::max(max_change, std::fabs(r[i]));
+            }
+            const double scale = (max_change > max_ds) ? max_ds/max_change : 1.0;
+            for (int i = 0; i < num_cells; ++i) {
+                s[i] = std::min(std::max(s[i] + scale*r[i], 0.0), 1.0);
+            }
+        }
+
+        for (int i = 0; i < num_cells; ++i) {
+            scc_pos_[cells[i]] = -1;
+        }
+        if (!converged) {
+            return false;
+        }
+        for (int i = 0; i < num_cells; ++i) {
+            const int cell = cells[i];
+            saturation_[cell] = s[i];
+            fractionalflow_[cell] = f[i];
+            reorder_iterations_[cell] += iter;
+        }
+        ++multicell_stats_.newton_components;
+        multicell_stats_.newton_iterations += iter;
+        return true;
+    }
+
+
+
     double TransportSolverTwophaseReorder::fracFlow(double s, int cell) const
     {
         double sat[2] = { s, 1.0 - s };
@@ -22,6 +22,7 @@
 
 #include <opm/core/transport/reorder/ReorderSolverInterface.hpp>
 #include <opm/core/transport/TransportSolverTwophaseInterface.hpp>
+#include <opm/core/utility/MemoryUsage.hpp>
 #include <vector>
 #include <map>
 #include <ostream>
@@ -33,7 +34,8 @@ namespace Opm
     class IncompPropertiesInterface;
 
     /// Implements a reordering transport solver for incompressible two-phase flow.
-    class TransportSolverTwophaseReorder : public TransportSolverTwophaseInterface, ReorderSolverInterface
+    class TransportSolverTwophaseReorder : public TransportSolverTwophaseInterface, ReorderSolverInterface,
+                                           public MemoryUsageInterface
     {
     public:
         /// Construct solver.
@@ -42,11 +44,24 @@ namespace Opm
         /// \param[in] gravity   Gravity vector (null for no gravity).
         /// \param[in] tol       Tolerance used in the solver.
         /// \param[in] maxit     Maximum number of non-linear iterations used.
+        /// \param[in] newton_min_scc_size  Strongly connected components with at least
+        ///                                 this many cells are solved by a local Newton
+        ///                                 method with a direct sparse solve of the
+        ///                                 component's Jacobian instead of nonlinear
+        ///                                 Gauss-Seidel sweeps. Zero (the default)
+        ///                                 disables Newton: it needs far fewer
+        ///                                 iterations, but fill in the sparse factors
+        ///                                 makes it slower than Gauss-Seidel on large
+        ///                                 components, e.g. about ten times slower
+        ///                                 on a vortex in a 100x100 grid.
+        ///                                 Gauss-Seidel is used as fallback if Newton
+        ///                                 fails to converge.
         TransportSolverTwophaseReorder(const UnstructuredGrid& grid,
                                        const Opm::IncompPropertiesInterface& props,
                                        const double* gravity,
                                        const double tol,
-                                       const int maxit);
+                                       const int maxit,
+                                       const int newton_min_scc_size = 0);
 
         // Virtual destructor.
         virtual ~TransportSolverTwophaseReorder();
@@ -80,11 +95,30 @@ namespace Opm
         //// \return vector of iteration per cell
         const std::vector<int>& getReorderIterations() const;
 
+        /// Statistics for the multi-cell (strongly connected component)
+        /// solves, accumulated over all calls to solve().
+        struct MultiCellStatistics
+        {
+            int gauss_seidel_components;    //!< components solved by Gauss-Seidel
+            int gauss_seidel_sweeps;        //!< total Gauss-Seidel sweeps
+            int newton_components;          //!< components solved by Newton
+            int newton_iterations;          //!< total Newton iterations
+            int newton_failures;            //!< Newton solves that fell back to Gauss-Seidel
+        };
+
+        /// Return the multi-cell solve statistics.
+        const MultiCellStatistics& multiCellStatistics() const;
+
+        /// Number of bytes owned by the solver, including the
+        /// reordering sequence and gravity columns.
+        virtual std::size_t memoryUsage() const;
+
     private:
         void initGravity(const double* grav);
         void initColumns();
         virtual void solveSingleCell(const int cell);
         virtual void solveMultiCell(const int num_cells, const int* cells);
+        bool solveMultiCellNewton(const int num_cells, const int* cells);
 
         void solveSingleCellGravity(const std::vector<int>& cells,
                                     const int pos,
@@ -112,6 +146,10 @@ namespace Opm
         std::vector<double> mob_;
         std::vector<double> s0_;
         std::vector<std::vector<int> > columns_;
+        // Local Newton for strongly connected components.
+        int newton_min_scc_size_;
+        std::vector<int> scc_pos_;          // position of cell in current component, -1 if outside
+        MultiCellStatistics multicell_stats_;
 
         // Storing the upwind and downwind graphs for experiments.
         std::vector<int> ia_upw_;
@@ -0,0 +1,552 @@
+/*
+  Copyright 2015 SINTEF ICT, Applied Mathematics.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "config.h"
+
+#ifdef MATLAB_MEX_FILE
+#include "parallelscc.h"
+#else
+#include <opm/core/transport/reorder/parallelscc.h>
+#endif
+
+#include <algorithm>
+#include <cassert>
+#include <numeric>
+#include <vector>
+
+
+namespace
+{
+
+    // Atomic helpers for the frontier based phases.  Without OpenMP
+    // they reduce to plain operations.
+
+    inline int fetchAndSet(int& x)
+    {
+        int old;
+#ifdef _OPENMP
+#pragma omp atomic capture
+#endif
+        { old = x; x = 1; }
+        return old;
+    }
+
+    inline int fetchAndAdd(int& x, const int inc)
+    {
+        int old;
+#ifdef _OPENMP
+#pragma omp atomic capture
+#endif
+        { old = x; x += inc; }
+        return old;
+    }
+
+    inline int decrementAndFetch(int& x)
+    {
+        int val;
+#ifdef _OPENMP
+#pragma omp atomic capture
+#endif
+        val = --x;
+        return val;
+    }
+
+    inline int atomicRead(const int& x)
+    {
+        int val;
+#ifdef _OPENMP
+#pragma omp atomic read
+#endif
+        val = x;
+        return val;
+    }
+
+    inline void atomicWrite(int& x, const int val)
+    {
+#ifdef _OPENMP
+#pragma omp atomic write
+#endif
+        x = val;
+    }
+
+    inline void atomicAdd(int& x, const int inc)
+    {
+#ifdef _OPENMP
+#pragma omp atomic
+#endif
+        x += inc;
+    }
+
+
+
+    class ParallelScc
+    {
+    public:
+        // Switch from forward-backward search to colouring once
+        // max_pivot_misses pivot components have held less than
+        // min_pivot_fraction of the remaining vertices.
+        static const double min_pivot_fraction;
+        static const int max_pivot_misses = 3;
+
+        ParallelScc(const int nv, const int* ia, const int* ja)
+            : nv_(nv), ia_(ia), ja_(ja),
+              ib_(nv + 1, 0), jb_(ia[nv]),
+              label_(nv, -1), active_(nv),
+              count_(nv), mark_(nv), colour_(nv),
+              next_(nv)
+        {
+            buildTranspose();
+            for (int v = 0; v < nv_; ++v) {
+                active_[v] = v;
+            }
+        }
+
+        void run(int* vert, int* comp, int* ncomp)
+        {
+            // Trimming usually labels all cells outside recirculation
+            // zones.  Forward-backward search then peels off the large
+            // components one at a time, and colouring separates the
+            // many small ones left when the pivot component becomes
+            // small compared to the rest of the graph.
+            int pivot_misses = 0;
+            trimSinks();
+            trimSources();
+            compactActive();
+            while (!active_.empty()) {
+                const int num_active = active_.size();
+                const bool use_pivot = pivot_misses < max_pivot_misses;
+                if (use_pivot) {
+                    forwardBackward();
+                } else {
+                    colour();
+                }
+                compactActive();
+                const int num_found = num_active - int(active_.size());
+                if (use_pivot && num_found < min_pivot_fraction*num_active) {
+                    ++pivot_misses;
+                }
+                trimSinks();
+                trimSources();
+                compactActive();
+            }
+            order(vert, comp, ncomp);
+        }
+
+    private:
+        int nv_;
+        const int* ia_;
+        const int* ja_;
+        // Transposed graph: vertex v has edges from jb_[ib_[v]], ..., jb_[ib_[v+1]-1].
+        std::vector<int> ib_;
+        std::vector<int> jb_;
+        // Representative (some vertex) of the component of each
+        // vertex, -1 if not yet assigned.
+        std::vector<int> label_;
+        // Vertices not yet assigned to a component.
+        std::vector<int> active_;
+        std::vector<int> count_;
+        std::vector<int> mark_;
+        std::vector<int> colour_;
+        std::vector<int> frontier_;
+        std::vector<int> next_;
+
+        bool isActive(const int v) const
+        {
+            return label_[v] < 0;
+        }
+
+        long long degreeProduct(const int v) const
+        {
+            return (long long)(ia_[v + 1] - ia_[v]) * (ib_[v + 1] - ib_[v]);
+        }
+
+        void buildTranspose()
+        {
+            const int ne = ia_[nv_];
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+            for (int e = 0; e < ne; ++e) {
+                atomicAdd(ib_[ja_[e] + 1], 1);
+            }
+            std::partial_sum(ib_.begin(), ib_.end(), ib_.begin());
+            std::vector<int> pos(ib_.begin(), ib_.end() - 1);
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+            for (int v = 0; v < nv_; ++v) {
+                for (int j = ia_[v]; j < ia_[v + 1]; ++j) {
+                    jb_[fetchAndAdd(pos[ja_[j]], 1)] = v;
+                }
+            }
+            // Fix the order of each row, which the atomic fill leaves
+            // thread dependent.
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 1024)
+#endif
+            for (int v = 0; v < nv_; ++v) {
+                std::sort(jb_.begin() + ib_[v], jb_.begin() + ib_[v + 1]);
+            }
+        }
+
+        // Remove active vertices with no edges to active vertices, one
+        // frontier at a time (Kahn's algorithm).  Each is a component
+        // of its own.
+        void trimSinks()
+        {
+            trim(ia_, ja_, ib_.data(), jb_.data());
+        }
+
+        // Remove active vertices with no edges from active vertices.
+        void trimSources()
+        {
+            trim(ib_.data(), jb_.data(), ia_, ja_);
+        }
+
+        // Kahn's algorithm on the active subgraph, counting edges
+        // given by (ic, jc) and following the reverse edges (id, jd).
+        void trim(const int* ic, const int* jc, const int* id, const int* jd)
+        {
+            const int na = active_.size();
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+            for (int k = 0; k < na; ++k) {
+                const int v = active_[k];
+                int n = 0;
+                for (int j = ic[v]; j < ic[v + 1]; ++j) {
+                    n += isActive(jc[j]);
+                }
+                count_[v] = n;
+            }
+            frontier_.clear();
+            for (int k = 0; k < na; ++k) {
+                if (count_[active_[k]] == 0) {
+                    frontier_.push_back(active_[k]);
+                }
+            }
+            while (!frontier_.empty()) {
+                const int nfront = frontier_.size();
+                int nnext = 0;
+                // A vertex with an edge to a frontier vertex has a
+                // positive count and is therefore not in the frontier
+                // itself, so reading its label is race free.
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+                for (int k = 0; k < nfront; ++k) {
+                    const int v = frontier_[k];
+                    label_[v] = v;
+                    for (int j = id[v]; j < id[v + 1]; ++j) {
+                        const int u = jd[j];
+                        if (isActive(u) && decrementAndFetch(count_[u]) == 0) {
+                            next_[fetchAndAdd(nnext, 1)] = u;
+                        }
+                    }
+                }
+                frontier_.assign(next_.begin(), next_.begin() + nnext);
+            }
+        }
+
+        // Drop assigned vertices from the active list.
+        void compactActive()
+        {
+            active_.erase(std::remove_if(active_.begin(), active_.end(),
+                                         Assigned(label_)),
+                          active_.end());
+        }
+
+        struct Assigned
+        {
+            explicit Assigned(const std::vector<int>& label) : label_(label) {}
+            bool operator()(const int v) const { return label_[v] >= 0; }
+            const std::vector<int>& label_;
+        };
+
+        // Mark all active vertices reachable from the vertices in
+        // frontier_ along the edges (ic, jc), restricted to vertices
+        // of the same colour as the vertex they are reached from if
+        // same_colour is set.  Frontier vertices must be marked.
+        void search(const int* ic, const int* jc, const bool same_colour)
+        {
+            while (!frontier_.empty()) {
+                const int nfront = frontier_.size();
+                int nnext = 0;
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+                for (int k = 0; k < nfront; ++k) {
+                    const int v = frontier_[k];
+                    for (int j = ic[v]; j < ic[v + 1]; ++j) {
+                        const int u = jc[j];
+                        if (isActive(u)
+                            && (!same_colour || colour_[u] == colour_[v])
+                            && fetchAndSet(mark_[u]) == 0) {
+                            next_[fetchAndAdd(nnext, 1)] = u;
+                        }
+                    }
+                }
+                frontier_.assign(next_.begin(), next_.begin() + nnext);
+            }
+        }
+
+        // Find the component of a pivot vertex as the intersection
+        // of its forward and backward reachable sets.  The pivot is
+        // drawn among the vertices with the largest product of in-
+        // and out-degree, scattered by a multiplicative hash so that
+        // it is likely to lie in a large component rather than at
+        // the start of the numbering.
+        void forwardBackward()
+        {
+            const int na = active_.size();
+            long long max_deg = -1;
+#ifdef _OPENMP
+#pragma omp parallel for reduction(max:max_deg)
+#endif
+            for (int k = 0; k < na; ++k) {
+                const int v = active_[k];
+                max_deg = std::max(max_deg, degreeProduct(v));
+            }
+            unsigned long long best = ~0ULL;
+#ifdef _OPENMP
+#pragma omp parallel for reduction(min:best)
+#endif
+            for (int k = 0; k < na; ++k) {
+                const int v = active_[k];
+                if (degreeProduct(v) == max_deg) {
+                    const unsigned int hash = static_cast<unsigned int>(v) * 2654435761u;
+                    best = std::min(best, (static_cast<unsigned long long>(hash) << 32) | v);
+                }
+            }
+            const int pivot = static_cast<int>(best & 0xffffffffULL);
+
+            // Forward reachable set in count_, backward in mark_.
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+            for (int k = 0; k < na; ++k) {
+                mark_[active_[k]] = 0;
+            }
+            mark_[pivot] = 1;
+            frontier_.assign(1, pivot);
+            search(ia_, ja_, false);
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+            for (int k = 0; k < na; ++k) {
+                const int v = active_[k];
+                count_[v] = mark_[v];
+                mark_[v] = 0;
+            }
+            mark_[pivot] = 1;
+            frontier_.assign(1, pivot);
+            search(ib_.data(), jb_.data(), false);
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+            for (int k = 0; k < na; ++k) {
+                const int v = active_[k];
+                if (count_[v] && mark_[v]) {
+                    label_[v] = pivot;
+                }
+            }
+        }
+
+        // Propagate the largest vertex number along the edges until
+        // stable.  Every vertex whose colour equals its own number is
+        // the root of a component, consisting of the vertices of the
+        // same colour from which the root can be reached.
+        void colour()
+        {
+            const int na = active_.size();
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+            for (int k = 0; k < na; ++k) {
+                const int v = active_[k];
+                colour_[v] = v;
+                mark_[v] = 0;
+            }
+            // Sweep in place, alternating direction, which needs far
+            // fewer sweeps than the diameter of the graph when the
+            // numbering follows the flow.  Colours only increase, so
+            // reading a concurrently updated value is harmless.
+            bool changed = true;
+            bool forward = true;
+            while (changed) {
+                changed = false;
+#ifdef _OPENMP
+#pragma omp parallel for reduction(||:changed)
+#endif
+                for (int k = 0; k < na; ++k) {
+                    const int v = active_[forward ? k : na - 1 - k];
+                    const int old = atomicRead(colour_[v]);
+                    int c = old;
+                    for (int j = ib_[v]; j < ib_[v + 1]; ++j) {
+                        const int u = jb_[j];
+                        if (isActive(u)) {
+                            c = std::max(c, atomicRead(colour_[u]));
+                        }
+                    }
+                    if (c != old) {
+                        atomicWrite(colour_[v], c);
+                        changed = true;
+                    }
+                }
+                forward = !forward;
+            }
+            frontier_.clear();
+            for (int k = 0; k < na; ++k) {
+                const int v = active_[k];
+                if (colour_[v] == v) {
+                    mark_[v] = 1;
+                    frontier_.push_back(v);
+                }
+            }
+            search(ib_.data(), jb_.data(), true);
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+            for (int k = 0; k < na; ++k) {
+                const int v = active_[k];
+                if (mark_[v]) {
+                    label_[v] = colour_[v];
+                }
+            }
+        }
+
+        // Topologically sort the components (Kahn's algorithm on the
+        // condensed graph) and write the output arrays.
+        void order(int* vert, int* comp, int* ncomp)
+        {
+            // Number the components by their smallest vertex and
+            // group the vertices by component.
+            std::vector<int>& comp_id = colour_;
+            int nc = 0;
+            std::vector<int> first(nv_, -1);
+            for (int v = 0; v < nv_; ++v) {
+                if (first[label_[v]] < 0) {
+                    first[label_[v]] = nc++;
+                }
+            }
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+            for (int v = 0; v < nv_; ++v) {
+                comp_id[v] = first[label_[v]];
+            }
+            std::vector<int> start(nc + 1, 0);
+            for (int v = 0; v < nv_; ++v) {
+                ++start[comp_id[v] + 1];
+            }
+            std::partial_sum(start.begin(), start.end(), start.begin());
+            std::vector<int> members(nv_);
+            {
+                std::vector<int> pos(start.begin(), start.end() - 1);
+                for (int v = 0; v < nv_; ++v) {
+                    members[pos[comp_id[v]]++] = v;
+                }
+            }
+
+            // Count edges to other components.
+            std::vector<int>& out = count_;
+            std::fill(out.begin(), out.begin() + nc, 0);
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+            for (int v = 0; v < nv_; ++v) {
+                int n = 0;
+                for (int j = ia_[v]; j < ia_[v + 1]; ++j) {
+                    n += (comp_id[ja_[j]] != comp_id[v]);
+                }
+                if (n != 0) {
+                    atomicAdd(out[comp_id[v]], n);
+                }
+            }
+            frontier_.clear();
+            for (int c = 0; c < nc; ++c) {
+                if (out[c] == 0) {
+                    frontier_.push_back(c);
+                }
+            }
+
+            int num_placed = 0;
+            int pos = 0;
+            std::vector<int> offset;
+            while (!frontier_.empty()) {
+                const int nfront = frontier_.size();
+                offset.resize(nfront);
+                for (int k = 0; k < nfront; ++k) {
+                    const int c = frontier_[k];
+                    comp[num_placed++] = pos;
+                    offset[k] = pos;
+                    pos += start[c + 1] - start[c];
+                }
+                int nnext = 0;
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+                for (int k = 0; k < nfront; ++k) {
+                    const int c = frontier_[k];
+                    std::copy(members.begin() + start[c], members.begin() + start[c + 1],
+                              vert + offset[k]);
+                    for (int i = start[c]; i < start[c + 1]; ++i) {
+                        const int v = members[i];
+                        for (int j = ib_[v]; j < ib_[v + 1]; ++j) {
+                            const int d = comp_id[jb_[j]];
+                            if (d != c && decrementAndFetch(out[d]) == 0) {
+                                next_[fetchAndAdd(nnext, 1)] = d;
+                            }
+                        }
+                    }
+                }
+                frontier_.assign(next_.begin(), next_.begin() + nnext);
+                std::sort(frontier_.begin(), frontier_.end());
+            }
+            assert(num_placed == nc);
+            assert(pos == nv_);
+            comp[nc] = pos;
+            *ncomp = nc;
+        }
+    };
+
+    const double ParallelScc::min_pivot_fraction = 0.01;
+
+} // anonymous namespace
+
+
+
+// ---------------------------------------------------------------------
+void
+parallel_scc(int        nv   ,
+             const int *ia   ,
+             const int *ja   ,
+             int       *vert ,
+             int       *comp ,
+             int       *ncomp)
+// ---------------------------------------------------------------------
+{
+    ParallelScc scc(nv, ia, ja);
+    scc.run(vert, comp, ncomp);
+}
+
+
+/* Local Variables:    */
+/* c-basic-offset:4    */
+/* End:                */
@@ -0,0 +1,92 @@
+/*
+  Copyright 2015 SINTEF ICT, Applied Mathematics.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * \file
+ *
+ * Parallel computation of the strongly connected components of a
+ * directed graph, \f$G(V,E)\f$, for use in place of tarjan() on very
+ * large graphs.
+ *
+ * The algorithm follows the "trim, forward-backward, colour" scheme
+ * of Hong, Rodia and Olukotun, "On fast parallel detection of
+ * strongly connected components (SCC) in small-world graphs", SC'13:
+ * trivial components are peeled off by repeatedly removing vertices
+ * without in- or out-edges, large components are found one at a time
+ * by a forward and a backward search from a pivot, and the many small
+ * components that remain are separated by colour propagation.  All
+ * phases are frontier or sweep based and parallelised with OpenMP.
+ * The work is \f$O(|V| + |E|)\f$ per phase; the colouring phase needs
+ * a number of sweeps bounded by the diameter of what is left.
+ */
+
+#ifndef OPM_PARALLELSCC_H_INCLUDED
+#define OPM_PARALLELSCC_H_INCLUDED
+
+#ifdef __cplusplus
+extern "C" {
+#endif  /* __cplusplus */
+
+/**
+ * Compute the strongly connected components of a directed graph,
+ * \f$G(V,E)\f$.
+ *
+ * Output follows the conventions of tarjan(): the components are
+ * returned in reverse topological sorted sequence, i.e., a component
+ * is preceded by all components it has edges to.  Components with
+ * the same topological level are ordered by their smallest vertex,
+ * and the vertices of each component are in increasing order, so the
+ * result does not depend on the number of threads.
+ *
+ * \param[in] nv Number of graph vertices.
+ *
+ * \param[in] ia
+ * \param[in] ja adjacency matrix for directed graph in compressed sparse row
+ *               format: vertex i has directed edges to vertices ja[ia[i]],
+ *                ..., ja[ia[i+1]-1].
+ *
+ * \param[out] vert Permutation of vertices into topologically sorted
+ *                  sequence of strong components (i.e., loops).
+ *                  Array of size <CODE>nv</CODE>.
+ *
+ * \param[out] comp Pointers to start of each strongly connected
+ *                  component in vert, the i'th component has vertices
+ *                  vert[comp[i]], ..., vert[comp[i+1] - 1].  Array of
+ *                  size <CODE>nv + 1</CODE>.
+ *
+ * \param[out] ncomp Number of strong components.  Pointer to a single
+ *                   <CODE>int</CODE>.
+ */
+void
+parallel_scc(int        nv   ,
+             const int *ia   ,
+             const int *ja   ,
+             int       *vert ,
+             int       *comp ,
+             int       *ncomp);
+
+#ifdef __cplusplus
+}
+#endif  /* __cplusplus */
+
+#endif /* OPM_PARALLELSCC_H_INCLUDED */
+
+/* Local Variables:    */
+/* c-basic-offset:4    */
+/* End:                */
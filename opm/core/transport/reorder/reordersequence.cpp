@@ -6,14 +6,17 @@
 #ifdef MATLAB_MEX_FILE
 #include "reordersequence.h"
 #include "tarjan.h"
+#include "parallelscc.h"
 #else
 #include <opm/core/transport/reorder/reordersequence.h>
 #include <opm/core/transport/reorder/tarjan.h>
+#include <opm/core/transport/reorder/parallelscc.h>
 #endif
 
 #include <algorithm>
 #include <cassert>
 #include <cmath>
+#include <numeric>
 #include <vector>
 
 struct SortByAbsFlux
@@ -29,6 +32,22 @@ struct SortByAbsFlux
 };
 
 
+/* True if face f is an interior face with flow into cell i. */
+static inline int
+is_upwind_face(int           i        ,
+               int           f        ,
+               const int    *face2cell,
+               const double *flux     )
+{
+    const int boundaryface = (face2cell[2*f+0] == -1) ||
+                             (face2cell[2*f+1] == -1);
+    const int positive_sign = (i == face2cell[2*f]);
+    const double theflux = positive_sign ? flux[f] : -flux[f];
+
+    return !boundaryface && (theflux < 0);
+}
+
+
 /* Construct adjacency matrix of upwind graph wrt flux.  Column
    indices are not sorted. */
 // ---------------------------------------------------------------------
@@ -46,17 +65,19 @@ make_upwind_graph(int           nc       ,
     /* Using topology (conn, cptr), and direction, construct adjacency
        matrix of graph. */
 
-    int i, j, p, f, positive_sign, boundaryface;
-    double theflux;
-
-    /* For each face, store upwind cell in work array */
-    for (i=0; i<nc; ++i)
+    /* For each face, store upwind cell in work array.  At most one
+       cell sees a positive flux over a face, so there are no write
+       conflicts. */
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+    for (int i=0; i<nc; ++i)
     {
-        for (j=faceptr[i]; j<faceptr[i+1]; ++j)
+        for (int j=faceptr[i]; j<faceptr[i+1]; ++j)
         {
-            f  = cellfaces[j];
-            positive_sign = (i == face2cell[2*f]);
-            theflux = positive_sign ? flux[f] : -flux[f];
+            const int f  = cellfaces[j];
+            const int positive_sign = (i == face2cell[2*f]);
+            const double theflux = positive_sign ? flux[f] : -flux[f];
 
             if ( theflux > 0  )
             {
@@ -66,32 +87,36 @@ make_upwind_graph(int           nc       ,
         }
     }
 
-    /* Fill ia and ja */
-    p = 0;
-    ia[0] = p;
-    for (i=0; i<nc; ++i)
+    /* Count upwind neighbours of each cell, then fill ia and ja. */
+    ia[0] = 0;
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+    for (int i=0; i<nc; ++i)
     {
-        for (j=faceptr[i]; j<faceptr[i+1]; ++j)
+        int n = 0;
+        for (int j=faceptr[i]; j<faceptr[i+1]; ++j)
         {
+            n += is_upwind_face(i, cellfaces[j], face2cell, flux);
+        }
+        ia[i+1] = n;
+    }
+    std::partial_sum(ia, ia + nc + 1, ia);
 
-            f  = cellfaces[j];
-            boundaryface = (face2cell[2*f+0] == -1) ||
-                           (face2cell[2*f+1] == -1);
-
-            if ( boundaryface )
-            {
-                continue;
-            }
-
-            positive_sign = (i == face2cell[2*f]);
-            theflux = positive_sign ? flux[f] : -flux[f];
-
-            if ( theflux < 0)
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+    for (int i=0; i<nc; ++i)
+    {
+        int p = ia[i];
+        for (int j=faceptr[i]; j<faceptr[i+1]; ++j)
+        {
+            const int f = cellfaces[j];
+            if (is_upwind_face(i, f, face2cell, flux))
             {
                 ja[p++] = work[f];
             }
         }
-        ia[i+1] = p;
     }
 }
 
@@ -106,13 +131,18 @@ compute_reorder_sequence_graph(int           nc,
                                int          *sequence,
                                int          *components,
                                int          *ncomponents,
-                               int *ia, int *ja, int* work)
+                               int *ia, int *ja, int* work,
+                               int           parallel)
 // ---------------------------------------------------------------------
 {
     make_upwind_graph(nc, cellfaces, facepos, face2cell,
                       flux, ia, ja, work);
 
-    tarjan (nc, ia, ja, sequence, components, ncomponents, work);
+    if (parallel) {
+        parallel_scc(nc, ia, ja, sequence, components, ncomponents);
+    } else {
+        tarjan (nc, ia, ja, sequence, components, ncomponents, work);
+    }
 
     assert (0 < *ncomponents);
     assert (*ncomponents <= nc);
@@ -144,7 +174,35 @@ compute_sequence(const struct UnstructuredGrid* grid       ,
                                    sequence,
                                    components,
                                    ncomponents,
-                                   & ia[0], & ja[0], & work[0]);
+                                   & ia[0], & ja[0], & work[0], 0);
+}
+
+
+// ---------------------------------------------------------------------
+void
+compute_sequence_parallel(const struct UnstructuredGrid* grid       ,
+                          const double*                  flux       ,
+                          int*                           sequence   ,
+                          int*                           components ,
+                          int*                           ncomponents)
+// ---------------------------------------------------------------------
+{
+    const std::size_t nc = grid->number_of_cells;
+    const std::size_t nf = grid->number_of_faces;
+
+    std::vector<int> work(nf);
+    std::vector<int> ia  (nc + 1);
+    std::vector<int> ja  (nf);  // A bit too much.
+
+    compute_reorder_sequence_graph(grid->number_of_cells,
+                                   grid->cell_faces,
+                                   grid->cell_facepos,
+                                   grid->face_cells,
+                                   flux,
+                                   sequence,
+                                   components,
+                                   ncomponents,
+                                   & ia[0], & ja[0], & work[0], 1);
 }
 
 
@@ -173,7 +231,7 @@ compute_sequence_graph(const struct UnstructuredGrid* grid       ,
                                    sequence,
                                    components,
                                    ncomponents,
-                                   ia, ja, & work[0]);
+                                   ia, ja, & work[0], 0);
 }
 
 
@@ -71,6 +71,24 @@ compute_sequence(const struct UnstructuredGrid *grid       ,
                  int                           *ncomponents);
 
 
+/**
+ * Compute causal permutation sequence of grid cells with respect to
+ * specific Darcy flux field, using the parallel strongly connected
+ * component algorithm parallel_scc() instead of tarjan().
+ *
+ * Parameters and output are as for compute_sequence(), except that
+ * the components of equal topological level are sorted by their
+ * smallest cell and the cells of each component are in increasing
+ * order, independently of the number of threads.
+ */
+void
+compute_sequence_parallel(const struct UnstructuredGrid *grid       ,
+                          const double                  *flux       ,
+                          int                           *sequence   ,
+                          int                           *components ,
+                          int                           *ncomponents);
+
+
 /**
  * Compute causal permutation sequence of grid cells with respect to
  * specific Darcy flux field.  Also return the permuted upwind graph.
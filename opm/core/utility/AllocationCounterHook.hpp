@@ -0,0 +1,50 @@
+/*
+  Copyright 2015 SINTEF ICT, Applied Mathematics.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OPM_ALLOCATIONCOUNTERHOOK_HEADER_INCLUDED
+#define OPM_ALLOCATIONCOUNTERHOOK_HEADER_INCLUDED
+
+// Replacement of the global (non-array) operator new and delete
+// that feeds Opm::AllocationCounter. The array and nothrow forms
+// forward to these by default, so they are counted as well.
+//
+// This header defines functions with external linkage. It must be
+// included in exactly one translation unit of a program, typically
+// the one containing main(), and never from a library.
+
+#include <opm/core/utility/MemoryUsage.hpp>
+#include <cstdlib>
+#include <new>
+
+void* operator new(std::size_t bytes)
+{
+    Opm::AllocationCounter::recordAllocation(bytes);
+    void* p = std::malloc(bytes == 0 ? 1 : bytes);
+    if (p == 0) {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+void operator delete(void* p) noexcept
+{
+    std::free(p);
+}
+
+#endif // OPM_ALLOCATIONCOUNTERHOOK_HEADER_INCLUDED
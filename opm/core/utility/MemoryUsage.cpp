@@ -0,0 +1,92 @@
+/*
+  Copyright 2015 SINTEF ICT, Applied Mathematics.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#if HAVE_CONFIG_H
+#include "config.h"
+#endif
+#include <opm/core/utility/MemoryUsage.hpp>
+#include <opm/core/grid.h>
+#include <opm/core/wells.h>
+#include <atomic>
+
+namespace Opm
+{
+
+    std::size_t memoryUsage(const UnstructuredGrid& grid)
+    {
+        return grid_memory_usage(&grid);
+    }
+
+
+    std::size_t memoryUsage(const Wells& wells)
+    {
+        return wells_memory_usage(&wells);
+    }
+
+
+    namespace
+    {
+        // Plain statics with constant initialisation, so that they
+        // are usable from operator new before main() starts.
+        std::atomic<bool> counting_enabled(false);
+        std::atomic<unsigned long> allocation_count(0);
+        std::atomic<unsigned long> allocated_bytes(0);
+    }
+
+
+    void AllocationCounter::enable(const bool on)
+    {
+        counting_enabled.store(on, std::memory_order_relaxed);
+    }
+
+
+    bool AllocationCounter::enabled()
+    {
+        return counting_enabled.load(std::memory_order_relaxed);
+    }
+
+
+    void AllocationCounter::recordAllocation(const std::size_t bytes)
+    {
+        if (counting_enabled.load(std::memory_order_relaxed)) {
+            allocation_count.fetch_add(1, std::memory_order_relaxed);
+            allocated_bytes.fetch_add(bytes, std::memory_order_relaxed);
+        }
+    }
+
+
+    unsigned long AllocationCounter::allocations()
+    {
+        return allocation_count.load(std::memory_order_relaxed);
+    }
+
+
+    unsigned long AllocationCounter::bytesAllocated()
+    {
+        return allocated_bytes.load(std::memory_order_relaxed);
+    }
+
+
+    void AllocationCounter::reset()
+    {
+        allocation_count.store(0, std::memory_order_relaxed);
+        allocated_bytes.store(0, std::memory_order_relaxed);
+    }
+
+} // namespace Opm
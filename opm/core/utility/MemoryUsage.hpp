@@ -0,0 +1,104 @@
+/*
+  Copyright 2015 SINTEF ICT, Applied Mathematics.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OPM_MEMORYUSAGE_HEADER_INCLUDED
+#define OPM_MEMORYUSAGE_HEADER_INCLUDED
+
+#include <cstddef>
+#include <vector>
+
+struct UnstructuredGrid;
+struct Wells;
+
+namespace Opm
+{
+
+    /// Interface for objects that can report how much memory they own.
+    /// Only dynamically allocated storage is counted, and observed
+    /// objects (such as the grid or property objects held by
+    /// reference) are not included.
+    class MemoryUsageInterface
+    {
+    public:
+        virtual ~MemoryUsageInterface() {}
+
+        /// \return number of bytes of storage owned by this object.
+        virtual std::size_t memoryUsage() const = 0;
+    };
+
+
+    /// \return number of bytes allocated by a vector (its capacity).
+    template <typename T, class A>
+    inline std::size_t memoryUsage(const std::vector<T, A>& v)
+    {
+        return v.capacity() * sizeof(T);
+    }
+
+    /// \return number of bytes allocated by a vector of vectors,
+    ///         including the storage of the inner vectors.
+    template <typename T, class A, class B>
+    inline std::size_t memoryUsage(const std::vector<std::vector<T, A>, B>& v)
+    {
+        std::size_t bytes = v.capacity() * sizeof(std::vector<T, A>);
+        for (typename std::vector<std::vector<T, A>, B>::const_iterator it = v.begin(); it != v.end(); ++it) {
+            bytes += memoryUsage(*it);
+        }
+        return bytes;
+    }
+
+    /// \return number of bytes allocated by the arrays of a grid.
+    std::size_t memoryUsage(const UnstructuredGrid& grid);
+
+    /// \return number of bytes allocated by a Wells struct,
+    ///         including its well controls.
+    std::size_t memoryUsage(const Wells& wells);
+
+
+    /// Global counter of heap allocations.
+    ///
+    /// The counter is only updated by calls to recordAllocation(),
+    /// which are made by the global operator new replacement in
+    /// AllocationCounterHook.hpp. A program that wants allocation
+    /// counts must include that header in exactly one of its
+    /// translation units, and call enable(). Allocations made with
+    /// malloc() (for example by the C parts of opm-core) are not
+    /// counted.
+    class AllocationCounter
+    {
+    public:
+        /// Turn counting on or off. Counting is off by default.
+        static void enable(const bool on = true);
+        /// \return true if counting is on.
+        static bool enabled();
+        /// Register a single allocation of the given size.
+        /// Does nothing unless counting is on.
+        static void recordAllocation(const std::size_t bytes);
+        /// \return number of allocations registered since start or
+        ///         last call to reset().
+        static unsigned long allocations();
+        /// \return number of bytes allocated since start or last
+        ///         call to reset().
+        static unsigned long bytesAllocated();
+        /// Set allocation and byte counts to zero.
+        static void reset();
+    };
+
+} // namespace Opm
+
+#endif // OPM_MEMORYUSAGE_HEADER_INCLUDED
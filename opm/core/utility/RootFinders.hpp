@@ -42,6 +42,7 @@
 #include <limits>
 #include <cmath>
 #include <iostream>
+#include <vector>
 
 namespace Opm
 {
@@ -280,7 +281,228 @@ namespace Opm
         }
 
 
+        /// Solves n independent equations f_i(x_i) = 0 by the same
+        /// 'Pegasus' iteration as solve(), advancing all brackets
+        /// in lockstep. Problems that have converged are removed
+        /// from the active set after each iteration, so that the
+        /// remaining ones are always stored contiguously. This lets
+        /// the functor evaluate all active problems in one call (for
+        /// example a single property call for a set of cells), and
+        /// lets the compiler vectorise the bracket updates.
+        ///
+        /// The functor is called as f(num, lanes, x, fx), and must
+        /// compute fx[k] = f_{lanes[k]}(x[k]) for k = 0, ..., num-1.
+        ///
+        /// \param[in]  f               Batch functor, see above.
+        /// \param[in]  n               Number of problems.
+        /// \param[in]  a               Lower interval ends, n values.
+        /// \param[in]  b               Upper interval ends, n values.
+        /// \param[in]  max_iter        Maximum number of iterations per problem.
+        /// \param[in]  tolerance       Tolerance as in solve().
+        /// \param[out] x               Roots, n values.
+        /// \param[out] iterations_used Iterations used per problem, n values.
+        template <class BatchFunctor>
+        inline static void solveBatch(const BatchFunctor& f,
+                                      const int n,
+                                      const double* a,
+                                      const double* b,
+                                      const int max_iter,
+                                      const double tolerance,
+                                      double* x,
+                                      int* iterations_used)
+        {
+            solveBatch(f, n, a, a, b, max_iter, tolerance, x, iterations_used);
+        }
+
+
+        /// Batch version of solve() taking an initial guess for each
+        /// problem. See the other overload of solveBatch() for the
+        /// requirements on the functor.
+        template <class BatchFunctor>
+        inline static void solveBatch(const BatchFunctor& f,
+                                      const int n,
+                                      const double* initial_guess,
+                                      const double* a,
+                                      const double* b,
+                                      const int max_iter,
+                                      const double tolerance,
+                                      double* x,
+                                      int* iterations_used)
+        {
+            using namespace std;
+            if (n <= 0) {
+                return;
+            }
+            const double macheps = numeric_limits<double>::epsilon();
+
+            // Packed state of the active problems.
+            BatchState s(n);
+            for (int i = 0; i < n; ++i) {
+                s.lanes[i] = i;
+                s.x0[i] = a[i];
+                s.x1[i] = b[i];
+                s.xeval[i] = initial_guess[i];
+                iterations_used[i] = 0;
+            }
+
+            // Residuals at the initial guesses.
+            f(n, &s.lanes[0], &s.xeval[0], &s.finit[0]);
+            int num = 0;
+            for (int i = 0; i < n; ++i) {
+                const double f_initial = s.finit[i];
+                const double epsF = tolerance + macheps*max(fabs(f_initial), 1.0);
+                if (fabs(f_initial) < epsF) {
+                    x[i] = initial_guess[i];
+                    continue;
+                }
+                s.epsF[i] = epsF;
+                s.eps[i] = tolerance + macheps*max(max(fabs(a[i]), fabs(b[i])), 1.0);
+                s.keep(i, num++);
+            }
+
+            // Residuals at the interval ends, unless given by the
+            // initial guess.
+            num = s.evaluateEnd(f, initial_guess, s.x0, s.f0, num, x);
+            num = s.evaluateEnd(f, initial_guess, s.x1, s.f1, num, x);
+
+            // Set up brackets as in solve().
+            int kept = 0;
+            for (int k = 0; k < num; ++k) {
+                const int i = s.lanes[k];
+                if (s.f0[k]*s.finit[k] < 0.0) {
+                    s.x1[k] = initial_guess[i];
+                    s.f1[k] = s.finit[k];
+                } else {
+                    s.x0[k] = initial_guess[i];
+                    s.f0[k] = s.finit[k];
+                }
+                if (s.f0[k]*s.f1[k] > 0.0) {
+                    x[i] = ErrorPolicy::handleBracketingFailure(a[i], b[i], s.f0[k], s.f1[k]);
+                    continue;
+                }
+                s.keep(k, kept++);
+            }
+            num = kept;
+
+            // In every iteraton, x1 is the last point computed,
+            // and x0 is the last point computed that makes it a
+            // bracket.
+            while (num > 0) {
+                kept = 0;
+                for (int k = 0; k < num; ++k) {
+                    if (fabs(s.x1[k] - s.x0[k]) < 1e-9*s.eps[k]) {
+                        x[s.lanes[k]] = 0.5*(s.x0[k] + s.x1[k]);
+                        continue;
+                    }
+                    s.keep(k, kept++);
+                }
+                num = kept;
+                if (num == 0) {
+                    break;
+                }
+
+                double* xnew = &s.xeval[0];
+                double* fnew = &s.feval[0];
+                for (int k = 0; k < num; ++k) {
+                    xnew[k] = regulaFalsiStep(s.x0[k], s.x1[k], s.f0[k], s.f1[k]);
+                }
+                f(num, &s.lanes[0], xnew, fnew);
+
+                kept = 0;
+                for (int k = 0; k < num; ++k) {
+                    const int i = s.lanes[k];
+                    ++iterations_used[i];
+                    if (iterations_used[i] > max_iter) {
+                        x[i] = ErrorPolicy::handleTooManyIterations(s.x0[k], s.x1[k], max_iter);
+                        continue;
+                    }
+                    if (fabs(fnew[k]) < s.epsF[k]) {
+                        x[i] = xnew[k];
+                        continue;
+                    }
+                    // Pegasus update, written with selects only.
+                    const bool replace_x0 = (fnew[k] > 0.0) == (s.f0[k] > 0.0);
+                    const double gamma = s.f1[k]/(s.f1[k] + fnew[k]);
+                    s.x0[k] = replace_x0 ? s.x1[k] : s.x0[k];
+                    s.f0[k] = replace_x0 ? s.f1[k] : s.f0[k]*gamma;
+                    s.x1[k] = xnew[k];
+                    s.f1[k] = fnew[k];
+                    s.keep(k, kept++);
+                }
+                num = kept;
+            }
+        }
+
+
     private:
+        // Packed per-problem state used by solveBatch().
+        struct BatchState
+        {
+            explicit BatchState(const int n)
+                : lanes(n), x0(n), x1(n), f0(n), f1(n), finit(n),
+                  eps(n), epsF(n), xeval(n), feval(n), pos(n), back(n)
+            {
+            }
+
+            // Move entry 'from' to position 'to' (to <= from).
+            void keep(const int from, const int to)
+            {
+                lanes[to] = lanes[from];
+                x0[to] = x0[from];
+                x1[to] = x1[from];
+                f0[to] = f0[from];
+                f1[to] = f1[from];
+                finit[to] = finit[from];
+                eps[to] = eps[from];
+                epsF[to] = epsF[from];
+            }
+
+            // Compute fend = f(xend) for the first num problems, reusing
+            // the initial guess residual where xend equals the initial
+            // guess. Problems solved at xend are retired, and the new
+            // number of active problems is returned.
+            template <class BatchFunctor>
+            int evaluateEnd(const BatchFunctor& f,
+                            const double* initial_guess,
+                            std::vector<double>& xend,
+                            std::vector<double>& fend,
+                            const int num,
+                            double* x)
+            {
+                int m = 0;
+                for (int k = 0; k < num; ++k) {
+                    if (xend[k] == initial_guess[lanes[k]]) {
+                        fend[k] = finit[k];
+                    } else {
+                        pos[m] = lanes[k];
+                        xeval[m] = xend[k];
+                        back[m] = k;
+                        ++m;
+                    }
+                }
+                if (m > 0) {
+                    f(m, &pos[0], &xeval[0], &feval[0]);
+                    for (int j = 0; j < m; ++j) {
+                        fend[back[j]] = feval[j];
+                    }
+                }
+                int kept = 0;
+                for (int k = 0; k < num; ++k) {
+                    if (std::fabs(fend[k]) < epsF[k]) {
+                        x[lanes[k]] = xend[k];
+                        continue;
+                    }
+                    keep(k, kept++);
+                }
+                return kept;
+            }
+
+            std::vector<int> lanes;
+            std::vector<double> x0, x1, f0, f1, finit, eps, epsF;
+            std::vector<double> xeval, feval;
+            std::vector<int> pos, back;
+        };
+
         inline static double regulaFalsiStep(const double a,
                                              const double b,
                                              const double fa,
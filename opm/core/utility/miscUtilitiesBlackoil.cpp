@@ -308,46 +308,47 @@ namespace Opm
 
         props.matrix(nc, &state.pressure()[0], &state.temperature()[0], &z[0], &allcells[0], &allA[0], 0);
 
-        // Linear solver.
-        MAT_SIZE_T n = np;
-        MAT_SIZE_T nrhs = 1;
-        MAT_SIZE_T lda = np;
-        std::vector<MAT_SIZE_T> piv(np);
-        MAT_SIZE_T ldb = np;
-        MAT_SIZE_T info = 0;
-
-
-        //double res_vol;
-        double tot_sat;
         const double epsilon = std::sqrt(std::numeric_limits<double>::epsilon());
 
-        for (int c = 0; c < nc; ++c) {
-            double* A = &allA[c*np*np];
-            const double* z_loc = &z[c*np];
-            double* s = &state.saturation()[c*np];
-
-            for (int p = 0; p < np; ++p){
-                s[p] = z_loc[p];
+        // The cells are independent; each thread needs its own pivot array.
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+        {
+            // Linear solver.
+            MAT_SIZE_T n = np;
+            MAT_SIZE_T nrhs = 1;
+            MAT_SIZE_T lda = np;
+            std::vector<MAT_SIZE_T> piv(np);
+            MAT_SIZE_T ldb = np;
+            MAT_SIZE_T info = 0;
+
+#ifdef _OPENMP
+#pragma omp for
+#endif
+            for (int c = 0; c < nc; ++c) {
+                double* A = &allA[c*np*np];
+                const double* z_loc = &z[c*np];
+                double* s = &state.saturation()[c*np];
+
+                for (int p = 0; p < np; ++p){
+                    s[p] = z_loc[p];
                 }
 
-            dgesv_(&n, &nrhs, &A[0], &lda, &piv[0], &s[0], &ldb, &info);
+                dgesv_(&n, &nrhs, &A[0], &lda, &piv[0], &s[0], &ldb, &info);
 
-            tot_sat = 0;
-            for (int p = 0; p < np; ++p){
-                if (s[p] < epsilon) // saturation may be less then zero due to round of errors
-                    s[p] = 0;
+                double tot_sat = 0;
+                for (int p = 0; p < np; ++p){
+                    if (s[p] < epsilon) // saturation may be less then zero due to round of errors
+                        s[p] = 0;
 
-                tot_sat += s[p];
-            }
+                    tot_sat += s[p];
+                }
 
-            for (int p = 0; p < np; ++p){
-                s[p]  = s[p]/tot_sat;
+                for (int p = 0; p < np; ++p){
+                    s[p]  = s[p]/tot_sat;
+                }
             }
-
-
-
-
-
         }
 
     }
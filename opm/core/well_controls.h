@@ -20,6 +20,7 @@
 #ifndef OPM_WELL_CONTROLS_H_INCLUDED
 #define OPM_WELL_CONTROLS_H_INCLUDED
 
+#include <stddef.h>
 #include <stdbool.h>
 
 /**
@@ -59,6 +60,9 @@ well_controls_clone(const struct WellControls *ctrl);
 void
 well_controls_destroy(struct WellControls *ctrl);
 
+size_t
+well_controls_memory_usage(const struct WellControls *ctrl);
+
 
 int 
 well_controls_get_num(const struct WellControls *ctrl);
@@ -20,6 +20,7 @@
 #ifndef OPM_WELLS_H_INCLUDED
 #define OPM_WELLS_H_INCLUDED
 
+#include <stddef.h>
 #include <stdbool.h>
 #include <opm/core/well_controls.h>
 
@@ -287,6 +288,20 @@ void
 destroy_wells(struct Wells *W);
 
 
+/**
+ * Compute the number of bytes of dynamically allocated storage held by a
+ * Wells object, including its controls and well names.
+ *
+ * Arrays are accounted at their allocated capacity rather than at the number
+ * of wells and perforations currently in use.
+ *
+ * @param[in] W Existing Wells object.  May be @c NULL.
+ * @return Total storage in bytes.  Zero if @c W is @c NULL.
+ */
+size_t
+wells_memory_usage(const struct Wells *W);
+
+
 /**
  * Create a deep-copy (i.e., clone) of an existing Wells object, including its
  * controls.
@@ -366,6 +366,11 @@ namespace Opm
         return well_collection_;
     }
 
+    std::size_t WellsManager::memoryUsage() const
+    {
+        return wells_memory_usage(w_);
+    }
+
     bool WellsManager::conditionsMet(const std::vector<double>& well_bhp,
                                      const std::vector<double>& well_reservoirrates_phase,
                                      const std::vector<double>& well_surfacerates_phase)
@@ -28,6 +28,7 @@
 #include <opm/parser/eclipse/EclipseState/Schedule/GroupTree.hpp>
 
 #include <opm/core/utility/CompressedPropertyAccess.hpp>
+#include <opm/core/utility/MemoryUsage.hpp>
 
 struct Wells;
 struct UnstructuredGrid;
@@ -56,7 +57,7 @@ namespace Opm
     /// encapsulates creation and destruction of the wells
     /// data structure.
     /// The resulting Wells is available through the c_wells() method.
-    class WellsManager
+    class WellsManager : public MemoryUsageInterface
     {
     public:
         /// Default constructor -- no wells.
@@ -103,6 +104,10 @@ namespace Opm
         /// Access the well group hierarchy.
         const WellCollection& wellCollection() const;
 
+        /// Number of bytes held by the managed Wells struct and its
+        /// controls. The well group hierarchy is not included.
+        virtual std::size_t memoryUsage() const;
+
         /// Checks if each condition is met, applies well controls where needed
         /// (that is, it either changes the active control of violating wells, or shuts
         /// down wells). Only one change is applied per invocation. Typical use will be
@@ -133,6 +133,30 @@ well_controls_destroy(struct WellControls *ctrl)
 }
 
 
+/* ---------------------------------------------------------------------- */
+size_t
+well_controls_memory_usage(const struct WellControls *ctrl)
+/* ---------------------------------------------------------------------- */
+{
+    size_t nbytes, nctrl;
+
+    if (ctrl == NULL) {
+        return 0;
+    }
+
+    nctrl   = ctrl->cpty;
+
+    nbytes  = sizeof *ctrl;
+    nbytes += nctrl * sizeof *ctrl->type;
+    nbytes += nctrl * sizeof *ctrl->target;
+    nbytes += nctrl * sizeof *ctrl->alq;
+    nbytes += nctrl * sizeof *ctrl->vfp;
+    nbytes += nctrl * ctrl->number_of_phases * sizeof *ctrl->distr;
+
+    return nbytes;
+}
+
+
 /* ---------------------------------------------------------------------- */
 struct WellControls *
 well_controls_create(void)
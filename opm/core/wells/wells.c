@@ -338,6 +338,50 @@ destroy_wells(struct Wells *W)
 }
 
 
+/* ---------------------------------------------------------------------- */
+size_t
+wells_memory_usage(const struct Wells *W)
+/* ---------------------------------------------------------------------- */
+{
+    int    w;
+    size_t nbytes, nw, np, nperf;
+
+    const struct WellMgmt *m;
+
+    if (W == NULL) {
+        return 0;
+    }
+
+    m     = W->data;
+    nw    = m->well_cpty;
+    nperf = m->perf_cpty;
+    np    = W->number_of_phases;
+
+    nbytes  = sizeof *W + sizeof *m;
+
+    nbytes += nw       * sizeof *W->type;
+    nbytes += nw       * sizeof *W->depth_ref;
+    nbytes += nw * np  * sizeof *W->comp_frac;
+    nbytes += (nw + 1) * sizeof *W->well_connpos;
+    nbytes += nw       * sizeof *W->ctrls;
+    nbytes += nw       * sizeof *W->name;
+    nbytes += nw       * sizeof *W->allow_cf;
+
+    nbytes += nperf    * sizeof *W->well_cells;
+    nbytes += nperf    * sizeof *W->WI;
+
+    for (w = 0; w < m->well_cpty; w++) {
+        nbytes += well_controls_memory_usage(W->ctrls[w]);
+
+        if (W->name[w] != NULL) {
+            nbytes += strlen(W->name[w]) + 1;
+        }
+    }
+
+    return nbytes;
+}
+
+
 /* ---------------------------------------------------------------------- */
 static int
 alloc_size(int n, int a, int cpty)
@@ -0,0 +1,145 @@
+/*
+  Copyright 2015 SINTEF ICT, Applied Mathematics.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "config.h"
+
+/* --- Boost.Test boilerplate --- */
+#if HAVE_DYNAMIC_BOOST_TEST
+#define BOOST_TEST_DYN_LINK
+#endif
+
+#define NVERBOSE  // Suppress own messages when throw()ing
+
+#define BOOST_TEST_MODULE CellHaloExchangeTest
+#include <boost/test/unit_test.hpp>
+
+/* --- our own headers --- */
+#include <opm/core/grid/GridPartition.hpp>
+#include <opm/core/grid/cart_grid.h>
+#include <opm/core/grid.h>
+#include <opm/core/simulator/SimulatorState.hpp>
+
+#include <memory>
+#include <vector>
+
+// Runs on any number of processes, rank p handling part p. With a
+// single process there are no ghost cells, so run it under mpirun
+// with several processes to exercise the communication.
+
+struct MPIFixture {
+    MPIFixture()
+    {
+        int m_argc = boost::unit_test::framework::master_test_suite().argc;
+        char** m_argv = boost::unit_test::framework::master_test_suite().argv;
+        MPI_Init(&m_argc, &m_argv);
+    }
+    ~MPIFixture()
+    {
+        MPI_Finalize();
+    }
+};
+
+BOOST_GLOBAL_FIXTURE(MPIFixture);
+
+using namespace Opm;
+
+namespace
+{
+    typedef std::unique_ptr<UnstructuredGrid, void(*)(UnstructuredGrid*)> GridPtr;
+
+    /// Subdomain of this rank in a 13x11 grid partitioned over all ranks.
+    std::unique_ptr<SubdomainGrid> localSubdomain(const UnstructuredGrid& grid)
+    {
+        int rank, size;
+        MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+        MPI_Comm_size(MPI_COMM_WORLD, &size);
+        std::vector<int> cell_part;
+        partitionCellGraph(grid, size, cell_part);
+        return std::unique_ptr<SubdomainGrid>(new SubdomainGrid(grid, cell_part, rank));
+    }
+
+    double cellValue(const int global_cell, const int component)
+    {
+        return 10.0*global_cell + component;
+    }
+}
+
+BOOST_AUTO_TEST_CASE(ghostsGetOwnerValues)
+{
+    GridPtr grid(create_grid_cart2d(13, 11, 1.0, 1.0), destroy_grid);
+    std::unique_ptr<SubdomainGrid> sub = localSubdomain(*grid);
+    const std::vector<int>& gc = sub->globalCell();
+    const int nlc = gc.size();
+    CellHaloExchange halo(*sub, MPI_COMM_WORLD);
+
+    int num_ghosts = nlc - sub->numOwnedCells();
+    int total_ghosts = 0;
+    MPI_Allreduce(&num_ghosts, &total_ghosts, 1, MPI_INT, MPI_SUM, MPI_COMM_WORLD);
+    int size;
+    MPI_Comm_size(MPI_COMM_WORLD, &size);
+    BOOST_CHECK_EQUAL(total_ghosts > 0, size > 1);
+
+    for (int ncomp = 1; ncomp <= 3; ++ncomp) {
+        std::vector<double> field(ncomp*nlc, -1.0);
+        for (int lc = 0; lc < sub->numOwnedCells(); ++lc) {
+            for (int k = 0; k < ncomp; ++k) {
+                field[ncomp*lc + k] = cellValue(gc[lc], k);
+            }
+        }
+        halo.exchange(field);
+        for (int lc = 0; lc < nlc; ++lc) {
+            for (int k = 0; k < ncomp; ++k) {
+                BOOST_CHECK_EQUAL(field[ncomp*lc + k], cellValue(gc[lc], k));
+            }
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(stateCellDataIsExchanged)
+{
+    GridPtr grid(create_grid_cart3d(6, 5, 4), destroy_grid);
+    std::unique_ptr<SubdomainGrid> sub = localSubdomain(*grid);
+    const std::vector<int>& gc = sub->globalCell();
+    const UnstructuredGrid& lg = *sub->c_grid();
+    const int nlc = lg.number_of_cells;
+    CellHaloExchange halo(*sub, MPI_COMM_WORLD);
+
+    SimulatorState state;
+    state.init(nlc, lg.number_of_faces, 2);
+    for (int lc = 0; lc < nlc; ++lc) {
+        const bool owned = lc < sub->numOwnedCells();
+        state.pressure()[lc] = owned ? cellValue(gc[lc], 0) : -1.0;
+        state.saturation()[2*lc] = owned ? cellValue(gc[lc], 1) : -1.0;
+        state.saturation()[2*lc + 1] = owned ? cellValue(gc[lc], 2) : -1.0;
+    }
+    std::vector<double>& flux = state.faceflux();
+    for (int f = 0; f < lg.number_of_faces; ++f) {
+        flux[f] = f;
+    }
+    halo.exchange(state);
+    for (int lc = 0; lc < nlc; ++lc) {
+        BOOST_CHECK_EQUAL(state.pressure()[lc], cellValue(gc[lc], 0));
+        BOOST_CHECK_EQUAL(state.saturation()[2*lc], cellValue(gc[lc], 1));
+        BOOST_CHECK_EQUAL(state.saturation()[2*lc + 1], cellValue(gc[lc], 2));
+    }
+    // Face data is not part of the halo exchange.
+    for (int f = 0; f < lg.number_of_faces; ++f) {
+        BOOST_CHECK_EQUAL(flux[f], double(f));
+    }
+}
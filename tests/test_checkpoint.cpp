@@ -0,0 +1,185 @@
+/*
+  Copyright 2015 SINTEF ICT, Applied Mathematics.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "config.h"
+
+/* --- Boost.Test boilerplate --- */
+#if HAVE_DYNAMIC_BOOST_TEST
+#define BOOST_TEST_DYN_LINK
+#endif
+
+#define NVERBOSE  // Suppress own messages when throw()ing
+
+#define BOOST_TEST_MODULE CheckpointTest
+#include <boost/test/unit_test.hpp>
+
+/* --- our own headers --- */
+#include <opm/core/io/checkpoint/Checkpoint.hpp>
+#include <opm/core/simulator/BlackoilState.hpp>
+#include <opm/core/simulator/WellState.hpp>
+#include <opm/core/simulator/SimulatorTimerInterface.hpp>
+
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+namespace
+{
+    struct FakeTimer : public Opm::SimulatorTimerInterface
+    {
+        int step;
+        double elapsed;
+
+        FakeTimer( const int s, const double t ) : step( s ), elapsed( t ) {}
+
+        int currentStepNum() const { return step; }
+        double currentStepLength() const { return 86400.0; }
+        double stepLengthTaken() const { return 86400.0; }
+        double simulationTimeElapsed() const { return elapsed; }
+        void advance() { ++step; elapsed += 86400.0; }
+        bool done() const { return false; }
+        boost::posix_time::ptime startDateTime() const
+        {
+            return boost::posix_time::ptime( boost::gregorian::date( 2015, 1, 1 ) );
+        }
+    };
+
+    void fillState( Opm::BlackoilState& state, Opm::WellState& wellState, const int nc, const int nf )
+    {
+        state.init( nc, nf, 3 );
+        for( int c = 0; c < nc; ++c ) {
+            state.pressure()[ c ] = 1e7 + std::sin( 0.1 * c ) * 1e5;
+            state.temperature()[ c ] = 273.15 + 1.0 / ( c + 3.0 );
+            state.gasoilratio()[ c ] = c < nc / 2 ? 100.0 : 0.0;
+            state.rv()[ c ] = std::numeric_limits<double>::denorm_min() * c;
+            for( int p = 0; p < 3; ++p ) {
+                state.saturation()[ 3*c + p ] = ( p + 1.0 ) / 6.0 + 1e-3 * std::cos( double( c * p ) );
+            }
+        }
+        for( int f = 0; f < nf; ++f ) {
+            state.faceflux()[ f ] = -1e-5 * f / 7.0;
+            state.facepressure()[ f ] = 1e7 - f;
+        }
+        wellState.bhp().assign( 2, 2e7 );
+        wellState.bhp()[ 1 ] = 1.5e7;
+        wellState.thp().assign( 2, 1e5 );
+        wellState.temperature().assign( 2, 300.0 );
+        wellState.wellRates().assign( 6, -1.0 / 3.0 );
+        wellState.perfRates().assign( 5, 1.0 / 7.0 );
+        wellState.perfPress().assign( 5, 2.1e7 );
+    }
+
+    void checkEqual( const Opm::BlackoilState& a, const Opm::WellState& wa,
+                     const Opm::BlackoilState& b, const Opm::WellState& wb )
+    {
+        for( std::size_t i = 0; i < a.cellData().size(); ++i ) {
+            BOOST_CHECK( a.cellData()[ i ] == b.cellData()[ i ] );
+        }
+        for( std::size_t i = 0; i < a.faceData().size(); ++i ) {
+            BOOST_CHECK( a.faceData()[ i ] == b.faceData()[ i ] );
+        }
+        BOOST_CHECK( wa.bhp() == wb.bhp() );
+        BOOST_CHECK( wa.thp() == wb.thp() );
+        BOOST_CHECK( wa.temperature() == wb.temperature() );
+        BOOST_CHECK( wa.wellRates() == wb.wellRates() );
+        BOOST_CHECK( wa.perfRates() == wb.perfRates() );
+        BOOST_CHECK( wa.perfPress() == wb.perfPress() );
+    }
+
+    std::streamoff fileSize( const std::string& filename )
+    {
+        std::ifstream file( filename.c_str(), std::ios::binary | std::ios::ate );
+        return file.tellg();
+    }
+}
+
+BOOST_AUTO_TEST_CASE(roundTripIsExact)
+{
+    const int nc = 200, nf = 420;
+    Opm::BlackoilState state;
+    Opm::WellState wellState;
+    fillState( state, wellState, nc, nf );
+    const FakeTimer timer( 7, 7 * 86400.0 );
+
+    const std::string raw = "test_checkpoint_raw.ockp";
+    const std::string compressed = "test_checkpoint_compressed.ockp";
+    Opm::writeCheckpoint( raw, timer, state, wellState, false );
+    Opm::writeCheckpoint( compressed, timer, state, wellState, true );
+    BOOST_CHECK_LT( fileSize( compressed ), fileSize( raw ) );
+
+    for( int i = 0; i < 2; ++i ) {
+        Opm::BlackoilState restored;
+        restored.init( nc, nf, 3 );
+        Opm::WellState restoredWells;
+        const Opm::CheckpointTime time =
+            Opm::readCheckpoint( i == 0 ? raw : compressed, restored, restoredWells );
+        BOOST_CHECK_EQUAL( time.stepNum, 7 );
+        BOOST_CHECK_EQUAL( time.elapsed, 7 * 86400.0 );
+        BOOST_CHECK_EQUAL( time.stepLength, 86400.0 );
+        checkEqual( state, wellState, restored, restoredWells );
+    }
+
+    // A state of a different size is rejected.
+    Opm::BlackoilState other;
+    other.init( nc + 1, nf, 3 );
+    Opm::WellState otherWells;
+    BOOST_CHECK_THROW( Opm::readCheckpoint( raw, other, otherWells ), std::runtime_error );
+
+    std::remove( raw.c_str() );
+    std::remove( compressed.c_str() );
+}
+
+BOOST_AUTO_TEST_CASE(asynchronousWriter)
+{
+    const int nc = 1000, nf = 2100;
+    Opm::BlackoilState state;
+    Opm::WellState wellState;
+    fillState( state, wellState, nc, nf );
+
+    const std::string filename = "test_checkpoint_async.ockp";
+    Opm::BlackoilState written;
+    {
+        Opm::CheckpointWriter writer( filename, 2, true, true );
+        FakeTimer timer( 0, 0.0 );
+        for( int step = 1; step <= 5; ++step ) {
+            timer.advance();
+            state.pressure()[ 0 ] = step;
+            writer.writeTimeStep( timer, state, wellState, false );
+            if( step == 4 ) {
+                written = state;
+            }
+            // substeps are never checkpointed
+            writer.writeTimeStep( timer, state, wellState, true );
+        }
+        writer.wait();
+    }
+
+    Opm::BlackoilState restored;
+    restored.init( nc, nf, 3 );
+    Opm::WellState restoredWells;
+    const Opm::CheckpointTime time = Opm::readCheckpoint( filename, restored, restoredWells );
+    BOOST_CHECK_EQUAL( time.stepNum, 4 );
+    BOOST_CHECK_EQUAL( restored.pressure()[ 0 ], 4.0 );
+    checkEqual( written, wellState, restored, restoredWells );
+
+    std::remove( filename.c_str() );
+}
@@ -0,0 +1,431 @@
+/*
+  Copyright 2015 SINTEF ICT, Applied Mathematics.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "config.h"
+
+/* --- Boost.Test boilerplate --- */
+#if HAVE_DYNAMIC_BOOST_TEST
+#define BOOST_TEST_DYN_LINK
+#endif
+
+#define NVERBOSE  // Suppress own messages when throw()ing
+
+#define BOOST_TEST_MODULE CompressibleTpfaTest
+#include <boost/test/unit_test.hpp>
+
+/* --- our own headers --- */
+#include <opm/core/grid.h>
+#include <opm/core/grid/cart_grid.h>
+#include <opm/core/wells.h>
+#include <opm/core/well_controls.h>
+#include <opm/core/linalg/LinearSolverInterface.hpp>
+#include <opm/core/pressure/CompressibleTpfa.hpp>
+#include <opm/core/props/BlackoilPropertiesBasic.hpp>
+#include <opm/core/simulator/BlackoilState.hpp>
+#include <opm/core/simulator/WellState.hpp>
+#include <opm/core/utility/parameters/ParameterGroup.hpp>
+#include <opm/core/utility/Units.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <memory>
+#include <numeric>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace
+{
+    /// Dense Gaussian elimination with partial pivoting. Records the
+    /// size of the systems it is given.
+    class DenseSolver : public Opm::LinearSolverInterface
+    {
+    public:
+        using Opm::LinearSolverInterface::solve;
+
+        virtual LinearSolverReport solve(const int size,
+                                         const int /* nonzeros */,
+                                         const int* ia,
+                                         const int* ja,
+                                         const double* sa,
+                                         const double* rhs,
+                                         double* solution,
+                                         const boost::any& /* add */) const
+        {
+            sizes.push_back(size);
+            std::vector<double> a(size*size, 0.0);
+            std::vector<double> x(rhs, rhs + size);
+            for (int row = 0; row < size; ++row) {
+                for (int k = ia[row]; k < ia[row + 1]; ++k) {
+                    a[row*size + ja[k]] += sa[k];
+                }
+            }
+            for (int col = 0; col < size; ++col) {
+                int pivot = col;
+                for (int row = col + 1; row < size; ++row) {
+                    if (std::fabs(a[row*size + col]) > std::fabs(a[pivot*size + col])) {
+                        pivot = row;
+                    }
+                }
+                for (int k = 0; k < size; ++k) {
+                    std::swap(a[col*size + k], a[pivot*size + k]);
+                }
+                std::swap(x[col], x[pivot]);
+                for (int row = col + 1; row < size; ++row) {
+                    const double factor = a[row*size + col]/a[col*size + col];
+                    for (int k = col; k < size; ++k) {
+                        a[row*size + k] -= factor*a[col*size + k];
+                    }
+                    x[row] -= factor*x[col];
+                }
+            }
+            for (int row = size - 1; row >= 0; --row) {
+                for (int k = row + 1; k < size; ++k) {
+                    x[row] -= a[row*size + k]*x[k];
+                }
+                solution[row] = x[row]/a[row*size + row];
+            }
+            LinearSolverReport rep = {};
+            rep.converged = true;
+            return rep;
+        }
+
+        virtual void setTolerance(const double /* tol */) {}
+
+        virtual double getTolerance() const { return -1.0; }
+
+        mutable std::vector<int> sizes;
+    };
+
+    /// Jacobi preconditioned BiCGStab with a relative residual
+    /// tolerance, starting from zero. Counts its iterations.
+    class BiCGStabSolver : public Opm::LinearSolverInterface
+    {
+    public:
+        explicit BiCGStabSolver(const double tol) : tol_(tol), max_tolerance_(0.0) {}
+
+        using Opm::LinearSolverInterface::solve;
+
+        virtual LinearSolverReport solve(const int size,
+                                         const int /* nonzeros */,
+                                         const int* ia,
+                                         const int* ja,
+                                         const double* sa,
+                                         const double* rhs,
+                                         double* solution,
+                                         const boost::any& /* add */) const
+        {
+            max_tolerance_ = std::max(max_tolerance_, tol_);
+            std::vector<double> dinv(size, 1.0);
+            for (int row = 0; row < size; ++row) {
+                for (int k = ia[row]; k < ia[row + 1]; ++k) {
+                    if (ja[k] == row && sa[k] != 0.0) {
+                        dinv[row] = 1.0/sa[k];
+                    }
+                }
+            }
+            auto mult = [&](const std::vector<double>& x, std::vector<double>& y) {
+                for (int row = 0; row < size; ++row) {
+                    double sum = 0.0;
+                    for (int k = ia[row]; k < ia[row + 1]; ++k) {
+                        sum += sa[k]*x[ja[k]];
+                    }
+                    y[row] = sum;
+                }
+            };
+            auto dot = [](const std::vector<double>& a, const std::vector<double>& b) {
+                return std::inner_product(a.begin(), a.end(), b.begin(), 0.0);
+            };
+            std::vector<double> x(size, 0.0), r(rhs, rhs + size), r0(r), p(size, 0.0), v(size, 0.0);
+            std::vector<double> y(size), s(size), z(size), t(size);
+            const double bnorm = std::sqrt(dot(r, r));
+            double rho = 1.0, alpha = 1.0, omega = 1.0;
+            LinearSolverReport rep = {};
+            while (std::sqrt(dot(r, r)) > tol_*bnorm && rep.iterations < 10*size) {
+                const double rho_new = dot(r0, r);
+                const double beta = (rho_new/rho)*(alpha/omega);
+                rho = rho_new;
+                for (int i = 0; i < size; ++i) {
+                    p[i] = r[i] + beta*(p[i] - omega*v[i]);
+                    y[i] = dinv[i]*p[i];
+                }
+                mult(y, v);
+                alpha = rho/dot(r0, v);
+                for (int i = 0; i < size; ++i) {
+                    s[i] = r[i] - alpha*v[i];
+                    z[i] = dinv[i]*s[i];
+                }
+                mult(z, t);
+                omega = dot(t, s)/dot(t, t);
+                for (int i = 0; i < size; ++i) {
+                    x[i] += alpha*y[i] + omega*z[i];
+                    r[i] = s[i] - omega*t[i];
+                }
+                ++rep.iterations;
+            }
+            std::copy(x.begin(), x.end(), solution);
+            rep.converged = std::sqrt(dot(r, r)) <= tol_*bnorm;
+            rep.residual_reduction = bnorm > 0.0 ? std::sqrt(dot(r, r))/bnorm : 0.0;
+            return rep;
+        }
+
+        virtual void setTolerance(const double tol) { tol_ = tol; }
+
+        virtual double getTolerance() const { return tol_; }
+
+        /// Loosest tolerance any solve was done with.
+        double maxTolerance() const { return max_tolerance_; }
+
+    private:
+        double tol_;
+        mutable double max_tolerance_;
+    };
+
+    /// Basic properties with exponentially pressure dependent
+    /// formation volume factors, 1/B = exp(c (p - p_ref)).
+    class ExponentialCompressibility : public Opm::BlackoilPropertiesBasic
+    {
+    public:
+        ExponentialCompressibility(const Opm::parameter::ParameterGroup& param,
+                                   const int num_cells, const double c, const double p_ref)
+            : Opm::BlackoilPropertiesBasic(param, 2, num_cells), c_(c), p_ref_(p_ref)
+        {}
+
+        virtual void matrix(const int n,
+                            const double* p,
+                            const double* /* T */,
+                            const double* /* z */,
+                            const int* /* cells */,
+                            double* A,
+                            double* dAdp) const
+        {
+            for (int i = 0; i < n; ++i) {
+                const double b = std::exp(c_*(p[i] - p_ref_));
+                std::fill(A + 4*i, A + 4*i + 4, 0.0);
+                A[4*i] = A[4*i + 3] = b;
+                if (dAdp) {
+                    std::fill(dAdp + 4*i, dAdp + 4*i + 4, 0.0);
+                    dAdp[4*i] = dAdp[4*i + 3] = c_*b;
+                }
+            }
+        }
+
+    private:
+        double c_;
+        double p_ref_;
+    };
+
+    struct WellsDeleter
+    {
+        void operator()(Wells* w) const { destroy_wells(w); }
+    };
+
+    struct GridDeleter
+    {
+        void operator()(UnstructuredGrid* g) const { destroy_grid(g); }
+    };
+
+    /// A rate controlled injector with three perforations and a bhp
+    /// controlled producer with two perforations.
+    std::unique_ptr<Wells, WellsDeleter> createWells()
+    {
+        using namespace Opm::unit;
+        std::unique_ptr<Wells, WellsDeleter> wells(create_wells(2, 2, 5));
+        const double inj_frac[] = { 1.0, 0.0 };
+        const int inj_cells[] = { 0, 1, 5 };
+        const double inj_wi[] = { 1e-11, 2e-11, 1e-11 };
+        add_well(INJECTOR, 0.0, 3, inj_frac, inj_cells, inj_wi, "INJ", 1, wells.get());
+        append_well_controls(RESERVOIR_RATE, 10.0*cubic(meter)/day, 0.0, 0, inj_frac, 0, wells.get());
+        set_current_control(0, 0, wells.get());
+        const int prod_cells[] = { 23, 24 };
+        const double prod_wi[] = { 1e-11, 1e-11 };
+        add_well(PRODUCER, 0.0, 2, NULL, prod_cells, prod_wi, "PROD", 1, wells.get());
+        append_well_controls(BHP, 100.0*barsa, 0.0, 0, NULL, 1, wells.get());
+        set_current_control(1, 0, wells.get());
+        return wells;
+    }
+
+    std::pair<Opm::BlackoilState, Opm::WellState>
+    solvePressure(const bool well_schur, std::vector<int>& sizes)
+    {
+        using namespace Opm::unit;
+        std::unique_ptr<UnstructuredGrid, GridDeleter> grid(create_grid_cart2d(5, 5, 10.0, 10.0));
+        Opm::parameter::ParameterGroup param;
+        param.insertParameter("num_phases", "2");
+        param.insertParameter("relperm_func", "Quadratic");
+        param.insertParameter("porosity", "0.2");
+        Opm::BlackoilPropertiesBasic props(param, 2, grid->number_of_cells);
+        std::unique_ptr<Wells, WellsDeleter> wells = createWells();
+
+        Opm::BlackoilState state;
+        state.init(*grid, 2);
+        for (int c = 0; c < grid->number_of_cells; ++c) {
+            state.pressure()[c] = 150.0*barsa;
+            state.saturation()[2*c] = 0.3;
+            state.saturation()[2*c + 1] = 0.7;
+        }
+        // The basic fluids have unit formation volume factors.
+        state.surfacevol() = state.saturation();
+        Opm::WellState well_state;
+        well_state.init(wells.get(), state);
+
+        DenseSolver linsolver;
+        Opm::CompressibleTpfa psolver(*grid, props, 0, linsolver, 1e-9, 1e-3, 20,
+                                      0, wells.get(), 0.0, 0, well_schur);
+        psolver.solve(1.0*day, state, well_state);
+        sizes = linsolver.sizes;
+        return std::make_pair(state, well_state);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(WellSchurMatchesBorderedSystem)
+{
+    std::vector<int> bordered_sizes, schur_sizes;
+    const auto bordered = solvePressure(false, bordered_sizes);
+    const auto schur = solvePressure(true, schur_sizes);
+
+    // The bhp well is eliminated, the rate controlled multi-perforation
+    // well is kept in the system.
+    BOOST_REQUIRE(!bordered_sizes.empty());
+    BOOST_REQUIRE(!schur_sizes.empty());
+    for (std::size_t i = 0; i < bordered_sizes.size(); ++i) {
+        BOOST_CHECK_EQUAL(bordered_sizes[i], 25 + 2);
+    }
+    for (std::size_t i = 0; i < schur_sizes.size(); ++i) {
+        BOOST_CHECK_EQUAL(schur_sizes[i], 25 + 1);
+    }
+
+    const std::vector<double>& p0 = bordered.first.pressure();
+    const std::vector<double>& p1 = schur.first.pressure();
+    BOOST_REQUIRE_EQUAL(p0.size(), p1.size());
+    for (std::size_t c = 0; c < p0.size(); ++c) {
+        BOOST_CHECK_CLOSE(p0[c], p1[c], 1e-8);
+    }
+    const std::vector<double>& bhp0 = bordered.second.bhp();
+    const std::vector<double>& bhp1 = schur.second.bhp();
+    BOOST_REQUIRE_EQUAL(bhp0.size(), bhp1.size());
+    for (std::size_t w = 0; w < bhp0.size(); ++w) {
+        BOOST_CHECK_CLOSE(bhp0[w], bhp1[w], 1e-8);
+    }
+    const std::vector<double>& q0 = bordered.second.perfRates();
+    const std::vector<double>& q1 = schur.second.perfRates();
+    BOOST_REQUIRE_EQUAL(q0.size(), q1.size());
+    for (std::size_t i = 0; i < q0.size(); ++i) {
+        BOOST_CHECK_CLOSE(q0[i], q1[i], 1e-6);
+    }
+}
+
+
+
+namespace
+{
+    struct CompressibleRun
+    {
+        std::vector<double> pressure;
+        std::vector<double> bhp;
+        int linear_iterations;
+        int backtracks;
+        double max_tolerance;
+    };
+
+    /// Fluids with compressibility c produced down to 100 bar from one
+    /// corner, with the simulator's default tolerances (residual 0,
+    /// change 1 Pa) and an iterative linear solver.
+    CompressibleRun solveCompressible(const double c, const double forcing_max, const int max_backtracks)
+    {
+        using namespace Opm::unit;
+        std::unique_ptr<UnstructuredGrid, GridDeleter> grid(create_grid_cart2d(20, 20, 10.0, 10.0));
+        Opm::parameter::ParameterGroup param;
+        param.disableOutput();
+        param.insertParameter("num_phases", "2");
+        param.insertParameter("relperm_func", "Quadratic");
+        param.insertParameter("porosity", "0.2");
+        ExponentialCompressibility props(param, grid->number_of_cells, c, 200.0*barsa);
+
+        std::unique_ptr<Wells, WellsDeleter> wells(create_wells(2, 1, 1));
+        const int prod_cell = 0;
+        const double prod_wi = 1e-10;
+        add_well(PRODUCER, 0.0, 1, NULL, &prod_cell, &prod_wi, "PROD", 1, wells.get());
+        append_well_controls(BHP, 100.0*barsa, 0.0, 0, NULL, 0, wells.get());
+        set_current_control(0, 0, wells.get());
+
+        Opm::BlackoilState state;
+        state.init(*grid, 2);
+        for (int cell = 0; cell < grid->number_of_cells; ++cell) {
+            state.pressure()[cell] = 200.0*barsa;
+            state.saturation()[2*cell] = 0.3;
+            state.saturation()[2*cell + 1] = 0.7;
+        }
+        state.surfacevol() = state.saturation();
+        Opm::WellState well_state;
+        well_state.init(wells.get(), state);
+
+        BiCGStabSolver linsolver(1e-10);
+        Opm::CompressibleTpfa psolver(*grid, props, 0, linsolver, 0.0, 1.0, 30,
+                                      0, wells.get(), forcing_max, max_backtracks);
+        psolver.solve(0.1*day, state, well_state);
+
+        CompressibleRun run;
+        run.pressure = state.pressure();
+        run.bhp = well_state.bhp();
+        run.linear_iterations = psolver.linearIterations();
+        run.backtracks = psolver.lineSearchBacktracks();
+        run.max_tolerance = linsolver.maxTolerance();
+        return run;
+    }
+
+    void checkSamePressure(const CompressibleRun& a, const CompressibleRun& b)
+    {
+        // Both runs stopped with pressure changes below 1 Pa.
+        BOOST_REQUIRE_EQUAL(a.pressure.size(), b.pressure.size());
+        for (std::size_t cell = 0; cell < a.pressure.size(); ++cell) {
+            BOOST_CHECK_SMALL(a.pressure[cell] - b.pressure[cell], 10.0);
+        }
+        BOOST_CHECK_SMALL(a.bhp[0] - b.bhp[0], 10.0);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(AdaptiveForcingSavesLinearIterations)
+{
+    const CompressibleRun fixed = solveCompressible(5e-8, 0.0, 0);
+    const CompressibleRun adaptive = solveCompressible(5e-8, 0.1, 0);
+    std::cout << "Linear iterations: fixed tolerance " << fixed.linear_iterations
+              << ", adaptive " << adaptive.linear_iterations << std::endl;
+
+    BOOST_CHECK_EQUAL(fixed.max_tolerance, 1e-10);
+    BOOST_CHECK_GT(adaptive.max_tolerance, 1e-3);
+    BOOST_CHECK_LT(adaptive.linear_iterations, fixed.linear_iterations);
+    checkSamePressure(fixed, adaptive);
+}
+
+BOOST_AUTO_TEST_CASE(BacktrackingRescuesStiffCase)
+{
+    // Full Newton steps overshoot and do not converge.
+    BOOST_CHECK_THROW(solveCompressible(1e-7, 0.0, 0), std::runtime_error);
+
+    const CompressibleRun fixed = solveCompressible(1e-7, 0.0, 8);
+    const CompressibleRun adaptive = solveCompressible(1e-7, 0.1, 8);
+    std::cout << "Linear iterations with line search: fixed tolerance " << fixed.linear_iterations
+              << " (" << fixed.backtracks << " backtracks), adaptive " << adaptive.linear_iterations
+              << " (" << adaptive.backtracks << " backtracks)" << std::endl;
+    BOOST_CHECK_GT(fixed.backtracks, 0);
+    BOOST_CHECK_GT(adaptive.backtracks, 0);
+    checkSamePressure(fixed, adaptive);
+}
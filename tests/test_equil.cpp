@@ -418,6 +418,45 @@ BOOST_AUTO_TEST_CASE (CapillaryInversion)
 
 
 
+BOOST_AUTO_TEST_CASE (CapillaryInversionBatch)
+{
+    // Test setup.
+    Opm::GridManager gm(1, 1, 40, 1.0, 1.0, 2.5);
+    const UnstructuredGrid& grid = *(gm.c_grid());
+    Opm::ParserPtr parser(new Opm::Parser() );
+    Opm::ParseMode parseMode;
+    Opm::DeckConstPtr deck = parser->parseFile("capillary.DATA" , parseMode);
+    Opm::EclipseStateConstPtr eclipseState(new Opm::EclipseState(deck , parseMode));
+    Opm::BlackoilPropertiesFromDeck props(deck, eclipseState, grid, false);
+
+    // One target capillary pressure per cell, covering the clamped
+    // ends of the curves as well as the interior. The targets are
+    // whole Pascals, since the single-cell functor stores its target
+    // as an integer.
+    const int n = grid.number_of_cells;
+    std::vector<int> cells(n);
+    std::vector<double> pc(n);
+    for (int i = 0; i < n; ++i) {
+        cells[i] = n - 1 - i;
+        pc[i] = -10000.0 + 2000.0*i;
+    }
+
+    // The batch inversion must give the same saturations as the
+    // single-cell inversion, for oil-water and gas-oil.
+    const int phases[] = { 0, 2 };
+    const bool increasing[] = { false, true };
+    for (int p = 0; p < 2; ++p) {
+        std::vector<double> s(n);
+        Opm::Equil::satFromPc(props, phases[p], n, &cells[0], &pc[0], &s[0], increasing[p]);
+        for (int i = 0; i < n; ++i) {
+            const double s_single = Opm::Equil::satFromPc(props, phases[p], cells[i], pc[i], increasing[p]);
+            BOOST_CHECK_EQUAL(s[i], s_single);
+        }
+    }
+}
+
+
+
 BOOST_AUTO_TEST_CASE (DeckWithCapillary)
 {
     Opm::GridManager gm(1, 1, 20, 1.0, 1.0, 5.0);
@@ -0,0 +1,127 @@
+/*
+  Copyright 2015 SINTEF ICT, Applied Mathematics.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "config.h"
+
+/* --- Boost.Test boilerplate --- */
+#if HAVE_DYNAMIC_BOOST_TEST
+#define BOOST_TEST_DYN_LINK
+#endif
+
+#define NVERBOSE  // Suppress own messages when throw()ing
+
+#define BOOST_TEST_MODULE GridPartitionTest
+#include <boost/test/unit_test.hpp>
+
+/* --- our own headers --- */
+#include <opm/core/grid/GridPartition.hpp>
+#include <opm/core/grid/cart_grid.h>
+#include <opm/core/grid.h>
+
+#include <algorithm>
+#include <vector>
+
+using namespace Opm;
+
+namespace
+{
+    int neighbour(const UnstructuredGrid& g, const int cell, const int face)
+    {
+        return g.face_cells[2*face] == cell ? g.face_cells[2*face + 1] : g.face_cells[2*face];
+    }
+}
+
+BOOST_AUTO_TEST_CASE(partitionSizes)
+{
+    UnstructuredGrid* g = create_grid_cart3d(10, 7, 3);
+    const int nc = g->number_of_cells;
+    for (int num_parts = 1; num_parts <= 7; ++num_parts) {
+        std::vector<int> cell_part;
+        partitionCellGraph(*g, num_parts, cell_part);
+        BOOST_REQUIRE_EQUAL(int(cell_part.size()), nc);
+        std::vector<int> count(num_parts, 0);
+        for (int c = 0; c < nc; ++c) {
+            BOOST_REQUIRE(cell_part[c] >= 0 && cell_part[c] < num_parts);
+            ++count[cell_part[c]];
+        }
+        const int min_count = *std::min_element(count.begin(), count.end());
+        const int max_count = *std::max_element(count.begin(), count.end());
+        BOOST_CHECK(min_count > 0);
+        BOOST_CHECK(max_count - min_count <= 2);
+    }
+    destroy_grid(g);
+}
+
+BOOST_AUTO_TEST_CASE(subdomains)
+{
+    UnstructuredGrid* g = create_grid_cart2d(12, 9, 1.0, 1.0);
+    const int nc = g->number_of_cells;
+    const int num_parts = 4;
+    std::vector<int> cell_part;
+    partitionCellGraph(*g, num_parts, cell_part);
+
+    std::vector<double> field(2*nc);
+    for (int i = 0; i < 2*nc; ++i) {
+        field[i] = 0.5*i;
+    }
+    std::vector<double> assembled(2*nc, -1.0);
+    int total_owned = 0;
+    for (int part = 0; part < num_parts; ++part) {
+        SubdomainGrid sub(*g, cell_part, part);
+        const UnstructuredGrid& lg = *sub.c_grid();
+        const std::vector<int>& gc = sub.globalCell();
+        const std::vector<int>& gf = sub.globalFace();
+        BOOST_REQUIRE_EQUAL(int(gc.size()), lg.number_of_cells);
+        BOOST_REQUIRE_EQUAL(int(gf.size()), lg.number_of_faces);
+        total_owned += sub.numOwnedCells();
+        for (int lc = 0; lc < lg.number_of_cells; ++lc) {
+            const bool owned = lc < sub.numOwnedCells();
+            BOOST_CHECK_EQUAL(owned, cell_part[gc[lc]] == part);
+            BOOST_CHECK_EQUAL(sub.cellOwner()[lc], cell_part[gc[lc]]);
+            BOOST_CHECK_EQUAL(sub.localCell(gc[lc]), lc);
+            BOOST_CHECK_EQUAL(lg.cell_volumes[lc], g->cell_volumes[gc[lc]]);
+            const int c = gc[lc];
+            BOOST_REQUIRE_EQUAL(lg.cell_facepos[lc + 1] - lg.cell_facepos[lc],
+                                g->cell_facepos[c + 1] - g->cell_facepos[c]);
+            for (int i = 0; i < lg.cell_facepos[lc + 1] - lg.cell_facepos[lc]; ++i) {
+                const int lf = lg.cell_faces[lg.cell_facepos[lc] + i];
+                const int f = g->cell_faces[g->cell_facepos[c] + i];
+                BOOST_CHECK_EQUAL(gf[lf], f);
+                const int lnb = neighbour(lg, lc, lf);
+                const int nb = neighbour(*g, c, f);
+                if (owned) {
+                    // Owned cells see all their neighbours.
+                    BOOST_CHECK_EQUAL(lnb < 0 ? -1 : gc[lnb], nb);
+                } else if (lnb >= 0) {
+                    BOOST_CHECK_EQUAL(gc[lnb], nb);
+                }
+            }
+        }
+        std::vector<double> local;
+        sub.extractCellData(field, local);
+        BOOST_REQUIRE_EQUAL(int(local.size()), 2*lg.number_of_cells);
+        for (int lc = 0; lc < lg.number_of_cells; ++lc) {
+            BOOST_CHECK_EQUAL(local[2*lc + 1], field[2*gc[lc] + 1]);
+        }
+        sub.insertOwnedCellData(local, assembled);
+    }
+    BOOST_CHECK_EQUAL(total_owned, nc);
+    BOOST_CHECK(assembled == field);
+    destroy_grid(g);
+}
@@ -123,6 +123,30 @@ void run_test(const Opm::parameter::ParameterGroup& param)
              &(x[0]));
 }
 
+void run_multiple_rhs_test(const Opm::parameter::ParameterGroup& param)
+{
+    const int N=10;
+    const int num_rhs=3;
+    auto mat = createLaplacian(N);
+    std::vector<double> x(num_rhs*N*N), b(num_rhs*N*N);
+    for (int k = 0; k < num_rhs; ++k) {
+        std::vector<double> xk, bk;
+        createRandomVectors(N*N, xk, bk, *mat);
+        std::copy(xk.begin(), xk.end(), x.begin() + k*N*N);
+        std::copy(bk.begin(), bk.end(), b.begin() + k*N*N);
+    }
+    std::vector<double> exact(x);
+    std::fill(x.begin(), x.end(), 0.0);
+    Opm::LinearSolverFactory ls(param);
+    auto rep = ls.solveMultiple(N*N, mat->data.size(), &(mat->rowStart[0]),
+                                &(mat->colIndex[0]), &(mat->data[0]), num_rhs,
+                                &(b[0]), &(x[0]));
+    BOOST_CHECK(rep.converged);
+    for (std::size_t i = 0; i < x.size(); ++i) {
+        BOOST_CHECK_SMALL(x[i] - exact[i], 1e-6);
+    }
+}
+
 
 BOOST_AUTO_TEST_CASE(DefaultTest)
 {
@@ -132,7 +156,23 @@ BOOST_AUTO_TEST_CASE(DefaultTest)
     run_test(param);
 }
 
+BOOST_AUTO_TEST_CASE(DefaultMultipleRhsTest)
+{
+    Opm::parameter::ParameterGroup param;
+    param.insertParameter(std::string("linsolver_residual_tolerance"), std::string("1e-12"));
+    run_multiple_rhs_test(param);
+}
+
 #ifdef HAVE_DUNE_ISTL
+BOOST_AUTO_TEST_CASE(CGAMGMultipleRhsTest)
+{
+    Opm::parameter::ParameterGroup param;
+    param.insertParameter(std::string("linsolver"), std::string("istl"));
+    param.insertParameter(std::string("linsolver_type"), std::string("1"));
+    param.insertParameter(std::string("linsolver_residual_tolerance"), std::string("1e-12"));
+    run_multiple_rhs_test(param);
+}
+
 BOOST_AUTO_TEST_CASE(CGAMGTest)
 {
     Opm::parameter::ParameterGroup param;
@@ -196,4 +236,34 @@ BOOST_AUTO_TEST_CASE(PETScTest)
     param.insertParameter(std::string("ksp_view"), std::string("0"));
     run_test(param);
 }
+
+BOOST_AUTO_TEST_CASE(PETScReuseTest)
+{
+    Opm::parameter::ParameterGroup param;
+    param.insertParameter(std::string("linsolver"), std::string("petsc"));
+    param.insertParameter(std::string("ksp_type"), std::string("cg"));
+    param.insertParameter(std::string("pc_type"), std::string("jacobi"));
+    param.insertParameter(std::string("ksp_rtol"), std::string("1e-12"));
+    param.insertParameter(std::string("ksp_reuse"), std::string("true"));
+    param.insertParameter(std::string("pc_reuse"), std::string("1"));
+    int N=4;
+    auto mat = createLaplacian(N);
+    Opm::LinearSolverFactory ls(param);
+    // Repeated solves with the same pattern but changing values.
+    for (int step = 0; step < 4; ++step) {
+        for (auto& v : mat->data) {
+            v *= 1.0 + 0.5*step;
+        }
+        std::vector<double> x, b;
+        createRandomVectors(N*N, x, b, *mat);
+        std::vector<double> exact(x);
+        std::fill(x.begin(), x.end(), 0.0);
+        ls.solve(N*N, mat->data.size(), &(mat->rowStart[0]),
+                 &(mat->colIndex[0]), &(mat->data[0]), &(b[0]),
+                 &(x[0]));
+        for (int i = 0; i < N*N; ++i) {
+            BOOST_CHECK_SMALL(x[i] - exact[i], 1e-6);
+        }
+    }
+}
 #endif
@@ -0,0 +1,173 @@
+/*
+  Copyright 2015 SINTEF ICT, Applied Mathematics.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "config.h"
+
+/* --- Boost.Test boilerplate --- */
+#if HAVE_DYNAMIC_BOOST_TEST
+#define BOOST_TEST_DYN_LINK
+#endif
+
+#define NVERBOSE  // Suppress own messages when throw()ing
+
+#define BOOST_TEST_MODULE LinearSolverRecyclingTest
+#include <boost/test/unit_test.hpp>
+
+/* --- our own headers --- */
+#include <opm/core/linalg/LinearSolverRecycling.hpp>
+
+#include <cmath>
+#include <vector>
+
+namespace
+{
+    /// Unpreconditioned CG with a relative residual tolerance,
+    /// always starting from zero.
+    class TestCG : public Opm::LinearSolverInterface
+    {
+    public:
+        TestCG() : tol_(1e-10) {}
+
+        using Opm::LinearSolverInterface::solve;
+
+        virtual LinearSolverReport solve(const int size, const int,
+                                         const int* ia, const int* ja, const double* sa,
+                                         const double* rhs, double* solution,
+                                         const boost::any& = boost::any()) const
+        {
+            std::vector<double> r(rhs, rhs + size), p(r), ap(size);
+            double rr = 0.0;
+            for (int i = 0; i < size; ++i) {
+                solution[i] = 0.0;
+                rr += r[i]*r[i];
+            }
+            const double target = tol_*tol_*rr;
+            LinearSolverReport rep = {};
+            while (rr > target && rep.iterations < 10*size) {
+                double pap = 0.0;
+                for (int row = 0; row < size; ++row) {
+                    ap[row] = 0.0;
+                    for (int k = ia[row]; k < ia[row + 1]; ++k) {
+                        ap[row] += sa[k]*p[ja[k]];
+                    }
+                    pap += p[row]*ap[row];
+                }
+                const double alpha = rr/pap;
+                double rr_new = 0.0;
+                for (int i = 0; i < size; ++i) {
+                    solution[i] += alpha*p[i];
+                    r[i] -= alpha*ap[i];
+                    rr_new += r[i]*r[i];
+                }
+                for (int i = 0; i < size; ++i) {
+                    p[i] = r[i] + rr_new/rr*p[i];
+                }
+                rr = rr_new;
+                ++rep.iterations;
+            }
+            rep.converged = rr <= target;
+            return rep;
+        }
+
+        virtual void setTolerance(const double tol) { tol_ = tol; }
+        virtual double getTolerance() const { return tol_; }
+
+    private:
+        double tol_;
+    };
+
+    /// 1D Laplacian plus a diagonal shift.
+    struct Laplacian
+    {
+        Laplacian(const int n, const double shift)
+        {
+            ia.push_back(0);
+            for (int row = 0; row < n; ++row) {
+                if (row > 0) { ja.push_back(row - 1); sa.push_back(-1.0); }
+                ja.push_back(row); sa.push_back(2.0 + shift);
+                if (row < n - 1) { ja.push_back(row + 1); sa.push_back(-1.0); }
+                ia.push_back(ja.size());
+            }
+        }
+        std::vector<int> ia, ja;
+        std::vector<double> sa;
+    };
+
+    double residualNorm(const Laplacian& A, const std::vector<double>& x,
+                        const std::vector<double>& b)
+    {
+        double sum = 0.0;
+        for (std::size_t row = 0; row < b.size(); ++row) {
+            double r = b[row];
+            for (int k = A.ia[row]; k < A.ia[row + 1]; ++k) {
+                r -= A.sa[k]*x[A.ja[k]];
+            }
+            sum += r*r;
+        }
+        return std::sqrt(sum);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(recycledSolutionsReduceIterations)
+{
+    const int n = 200;
+    TestCG plain_cg, inner_cg;
+    Opm::LinearSolverRecycling recycling(inner_cg, 3);
+    int plain_iterations = 0;
+    for (int step = 0; step < 10; ++step) {
+        // Slowly varying matrix and right hand side.
+        const Laplacian A(n, 1e-2*(1.0 + 0.01*step));
+        std::vector<double> b(n);
+        for (int i = 0; i < n; ++i) {
+            b[i] = std::sin(3.0*i/n) + 0.01*step*std::cos(5.0*i/n);
+        }
+        std::vector<double> x_plain(n), x(n);
+        const auto rep_plain = plain_cg.solve(n, A.sa.size(), A.ia.data(), A.ja.data(),
+                                              A.sa.data(), b.data(), x_plain.data());
+        plain_iterations += rep_plain.iterations;
+        const auto rep = recycling.solve(n, A.sa.size(), A.ia.data(), A.ja.data(),
+                                         A.sa.data(), b.data(), x.data());
+        BOOST_CHECK(rep.converged);
+        double b_norm = 0.0;
+        for (double v : b) {
+            b_norm += v*v;
+        }
+        BOOST_CHECK_LE(residualNorm(A, x, b), 1.01e-10*std::sqrt(b_norm));
+    }
+    BOOST_CHECK_EQUAL(recycling.numSolves(), 10);
+    BOOST_CHECK_LT(recycling.totalIterations(), plain_iterations);
+    // The tolerance of the wrapped solver is restored.
+    BOOST_CHECK_EQUAL(inner_cg.getTolerance(), 1e-10);
+}
+
+BOOST_AUTO_TEST_CASE(repeatedSystemIsSkipped)
+{
+    const int n = 50;
+    TestCG inner_cg;
+    Opm::LinearSolverRecycling recycling(inner_cg, 2);
+    const Laplacian A(n, 0.1);
+    std::vector<double> b(n, 1.0), x(n), y(n);
+    recycling.solve(n, A.sa.size(), A.ia.data(), A.ja.data(), A.sa.data(), b.data(), x.data());
+    const auto rep = recycling.solve(n, A.sa.size(), A.ia.data(), A.ja.data(), A.sa.data(), b.data(), y.data());
+    BOOST_CHECK_EQUAL(rep.iterations, 0);
+    BOOST_CHECK_EQUAL(recycling.numSkippedSolves(), 1);
+    for (int i = 0; i < n; ++i) {
+        BOOST_CHECK_CLOSE(x[i], y[i], 1e-6);
+    }
+}
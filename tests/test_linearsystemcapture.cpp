@@ -0,0 +1,178 @@
+/*
+  Copyright 2015 SINTEF ICT, Applied Mathematics.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "config.h"
+
+/* --- Boost.Test boilerplate --- */
+#if HAVE_DYNAMIC_BOOST_TEST
+#define BOOST_TEST_DYN_LINK
+#endif
+
+#define NVERBOSE  // Suppress own messages when throw()ing
+
+#define BOOST_TEST_MODULE LinearSystemCaptureTest
+#include <boost/test/unit_test.hpp>
+
+/* --- our own headers --- */
+#include <opm/core/linalg/LinearSystemCapture.hpp>
+
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+#include <vector>
+
+namespace
+{
+    /// Diagonal solver that counts its calls.
+    class TestDiagonal : public Opm::LinearSolverInterface
+    {
+    public:
+        TestDiagonal() : tol_(1e-6), calls_(0) {}
+
+        using Opm::LinearSolverInterface::solve;
+
+        virtual LinearSolverReport solve(const int size, const int,
+                                         const int* ia, const int* ja, const double* sa,
+                                         const double* rhs, double* solution,
+                                         const boost::any& = boost::any()) const
+        {
+            for (int row = 0; row < size; ++row) {
+                for (int k = ia[row]; k < ia[row + 1]; ++k) {
+                    if (ja[k] == row) {
+                        solution[row] = rhs[row] / sa[k];
+                    }
+                }
+            }
+            ++calls_;
+            LinearSolverReport rep = {};
+            rep.converged = true;
+            return rep;
+        }
+
+        virtual void setTolerance(const double tol) { tol_ = tol; }
+        virtual double getTolerance() const { return tol_; }
+        int calls() const { return calls_; }
+
+    private:
+        double tol_;
+        mutable int calls_;
+    };
+
+    Opm::CapturedLinearSystem makeSystem()
+    {
+        // [ 2 -1 ; -1 3 ]
+        Opm::CapturedLinearSystem sys;
+        const int ia[] = { 0, 2, 4 };
+        const int ja[] = { 0, 1, 0, 1 };
+        const double sa[] = { 2.0, -1.0, -1.0, 3.0 };
+        sys.ia.assign(ia, ia + 3);
+        sys.ja.assign(ja, ja + 4);
+        sys.sa.assign(sa, sa + 4);
+        sys.rhs.assign(2, 1.0);
+        sys.rhs[1] = -0.25;
+        sys.initial_guess.assign(2, 0.5);
+        sys.tolerance = 1e-9;
+        return sys;
+    }
+
+    void checkEqual(const Opm::CapturedLinearSystem& a, const Opm::CapturedLinearSystem& b)
+    {
+        BOOST_CHECK(a.ia == b.ia);
+        BOOST_CHECK(a.ja == b.ja);
+        BOOST_CHECK(a.sa == b.sa);
+        BOOST_CHECK(a.rhs == b.rhs);
+        BOOST_CHECK(a.initial_guess == b.initial_guess);
+        BOOST_CHECK_EQUAL(a.tolerance, b.tolerance);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(roundTrip)
+{
+    const Opm::CapturedLinearSystem sys = makeSystem();
+    const std::string filename = "test_linearsystemcapture.olsys";
+    Opm::writeLinearSystem(filename, sys);
+    checkEqual(sys, Opm::readLinearSystem(filename));
+
+    // Truncated files and other files are rejected.
+    {
+        std::ofstream file(filename.c_str(), std::ios::binary);
+        file << "OPMLSYS";
+    }
+    BOOST_CHECK_THROW(Opm::readLinearSystem(filename), std::runtime_error);
+    {
+        std::ofstream file(filename.c_str(), std::ios::binary);
+        file << "not a linear system";
+    }
+    BOOST_CHECK_THROW(Opm::readLinearSystem(filename), std::runtime_error);
+
+    // Row starts must not decrease and column indices must be in range.
+    Opm::CapturedLinearSystem bad = makeSystem();
+    bad.ia[1] = 5;
+    Opm::writeLinearSystem(filename, bad);
+    BOOST_CHECK_THROW(Opm::readLinearSystem(filename), std::runtime_error);
+    bad = makeSystem();
+    bad.ja[1] = 2;
+    Opm::writeLinearSystem(filename, bad);
+    BOOST_CHECK_THROW(Opm::readLinearSystem(filename), std::runtime_error);
+    bad.ja[1] = -1;
+    Opm::writeLinearSystem(filename, bad);
+    BOOST_CHECK_THROW(Opm::readLinearSystem(filename), std::runtime_error);
+    std::remove(filename.c_str());
+}
+
+BOOST_AUTO_TEST_CASE(captureWrapper)
+{
+    const Opm::CapturedLinearSystem sys = makeSystem();
+    TestDiagonal inner;
+    Opm::LinearSolverCapture capture(inner, "test_capture", 2);
+    capture.setTolerance(sys.tolerance);
+    BOOST_CHECK_EQUAL(inner.getTolerance(), sys.tolerance);
+
+    // Three solves, the last one is not captured.
+    for (int i = 0; i < 3; ++i) {
+        std::vector<double> x(sys.initial_guess);
+        const Opm::LinearSolverInterface::LinearSolverReport rep =
+            capture.solve(sys.size(), sys.nonzeros(), &sys.ia[0], &sys.ja[0], &sys.sa[0],
+                          &sys.rhs[0], &x[0]);
+        BOOST_CHECK(rep.converged);
+        BOOST_CHECK_EQUAL(x[0], 0.5);
+    }
+    BOOST_CHECK_EQUAL(inner.calls(), 3);
+    BOOST_CHECK_EQUAL(capture.numCaptured(), 2);
+
+    // The initial guess is captured, not the solution.
+    checkEqual(sys, Opm::readLinearSystem("test_capture-0000.olsys"));
+    checkEqual(sys, Opm::readLinearSystem("test_capture-0001.olsys"));
+    BOOST_CHECK(!std::ifstream("test_capture-0002.olsys"));
+    std::remove("test_capture-0000.olsys");
+    std::remove("test_capture-0001.olsys");
+
+    // Each right hand side of solveMultiple() is a separate system.
+    Opm::LinearSolverCapture multiple(inner, "test_capture_multiple");
+    std::vector<double> rhs(sys.rhs);
+    rhs.insert(rhs.end(), sys.rhs.begin(), sys.rhs.end());
+    std::vector<double> x(sys.initial_guess);
+    x.insert(x.end(), sys.initial_guess.begin(), sys.initial_guess.end());
+    multiple.solveMultiple(sys.size(), sys.nonzeros(), &sys.ia[0], &sys.ja[0], &sys.sa[0],
+                           2, &rhs[0], &x[0]);
+    BOOST_CHECK_EQUAL(multiple.numCaptured(), 2);
+    checkEqual(sys, Opm::readLinearSystem("test_capture_multiple-0001.olsys"));
+    std::remove("test_capture_multiple-0000.olsys");
+    std::remove("test_capture_multiple-0001.olsys");
+}
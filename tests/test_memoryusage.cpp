@@ -0,0 +1,107 @@
+/*
+  Copyright 2015 SINTEF ICT, Applied Mathematics.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "config.h"
+
+/* --- Boost.Test boilerplate --- */
+#if HAVE_DYNAMIC_BOOST_TEST
+#define BOOST_TEST_DYN_LINK
+#endif
+
+#define NVERBOSE  // Suppress own messages when throw()ing
+
+#define BOOST_TEST_MODULE MemoryUsageTest
+#include <boost/test/unit_test.hpp>
+
+/* --- our own headers --- */
+#include <opm/core/utility/MemoryUsage.hpp>
+#include <opm/core/grid/cart_grid.h>
+#include <opm/core/grid.h>
+#include <opm/core/wells.h>
+#include <opm/core/well_controls.h>
+
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE ()
+
+BOOST_AUTO_TEST_CASE (vectors)
+{
+    std::vector<double> v(10);
+    BOOST_CHECK_EQUAL(Opm::memoryUsage(v), v.capacity()*sizeof(double));
+
+    std::vector<std::vector<int> > vv(3, std::vector<int>(4));
+    std::size_t expected = vv.capacity()*sizeof(std::vector<int>);
+    for (std::size_t i = 0; i < vv.size(); ++i) {
+        expected += vv[i].capacity()*sizeof(int);
+    }
+    BOOST_CHECK_EQUAL(Opm::memoryUsage(vv), expected);
+}
+
+BOOST_AUTO_TEST_CASE (grid)
+{
+    struct UnstructuredGrid *g = create_grid_cart2d(2, 2, 1., 1.);
+    const std::size_t nc = g->number_of_cells;
+    const std::size_t nf = g->number_of_faces;
+
+    // Every cell has four faces, so the cell-to-face mapping
+    // alone takes this much.
+    const std::size_t lower = 4*nc*sizeof(int) + 2*nf*sizeof(int);
+    BOOST_CHECK_GT(Opm::memoryUsage(*g), lower);
+    BOOST_CHECK_EQUAL(grid_memory_usage(NULL), std::size_t(0));
+
+    destroy_grid(g);
+}
+
+BOOST_AUTO_TEST_CASE (wells)
+{
+    struct Wells *W = create_wells(2, 2, 4);
+    const std::size_t empty = Opm::memoryUsage(*W);
+
+    const int cells[] = { 0, 1 };
+    const double WI[] = { 1.0, 1.0 };
+    const double comp_frac[] = { 1.0, 0.0 };
+    BOOST_REQUIRE(add_well(INJECTOR, 0.0, 2, comp_frac, cells, WI, "INJ", 1, W));
+    const double distr[] = { 1.0, 0.0 };
+    BOOST_REQUIRE(append_well_controls(BHP, 1.0e7, -1e100, -100000, distr, 0, W));
+
+    // Capacity is unchanged, but the controls and name are new.
+    BOOST_CHECK_GT(Opm::memoryUsage(*W), empty);
+
+    destroy_wells(W);
+}
+
+BOOST_AUTO_TEST_CASE (allocationCounter)
+{
+    Opm::AllocationCounter::reset();
+    Opm::AllocationCounter::recordAllocation(100);
+    BOOST_CHECK_EQUAL(Opm::AllocationCounter::allocations(), 0ul);
+
+    Opm::AllocationCounter::enable();
+    BOOST_CHECK(Opm::AllocationCounter::enabled());
+    Opm::AllocationCounter::recordAllocation(100);
+    Opm::AllocationCounter::recordAllocation(28);
+    BOOST_CHECK_EQUAL(Opm::AllocationCounter::allocations(), 2ul);
+    BOOST_CHECK_EQUAL(Opm::AllocationCounter::bytesAllocated(), 128ul);
+
+    Opm::AllocationCounter::enable(false);
+    Opm::AllocationCounter::reset();
+    BOOST_CHECK_EQUAL(Opm::AllocationCounter::allocations(), 0ul);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -55,9 +55,11 @@ void run_test(const Opm::parameter::ParameterGroup& param)
     std::fill(x.begin(), x.end(), 0.0);
     Opm::LinearSolverFactory ls(param);
     boost::any anyComm(comm);
-    ls.solve(b.size(), mat->data.size(), &(mat->rowStart[0]),
-             &(mat->colIndex[0]), &(mat->data[0]), &(b[0]),
-             &(x[0]), anyComm);
+    Opm::LinearSolverInterface::LinearSolverReport rep =
+        ls.solve(b.size(), mat->data.size(), &(mat->rowStart[0]),
+                 &(mat->colIndex[0]), &(mat->data[0]), &(b[0]),
+                 &(x[0]), anyComm);
+    BOOST_CHECK(rep.converged);
 }
 
 #ifdef HAVE_DUNE_ISTL
@@ -30,7 +30,11 @@
 #include <boost/test/unit_test.hpp>
 #include "DuneIstlTestHelpers.hpp"
 #include <opm/core/linalg/ParallelIstlInformation.hpp>
+#include <algorithm>
 #include <functional>
+#include <stdexcept>
+#include <utility>
+#include <vector>
 #ifdef HAVE_DUNE_ISTL
 
 template<typename T>
@@ -96,4 +100,63 @@ BOOST_AUTO_TEST_CASE(singleContainerReductionTest)
     comm.computeReduction(x,Opm::Reduction::makeGlobalSumFunctor<int>(),value);
     BOOST_CHECK(value==oldvalue+((N-1)*N)/2);
 }
+BOOST_AUTO_TEST_CASE(nonBlockingCopyOwnerToAllTest)
+{
+    int N=100;
+    int start, end, istart, iend;
+    std::tie(start,istart,iend,end) = computeRegions(N);
+    Opm::ParallelISTLInformation comm(MPI_COMM_WORLD);
+    auto mat = create1DLaplacian(*comm.indexSet(), N, start, end, istart, iend);
+    std::vector<double> x(end-start, -1.0), y(end-start, -1.0), z(end-start, -1.0);
+    for(auto it=comm.indexSet()->begin(), itend=comm.indexSet()->end(); it!=itend; ++it)
+    {
+        if( it->local().attribute()==Dune::OwnerOverlapCopyAttributeSet::owner )
+        {
+            x[it->local()] = it->global();
+            y[it->local()] = it->global();
+        }
+    }
+    comm.copyOwnerToAll(x, x);
+    comm.copyOwnerToAllBegin(y);
+    BOOST_CHECK_THROW(comm.copyOwnerToAllBegin(y), std::logic_error);
+    comm.copyOwnerToAllEnd(y);
+    BOOST_CHECK_THROW(comm.copyOwnerToAllEnd(y), std::logic_error);
+    for(auto it=comm.indexSet()->begin(), itend=comm.indexSet()->end(); it!=itend; ++it)
+    {
+        BOOST_CHECK_EQUAL(x[it->local()], it->global());
+        BOOST_CHECK_EQUAL(y[it->local()], it->global());
+    }
+    // The cached interface is reused for further copies. Only the
+    // non-owned entries are received, so the owned ones are set here.
+    for(auto it=comm.indexSet()->begin(), itend=comm.indexSet()->end(); it!=itend; ++it)
+    {
+        if( it->local().attribute()==Dune::OwnerOverlapCopyAttributeSet::owner )
+        {
+            z[it->local()] = y[it->local()];
+        }
+    }
+    comm.copyOwnerToAllBegin(y);
+    comm.copyOwnerToAllEnd(z);
+    BOOST_CHECK(std::equal(y.begin(), y.end(), z.begin()));
+}
+
+BOOST_AUTO_TEST_CASE(fusedInnerProductTest)
+{
+    int N=100;
+    int start, end, istart, iend;
+    std::tie(start,istart,iend,end) = computeRegions(N);
+    Opm::ParallelISTLInformation comm(MPI_COMM_WORLD);
+    auto mat = create1DLaplacian(*comm.indexSet(), N, start, end, istart, iend);
+    std::vector<double> x(end-start), y(end-start, 2.0);
+    for(auto it=comm.indexSet()->begin(), itend=comm.indexSet()->end(); it!=itend; ++it)
+        x[it->local()]=it->global();
+    typedef std::pair<const std::vector<double>*, const std::vector<double>*> Pair;
+    std::vector<Pair> pairs = { Pair(&x, &x), Pair(&x, &y), Pair(&y, &y) };
+    std::vector<double> results;
+    comm.computeInnerProducts(pairs, results);
+    BOOST_REQUIRE_EQUAL(results.size(), 3u);
+    BOOST_CHECK_EQUAL(results[0], ((N-1)*N*(2*N-1))/6);
+    BOOST_CHECK_EQUAL(results[1], (N-1)*N);
+    BOOST_CHECK_EQUAL(results[2], 4*N);
+}
 #endif
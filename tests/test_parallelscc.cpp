@@ -0,0 +1,164 @@
+/*
+  Copyright 2015 SINTEF ICT, Applied Mathematics.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "config.h"
+
+/* --- Boost.Test boilerplate --- */
+#if HAVE_DYNAMIC_BOOST_TEST
+#define BOOST_TEST_DYN_LINK
+#endif
+
+#define NVERBOSE  // Suppress own messages when throw()ing
+
+#define BOOST_TEST_MODULE ParallelSccTest
+#include <boost/test/unit_test.hpp>
+
+/* --- our own headers --- */
+#include <opm/core/transport/reorder/parallelscc.h>
+#include <opm/core/transport/reorder/tarjan.h>
+#include <opm/core/transport/reorder/reordersequence.h>
+#include <opm/core/grid.h>
+#include <opm/core/grid/cart_grid.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <vector>
+
+namespace
+{
+    // Label each vertex by the smallest vertex of its component and
+    // check that the components are in reverse topological order.
+    std::vector<int> checkComponents(const int nv, const std::vector<int>& ia,
+                                     const std::vector<int>& ja,
+                                     const std::vector<int>& vert,
+                                     const std::vector<int>& comp,
+                                     const int ncomp)
+    {
+        BOOST_REQUIRE(ncomp >= 1 && ncomp <= nv);
+        BOOST_REQUIRE_EQUAL(comp[0], 0);
+        BOOST_REQUIRE_EQUAL(comp[ncomp], nv);
+        std::vector<int> sorted(vert.begin(), vert.begin() + nv);
+        std::sort(sorted.begin(), sorted.end());
+        for (int v = 0; v < nv; ++v) {
+            BOOST_REQUIRE_EQUAL(sorted[v], v);
+        }
+        std::vector<int> comp_of(nv), label(nv);
+        for (int c = 0; c < ncomp; ++c) {
+            BOOST_REQUIRE(comp[c] < comp[c + 1]);
+            const int smallest = *std::min_element(vert.begin() + comp[c], vert.begin() + comp[c + 1]);
+            for (int i = comp[c]; i < comp[c + 1]; ++i) {
+                comp_of[vert[i]] = c;
+                label[vert[i]] = smallest;
+            }
+        }
+        for (int v = 0; v < nv; ++v) {
+            for (int j = ia[v]; j < ia[v + 1]; ++j) {
+                BOOST_CHECK(comp_of[ja[j]] <= comp_of[v]);
+            }
+        }
+        return label;
+    }
+
+    void compareWithTarjan(const int nv, const std::vector<int>& ia, const std::vector<int>& ja)
+    {
+        std::vector<int> vert(nv), comp(nv + 1), work(3*nv);
+        int ncomp = 0;
+        tarjan(nv, &ia[0], ja.data(), &vert[0], &comp[0], &ncomp, &work[0]);
+        const std::vector<int> expected = checkComponents(nv, ia, ja, vert, comp, ncomp);
+
+        std::vector<int> pvert(nv), pcomp(nv + 1);
+        int pncomp = 0;
+        parallel_scc(nv, &ia[0], ja.data(), &pvert[0], &pcomp[0], &pncomp);
+        BOOST_CHECK_EQUAL(pncomp, ncomp);
+        const std::vector<int> label = checkComponents(nv, ia, ja, pvert, pcomp, pncomp);
+        BOOST_CHECK_EQUAL_COLLECTIONS(label.begin(), label.end(), expected.begin(), expected.end());
+    }
+}
+
+BOOST_AUTO_TEST_CASE(RandomGraphs)
+{
+    std::srand(1234);
+    for (int trial = 0; trial < 20; ++trial) {
+        const int nv = 1 + std::rand() % 2000;
+        // Mostly forward edges, with a few backward ones creating
+        // components of varying size.
+        std::vector<int> ia(1, 0), ja;
+        for (int v = 0; v < nv; ++v) {
+            const int ne = std::rand() % 4;
+            for (int e = 0; e < ne; ++e) {
+                int w = (std::rand() % 10 == 0) ? std::rand() % nv
+                    : std::min(nv - 1, v + 1 + std::rand() % 5);
+                if (w != v) {
+                    ja.push_back(w);
+                }
+            }
+            ia.push_back(ja.size());
+        }
+        compareWithTarjan(nv, ia, ja);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(Cycle)
+{
+    const int nv = 1000;
+    std::vector<int> ia(nv + 1), ja(nv);
+    for (int v = 0; v < nv; ++v) {
+        ia[v + 1] = v + 1;
+        ja[v] = (v + 1) % nv;
+    }
+    compareWithTarjan(nv, ia, ja);
+}
+
+BOOST_AUTO_TEST_CASE(GridSequence)
+{
+    // Rotating flow with a drift gives a mix of single cells and
+    // large recirculation zones.
+    UnstructuredGrid* g = create_grid_cart2d(40, 30, 1.0, 1.0);
+    const int nc = g->number_of_cells;
+    std::vector<double> flux(g->number_of_faces);
+    for (int f = 0; f < g->number_of_faces; ++f) {
+        const double x = g->face_centroids[2*f] - 20.0;
+        const double y = g->face_centroids[2*f + 1] - 15.0;
+        const double vx = -y + 3.0;
+        const double vy = x;
+        flux[f] = vx*g->face_normals[2*f] + vy*g->face_normals[2*f + 1];
+    }
+    std::vector<int> seq(nc), comp(nc + 1), pseq(nc), pcomp(nc + 1);
+    int ncomp = 0, pncomp = 0;
+    compute_sequence(g, &flux[0], &seq[0], &comp[0], &ncomp);
+    compute_sequence_parallel(g, &flux[0], &pseq[0], &pcomp[0], &pncomp);
+    BOOST_CHECK_EQUAL(pncomp, ncomp);
+    BOOST_CHECK(ncomp < nc);
+    std::vector<int> label(nc), plabel(nc);
+    for (int c = 0; c < ncomp; ++c) {
+        const int smallest = *std::min_element(seq.begin() + comp[c], seq.begin() + comp[c + 1]);
+        for (int i = comp[c]; i < comp[c + 1]; ++i) {
+            label[seq[i]] = smallest;
+        }
+    }
+    for (int c = 0; c < pncomp; ++c) {
+        const int smallest = *std::min_element(pseq.begin() + pcomp[c], pseq.begin() + pcomp[c + 1]);
+        for (int i = pcomp[c]; i < pcomp[c + 1]; ++i) {
+            plabel[pseq[i]] = smallest;
+        }
+    }
+    BOOST_CHECK_EQUAL_COLLECTIONS(plabel.begin(), plabel.end(), label.begin(), label.end());
+    destroy_grid(g);
+}
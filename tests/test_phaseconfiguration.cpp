@@ -0,0 +1,96 @@
+/*
+  Copyright 2015 SINTEF ICT, Applied Mathematics.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "config.h"
+
+/* --- Boost.Test boilerplate --- */
+#if HAVE_DYNAMIC_BOOST_TEST
+#define BOOST_TEST_DYN_LINK
+#endif
+
+#define NVERBOSE  // Suppress own messages when throw()ing
+
+#define BOOST_TEST_MODULE PhaseConfigurationTest
+#include <boost/test/unit_test.hpp>
+
+/* --- our own headers --- */
+#include <opm/core/props/PhaseConfiguration.hpp>
+
+namespace
+{
+    Opm::PhaseUsage phaseUsage( const bool water, const bool oil, const bool gas )
+    {
+        Opm::PhaseUsage pu;
+        pu.phase_used[ Opm::BlackoilPhases::Aqua ] = water;
+        pu.phase_used[ Opm::BlackoilPhases::Liquid ] = oil;
+        pu.phase_used[ Opm::BlackoilPhases::Vapour ] = gas;
+        pu.num_phases = 0;
+        for( int phase = 0; phase < Opm::BlackoilPhases::MaxNumPhases; ++phase ) {
+            pu.phase_pos[ phase ] = pu.phase_used[ phase ] ? pu.num_phases++ : -1;
+        }
+        return pu;
+    }
+
+    struct RecordTraits
+    {
+        int* result;
+        int np;
+
+        template <Opm::PhaseConfiguration Config>
+        void apply() const
+        {
+            typedef Opm::PhaseTraits<Config> Traits;
+            result[ 0 ] = Config;
+            result[ 1 ] = Traits::numPhases( np );
+            result[ 2 ] = Traits::Oil;
+            result[ 3 ] = Traits::Gas;
+        }
+    };
+}
+
+BOOST_AUTO_TEST_CASE(classification)
+{
+    BOOST_CHECK_EQUAL( Opm::phaseConfiguration( phaseUsage( true, true, false ) ), Opm::WaterOilPhases );
+    BOOST_CHECK_EQUAL( Opm::phaseConfiguration( phaseUsage( false, true, true ) ), Opm::OilGasPhases );
+    BOOST_CHECK_EQUAL( Opm::phaseConfiguration( phaseUsage( true, true, true ) ), Opm::WaterOilGasPhases );
+    BOOST_CHECK_EQUAL( Opm::phaseConfiguration( phaseUsage( true, false, true ) ), Opm::GenericPhases );
+    BOOST_CHECK_EQUAL( Opm::phaseConfiguration( phaseUsage( false, true, false ) ), Opm::GenericPhases );
+}
+
+BOOST_AUTO_TEST_CASE(traitsMatchPhasePositions)
+{
+    const bool sets[ 3 ][ 3 ] = { { true, true, false }, { false, true, true }, { true, true, true } };
+    for( int i = 0; i < 3; ++i ) {
+        const Opm::PhaseUsage pu = phaseUsage( sets[ i ][ 0 ], sets[ i ][ 1 ], sets[ i ][ 2 ] );
+        int result[ 4 ];
+        const RecordTraits kernel = { result, -1 };
+        Opm::dispatchPhaseConfiguration( Opm::phaseConfiguration( pu ), kernel );
+        BOOST_CHECK_EQUAL( result[ 0 ], Opm::phaseConfiguration( pu ) );
+        BOOST_CHECK_EQUAL( result[ 1 ], pu.num_phases );
+        BOOST_CHECK_EQUAL( result[ 2 ], pu.phase_pos[ Opm::BlackoilPhases::Liquid ] );
+        BOOST_CHECK_EQUAL( result[ 3 ], pu.phase_pos[ Opm::BlackoilPhases::Vapour ] );
+    }
+
+    // The generic kernel takes the number of phases at run time.
+    int result[ 4 ];
+    const RecordTraits kernel = { result, 1 };
+    Opm::dispatchPhaseConfiguration( Opm::GenericPhases, kernel );
+    BOOST_CHECK_EQUAL( result[ 0 ], Opm::GenericPhases );
+    BOOST_CHECK_EQUAL( result[ 1 ], 1 );
+}
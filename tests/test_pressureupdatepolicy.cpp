@@ -0,0 +1,244 @@
+/*
+  Copyright 2015 SINTEF ICT, Applied Mathematics.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "config.h"
+
+/* --- Boost.Test boilerplate --- */
+#if HAVE_DYNAMIC_BOOST_TEST
+#define BOOST_TEST_DYN_LINK
+#endif
+
+#define NVERBOSE  // Suppress own messages when throw()ing
+
+#define BOOST_TEST_MODULE PressureUpdatePolicyTest
+#include <boost/test/unit_test.hpp>
+
+/* --- our own headers --- */
+#include <opm/core/grid.h>
+#include <opm/core/grid/cart_grid.h>
+#include <opm/core/linalg/LinearSolverInterface.hpp>
+#include <opm/core/pressure/IncompTpfa.hpp>
+#include <opm/core/props/IncompPropertiesBasic.hpp>
+#include <opm/core/simulator/PressureUpdatePolicy.hpp>
+#include <opm/core/simulator/TwophaseState.hpp>
+#include <opm/core/simulator/WellState.hpp>
+#include <opm/core/transport/reorder/TransportSolverTwophaseReorder.hpp>
+#include <opm/core/utility/miscUtilities.hpp>
+#include <opm/core/utility/Units.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <memory>
+#include <numeric>
+#include <vector>
+
+namespace
+{
+    /// Jacobi preconditioned conjugate gradients for the symmetric
+    /// positive definite pressure systems.
+    class CGSolver : public Opm::LinearSolverInterface
+    {
+    public:
+        CGSolver() : tol_(1e-12) {}
+
+        virtual LinearSolverReport solve(const int size, const int /* nonzeros */,
+                                         const int* ia, const int* ja, const double* sa,
+                                         const double* rhs, double* solution,
+                                         const boost::any& /* add */) const
+        {
+            std::vector<double> r(rhs, rhs + size), z(size), p(size), q(size), d(size);
+            double bnorm = 0.0;
+            for (int i = 0; i < size; ++i) {
+                solution[i] = 0.0;
+                for (int k = ia[i]; k < ia[i + 1]; ++k) {
+                    if (ja[k] == i) {
+                        d[i] = sa[k];
+                    }
+                }
+                bnorm += rhs[i]*rhs[i];
+                z[i] = r[i]/d[i];
+            }
+            bnorm = std::sqrt(bnorm);
+            p = z;
+            double rz = std::inner_product(r.begin(), r.end(), z.begin(), 0.0);
+            LinearSolverReport rep;
+            rep.converged = false;
+            rep.iterations = 0;
+            rep.residual_reduction = 1.0;
+            for (int it = 0; it < 10*size; ++it) {
+                for (int i = 0; i < size; ++i) {
+                    q[i] = 0.0;
+                    for (int k = ia[i]; k < ia[i + 1]; ++k) {
+                        q[i] += sa[k]*p[ja[k]];
+                    }
+                }
+                const double alpha = rz/std::inner_product(p.begin(), p.end(), q.begin(), 0.0);
+                double rnorm = 0.0;
+                for (int i = 0; i < size; ++i) {
+                    solution[i] += alpha*p[i];
+                    r[i] -= alpha*q[i];
+                    rnorm += r[i]*r[i];
+                }
+                rep.iterations = it + 1;
+                rep.residual_reduction = std::sqrt(rnorm)/bnorm;
+                if (rep.residual_reduction < tol_) {
+                    rep.converged = true;
+                    break;
+                }
+                for (int i = 0; i < size; ++i) {
+                    z[i] = r[i]/d[i];
+                }
+                const double rz_new = std::inner_product(r.begin(), r.end(), z.begin(), 0.0);
+                for (int i = 0; i < size; ++i) {
+                    p[i] = z[i] + rz_new/rz*p[i];
+                }
+                rz = rz_new;
+            }
+            return rep;
+        }
+
+        virtual void setTolerance(const double tol) { tol_ = tol; }
+        virtual double getTolerance() const { return tol_; }
+
+    private:
+        double tol_;
+    };
+
+    Opm::IncompPropertiesBasic makeProps(const int num_cells)
+    {
+        std::vector<double> rho(2, 1000.0);
+        rho[1] = 800.0;
+        std::vector<double> mu(2, 1.0*Opm::prefix::centi*Opm::unit::Poise);
+        mu[1] = 5.0*Opm::prefix::centi*Opm::unit::Poise;
+        return Opm::IncompPropertiesBasic(2, Opm::SaturationPropsBasic::Quadratic, rho, mu,
+                                          0.2, 100.0*Opm::prefix::milli*Opm::unit::darcy,
+                                          2, num_cells);
+    }
+
+    /// Quarter five-spot waterflood on a 20x20 grid, 0.4 pore volumes
+    /// injected in num_steps steps with IncompTpfa and reorder transport.
+    /// Pressure is solved when the policy asks for it.
+    /// \return number of pressure solves
+    int waterflood(const double tolerance, const int num_steps, std::vector<double>& sat)
+    {
+        const int n = 20;
+        std::unique_ptr<UnstructuredGrid, void(*)(UnstructuredGrid*)>
+            grid(create_grid_cart2d(n, n, 10.0, 10.0), destroy_grid);
+        const int nc = grid->number_of_cells;
+        const Opm::IncompPropertiesBasic props = makeProps(nc);
+        std::vector<double> src(nc, 0.0);
+        const double q = 1e-5;
+        src[0] = q;
+        src[nc - 1] = -q;
+        CGSolver linsolver;
+        Opm::IncompTpfa psolver(*grid, props, linsolver, 0, 0, src, 0);
+        Opm::TransportSolverTwophaseReorder tsolver(*grid, props, 0, 1e-9, 30);
+        Opm::PressureUpdatePolicy policy(props, 0, 0, false, tolerance);
+
+        Opm::TwophaseState state;
+        state.init(nc, grid->number_of_faces, 2);
+        for (int c = 0; c < nc; ++c) {
+            state.saturation()[2*c] = 0.0;
+            state.saturation()[2*c + 1] = 1.0;
+        }
+        Opm::WellState well_state;
+        std::vector<double> porevol;
+        Opm::computePorevolume(*grid, props.porosity(), porevol);
+        const double dt = 0.4*std::accumulate(porevol.begin(), porevol.end(), 0.0)/q/num_steps;
+        std::vector<double> transport_src;
+        int num_solves = 0;
+        std::streambuf* cout_buf = std::cout.rdbuf(0);
+        for (int step = 0; step < num_steps; ++step) {
+            if (policy.pressureNeeded(state.saturation())) {
+                psolver.solve(dt, state, well_state);
+                ++num_solves;
+            }
+            Opm::computeTransportSource(*grid, src, state.faceflux(), 1.0, 0,
+                                        well_state.perfRates(), transport_src);
+            tsolver.solve(&porevol[0], &transport_src[0], dt, state);
+        }
+        std::cout.rdbuf(cout_buf);
+        sat = state.saturation();
+        return num_solves;
+    }
+}
+
+BOOST_AUTO_TEST_CASE(DisabledWhenFluxesDependOnMoreThanMobility)
+{
+    const Opm::IncompPropertiesBasic props = makeProps(4);
+    const double gravity[2] = { 0.0, 9.81 };
+    const double no_gravity[2] = { 0.0, 0.0 };
+
+    BOOST_CHECK(!Opm::PressureUpdatePolicy(props, 0, 0, false, 0.0).enabled());
+    BOOST_CHECK(!Opm::PressureUpdatePolicy(props, 0, 0, true, 0.1).enabled());
+    BOOST_CHECK(!Opm::PressureUpdatePolicy(props, 0, gravity, false, 0.1).enabled());
+    BOOST_CHECK(Opm::PressureUpdatePolicy(props, 0, no_gravity, false, 0.1).enabled());
+
+    // Disabled policies ask for pressure every step, even without any change.
+    Opm::PressureUpdatePolicy policy(props, 0, gravity, false, 0.1);
+    const std::vector<double> sat(8, 0.5);
+    for (int step = 0; step < 3; ++step) {
+        BOOST_CHECK(policy.pressureNeeded(sat));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(SkipsSolvesWhileMobilityIsUnchanged)
+{
+    const Opm::IncompPropertiesBasic props = makeProps(2);
+    Opm::PressureUpdatePolicy policy(props, 0, 0, false, 0.1);
+    std::vector<double> sat(4, 0.5);
+    BOOST_CHECK(policy.pressureNeeded(sat));
+    BOOST_CHECK(!policy.pressureNeeded(sat));
+    BOOST_CHECK_EQUAL(policy.lastChange(), 0.0);
+
+    // A small change is compared with the last solve, so repeated
+    // small changes eventually trigger a new solve.
+    sat[2] = 0.51;
+    sat[3] = 0.49;
+    BOOST_CHECK(!policy.pressureNeeded(sat));
+    BOOST_CHECK(policy.lastChange() > 0.0);
+    sat[2] = 0.6;
+    sat[3] = 0.4;
+    BOOST_CHECK(policy.pressureNeeded(sat));
+    BOOST_CHECK(policy.lastChange() >= 0.1);
+    BOOST_CHECK(!policy.pressureNeeded(sat));
+}
+
+BOOST_AUTO_TEST_CASE(WaterfloodStaysCloseToSolvingEveryStep)
+{
+    const int num_steps = 80;
+    std::vector<double> reference;
+    BOOST_CHECK_EQUAL(waterflood(0.0, num_steps, reference), num_steps);
+
+    const double tolerances[] = { 0.1, 0.3 };
+    const double max_errors[] = { 0.01, 0.03 };
+    for (int i = 0; i < 2; ++i) {
+        std::vector<double> sat;
+        const int num_solves = waterflood(tolerances[i], num_steps, sat);
+        double max_diff = 0.0;
+        for (std::size_t c = 0; c < sat.size(); c += 2) {
+            max_diff = std::max(max_diff, std::fabs(sat[c] - reference[c]));
+        }
+        std::cout << "Tolerance " << tolerances[i] << ": " << num_solves << " of " << num_steps
+                  << " pressure solves, max saturation difference " << max_diff << std::endl;
+        BOOST_CHECK(num_solves < num_steps);
+        BOOST_CHECK(max_diff < max_errors[i]);
+    }
+}
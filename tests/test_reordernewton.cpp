@@ -0,0 +1,190 @@
+/*
+  Copyright 2015 SINTEF ICT, Applied Mathematics.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "config.h"
+
+/* --- Boost.Test boilerplate --- */
+#if HAVE_DYNAMIC_BOOST_TEST
+#define BOOST_TEST_DYN_LINK
+#endif
+
+#define NVERBOSE  // Suppress own messages when throw()ing
+
+#define BOOST_TEST_MODULE ReorderNewtonTest
+#include <boost/test/unit_test.hpp>
+
+/* --- our own headers --- */
+#include <opm/core/grid.h>
+#include <opm/core/grid/cart_grid.h>
+#include <opm/core/props/IncompPropertiesBasic.hpp>
+#include <opm/core/simulator/TwophaseState.hpp>
+#include <opm/core/transport/reorder/TransportSolverTwophaseReorder.hpp>
+#include <opm/core/utility/Units.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+namespace
+{
+    Opm::IncompPropertiesBasic makeProps(const int num_cells)
+    {
+        std::vector<double> rho(2, 1000.0);
+        rho[1] = 800.0;
+        std::vector<double> mu(2, 1.0*Opm::prefix::centi*Opm::unit::Poise);
+        mu[1] = 5.0*Opm::prefix::centi*Opm::unit::Poise;
+        return Opm::IncompPropertiesBasic(2, Opm::SaturationPropsBasic::Quadratic, rho, mu,
+                                          0.2, 100.0*Opm::prefix::milli*Opm::unit::darcy,
+                                          2, num_cells);
+    }
+
+    /// Uniform flow in the x direction, fed by sources in the first
+    /// column and drained by sinks in the last, plus a divergence free
+    /// vortex filling the grid. The stream function of the vortex is
+    /// eps*sin(pi x/Lx)*sin(pi y/Ly), and with a strong vortex most of
+    /// the grid is one strongly connected component.
+    void vortexFlow(const UnstructuredGrid& g, const int nx, const int ny, const double eps,
+                    std::vector<double>& flux, std::vector<double>& src)
+    {
+        const double pi = 3.14159265358979323846;
+        flux.assign(g.number_of_faces, 0.0);
+        src.assign(g.number_of_cells, 0.0);
+        for (int f = 0; f < g.number_of_faces; ++f) {
+            if (g.face_cells[2*f] != -1 && g.face_cells[2*f + 1] != -1) {
+                flux[f] = g.face_normals[2*f];
+            }
+            // The flux through a face is the difference of the stream
+            // function between its end nodes, so the vortex is exactly
+            // divergence free. It vanishes on the outer boundary.
+            const int a = g.face_nodes[g.face_nodepos[f]];
+            const int b = g.face_nodes[g.face_nodepos[f] + 1];
+            double psi[2];
+            const int nodes[2] = { a, b };
+            for (int i = 0; i < 2; ++i) {
+                const double x = g.node_coordinates[2*nodes[i]];
+                const double y = g.node_coordinates[2*nodes[i] + 1];
+                psi[i] = eps*std::sin(pi*x/nx)*std::sin(pi*y/ny);
+            }
+            const double tx = g.node_coordinates[2*b] - g.node_coordinates[2*a];
+            const double ty = g.node_coordinates[2*b + 1] - g.node_coordinates[2*a + 1];
+            const double cross = tx*g.face_normals[2*f + 1] - ty*g.face_normals[2*f];
+            flux[f] += (cross > 0.0 ? 1.0 : -1.0) * (psi[1] - psi[0]);
+        }
+        for (int c = 0; c < g.number_of_cells; ++c) {
+            if (c % nx == 0) {
+                src[c] = 1.0;
+            } else if (c % nx == nx - 1) {
+                src[c] = -1.0;
+            }
+        }
+    }
+
+    /// Inject water for 5 seconds, about 0.8 pore volumes, in num_steps
+    /// steps with the given Newton threshold.
+    Opm::TransportSolverTwophaseReorder::MultiCellStatistics
+    runTransport(const UnstructuredGrid& g, const int nx, const int ny,
+                 const int num_steps, const int newton_min_scc_size,
+                 std::vector<double>& sat)
+    {
+        const int nc = g.number_of_cells;
+        const Opm::IncompPropertiesBasic props = makeProps(nc);
+        Opm::TransportSolverTwophaseReorder solver(g, props, 0, 1e-9, 30, newton_min_scc_size);
+
+        Opm::TwophaseState state;
+        state.init(nc, g.number_of_faces, 2);
+        for (int c = 0; c < nc; ++c) {
+            state.saturation()[2*c] = 0.0;
+            state.saturation()[2*c + 1] = 1.0;
+        }
+        std::vector<double> src;
+        vortexFlow(g, nx, ny, 30.0, state.faceflux(), src);
+        std::vector<double> porevol(nc);
+        for (int c = 0; c < nc; ++c) {
+            porevol[c] = props.porosity()[c]*g.cell_volumes[c];
+        }
+        std::streambuf* cout_buf = std::cout.rdbuf(0);
+        const double dt = 5.0/num_steps;
+        for (int step = 0; step < num_steps; ++step) {
+            solver.solve(&porevol[0], &src[0], dt, state);
+        }
+        std::cout.rdbuf(cout_buf);
+        sat = state.saturation();
+        return solver.multiCellStatistics();
+    }
+
+    double maxDifference(const std::vector<double>& a, const std::vector<double>& b)
+    {
+        BOOST_REQUIRE_EQUAL(a.size(), b.size());
+        double max_diff = 0.0;
+        for (std::size_t i = 0; i < a.size(); ++i) {
+            max_diff = std::max(max_diff, std::fabs(a[i] - b[i]));
+        }
+        return max_diff;
+    }
+}
+
+BOOST_AUTO_TEST_CASE(NewtonMatchesGaussSeidelOnLargeComponent)
+{
+    const int nx = 30, ny = 20;
+    UnstructuredGrid* g = create_grid_cart2d(nx, ny, 1.0, 1.0);
+
+    std::vector<double> sat_gs;
+    const Opm::TransportSolverTwophaseReorder::MultiCellStatistics gs
+        = runTransport(*g, nx, ny, 20, 0, sat_gs);
+    BOOST_CHECK(gs.gauss_seidel_components > 0);
+    BOOST_CHECK_EQUAL(gs.newton_components, 0);
+
+    std::vector<double> sat_newton;
+    const Opm::TransportSolverTwophaseReorder::MultiCellStatistics newton
+        = runTransport(*g, nx, ny, 20, 50, sat_newton);
+    BOOST_CHECK_EQUAL(newton.newton_failures, 0);
+    BOOST_CHECK_EQUAL(newton.gauss_seidel_components, 0);
+    BOOST_CHECK_EQUAL(newton.newton_components, gs.gauss_seidel_components);
+    BOOST_CHECK(newton.newton_iterations < gs.gauss_seidel_sweeps);
+
+    // The water front must have reached the vortex.
+    BOOST_CHECK(*std::max_element(sat_gs.begin(), sat_gs.end()) > 0.5);
+
+    // Both methods solve the same nonlinear systems to a residual
+    // tolerance of 1e-9.
+    BOOST_CHECK(maxDifference(sat_gs, sat_newton) < 1e-6);
+
+    destroy_grid(g);
+}
+
+BOOST_AUTO_TEST_CASE(GaussSeidelFallbackWhenNewtonFails)
+{
+    const int nx = 30, ny = 20;
+    UnstructuredGrid* g = create_grid_cart2d(nx, ny, 1.0, 1.0);
+
+    // With twice the time step Newton does not converge on the first
+    // step, where the front enters the dry vortex, and the component is
+    // solved by Gauss-Seidel instead.
+    std::vector<double> sat_gs;
+    runTransport(*g, nx, ny, 10, 0, sat_gs);
+    std::vector<double> sat_newton;
+    const Opm::TransportSolverTwophaseReorder::MultiCellStatistics newton
+        = runTransport(*g, nx, ny, 10, 50, sat_newton);
+    BOOST_CHECK(newton.newton_failures > 0);
+    BOOST_CHECK_EQUAL(newton.gauss_seidel_components, newton.newton_failures);
+    BOOST_CHECK(maxDifference(sat_gs, sat_newton) < 1e-6);
+
+    destroy_grid(g);
+}
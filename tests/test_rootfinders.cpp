@@ -0,0 +1,123 @@
+/*
+  Copyright 2015 SINTEF ICT, Applied Mathematics.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "config.h"
+
+/* --- Boost.Test boilerplate --- */
+#if HAVE_DYNAMIC_BOOST_TEST
+#define BOOST_TEST_DYN_LINK
+#endif
+
+#define NVERBOSE  // Suppress own messages when throw()ing
+
+#define BOOST_TEST_MODULE RootFindersTest
+#include <boost/test/unit_test.hpp>
+
+/* --- our own headers --- */
+#include <opm/core/utility/RootFinders.hpp>
+
+#include <cmath>
+#include <vector>
+
+using namespace Opm;
+
+namespace
+{
+    // f_i(x) = x^3 - c_i
+    struct CubeScalar
+    {
+        explicit CubeScalar(const double c) : c_(c) {}
+        double operator()(const double x) const { return x*x*x - c_; }
+        double c_;
+    };
+
+    struct CubeBatch
+    {
+        explicit CubeBatch(const std::vector<double>& c) : c_(c), calls(0) {}
+        void operator()(const int num, const int* lanes,
+                        const double* x, double* fx) const
+        {
+            ++calls;
+            for (int k = 0; k < num; ++k) {
+                fx[k] = x[k]*x[k]*x[k] - c_[lanes[k]];
+            }
+        }
+        const std::vector<double>& c_;
+        mutable int calls;
+    };
+}
+
+BOOST_AUTO_TEST_CASE(batchMatchesScalar)
+{
+    typedef RegulaFalsi<ThrowOnError> Solver;
+    const int n = 50;
+    std::vector<double> c(n), a(n, 0.0), b(n, 4.0), guess(n);
+    for (int i = 0; i < n; ++i) {
+        c[i] = 0.1 + 1.2*i;
+        guess[i] = 0.05*i;
+    }
+    const double tol = 1e-12;
+    const int max_iter = 100;
+
+    // Without initial guess.
+    {
+        CubeBatch f(c);
+        std::vector<double> x(n);
+        std::vector<int> iters(n);
+        Solver::solveBatch(f, n, &a[0], &b[0], max_iter, tol, &x[0], &iters[0]);
+        for (int i = 0; i < n; ++i) {
+            int it = -1;
+            const double xs = Solver::solve(CubeScalar(c[i]), a[i], b[i], max_iter, tol, it);
+            BOOST_CHECK_EQUAL(x[i], xs);
+            BOOST_CHECK_EQUAL(iters[i], it);
+            BOOST_CHECK_CLOSE(x[i], std::cbrt(c[i]), 1e-8);
+        }
+    }
+
+    // With initial guess.
+    {
+        CubeBatch f(c);
+        std::vector<double> x(n);
+        std::vector<int> iters(n);
+        Solver::solveBatch(f, n, &guess[0], &a[0], &b[0], max_iter, tol, &x[0], &iters[0]);
+        for (int i = 0; i < n; ++i) {
+            int it = -1;
+            const double xs = Solver::solve(CubeScalar(c[i]), guess[i], a[i], b[i], max_iter, tol, it);
+            BOOST_CHECK_EQUAL(x[i], xs);
+            BOOST_CHECK_CLOSE(x[i], std::cbrt(c[i]), 1e-8);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(batchBracketingFailure)
+{
+    std::vector<double> c(2, 1.0);
+    c[1] = 100.0;  // Root outside [0, 4].
+    std::vector<double> a(2, 0.0), b(2, 4.0), x(2);
+    std::vector<int> iters(2);
+    CubeBatch f(c);
+    typedef RegulaFalsi<ContinueOnError> Solver;
+    Solver::solveBatch(f, 2, &a[0], &b[0], 100, 1e-12, &x[0], &iters[0]);
+    BOOST_CHECK_CLOSE(x[0], 1.0, 1e-8);
+    BOOST_CHECK_EQUAL(x[1], 4.0);
+
+    typedef RegulaFalsi<ThrowOnError> ThrowingSolver;
+    BOOST_CHECK_THROW(ThrowingSolver::solveBatch(f, 2, &a[0], &b[0], 100, 1e-12, &x[0], &iters[0]),
+                      std::exception);
+}
@@ -0,0 +1,85 @@
+/*
+  Copyright 2015 SINTEF ICT, Applied Mathematics.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "config.h"
+
+/* --- Boost.Test boilerplate --- */
+#if HAVE_DYNAMIC_BOOST_TEST
+#define BOOST_TEST_DYN_LINK
+#endif
+
+#define NVERBOSE  // Suppress own messages when throw()ing
+
+#define BOOST_TEST_MODULE SaturationPropsBasicTest
+#include <boost/test/unit_test.hpp>
+
+/* --- our own headers --- */
+#include <opm/core/props/satfunc/SaturationPropsBasic.hpp>
+
+#include <limits>
+#include <vector>
+
+namespace
+{
+    void checkRelperm( const int np, const Opm::SaturationPropsBasic::RelPermFunc func )
+    {
+        Opm::SaturationPropsBasic props;
+        props.init( np, func );
+
+        const int n = 37;
+        std::vector<double> s( n*np );
+        for( int i = 0; i < n*np; ++i ) {
+            s[ i ] = double( i % 11 ) / 10.0;
+        }
+        // Outputs are fully overwritten.
+        const double nan = std::numeric_limits<double>::quiet_NaN();
+        std::vector<double> kr( n*np, nan ), kr2( n*np, nan ), dkrds( n*np*np, nan );
+        props.relperm( n, &s[ 0 ], &kr[ 0 ], &dkrds[ 0 ] );
+        props.relperm( n, &s[ 0 ], &kr2[ 0 ], 0 );
+
+        for( int i = 0; i < n; ++i ) {
+            for( int p = 0; p < np; ++p ) {
+                const double si = s[ i*np + p ];
+                double expected = 1.0, dexpected = 0.0;
+                if( func == Opm::SaturationPropsBasic::Linear ) {
+                    expected = si;
+                    dexpected = 1.0;
+                } else if( func == Opm::SaturationPropsBasic::Quadratic ) {
+                    expected = si*si;
+                    dexpected = 2.0*si;
+                }
+                BOOST_CHECK_EQUAL( kr[ i*np + p ], expected );
+                BOOST_CHECK_EQUAL( kr2[ i*np + p ], expected );
+                for( int q = 0; q < np; ++q ) {
+                    // m_{pq} = dkr_p/ds_q in Fortran order.
+                    BOOST_CHECK_EQUAL( dkrds[ i*np*np + q*np + p ], p == q ? dexpected : 0.0 );
+                }
+            }
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(relpermAndDerivatives)
+{
+    checkRelperm( 1, Opm::SaturationPropsBasic::Constant );
+    for( int np = 1; np <= 3; ++np ) {
+        checkRelperm( np, Opm::SaturationPropsBasic::Linear );
+        checkRelperm( np, Opm::SaturationPropsBasic::Quadratic );
+    }
+}
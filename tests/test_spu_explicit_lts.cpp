@@ -0,0 +1,210 @@
+/*
+  Copyright 2015 SINTEF ICT, Applied Mathematics.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "config.h"
+
+/* --- Boost.Test boilerplate --- */
+#if HAVE_DYNAMIC_BOOST_TEST
+#define BOOST_TEST_DYN_LINK
+#endif
+
+#define NVERBOSE  // Suppress own messages when throw()ing
+
+#define BOOST_TEST_MODULE SpuExplicitLtsTest
+#include <boost/test/unit_test.hpp>
+
+/* --- our own headers --- */
+#include <opm/core/grid.h>
+#include <opm/core/grid/cart_grid.h>
+#include <opm/core/transport/minimal/spu_explicit.h>
+#include <opm/core/transport/minimal/TransportSolverTwophaseExplicitLts.hpp>
+#include <opm/core/props/IncompPropertiesBasic.hpp>
+#include <opm/core/simulator/TwophaseState.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <vector>
+
+namespace
+{
+    struct VortexFlow
+    {
+        explicit VortexFlow( const int n )
+            : grid( create_grid_cart2d( n, n, 1.0, 1.0 ) ),
+              dflux( grid->number_of_faces, 0.0 ),
+              gflux( grid->number_of_faces, 0.0 ),
+              src( grid->number_of_cells, 0.0 ),
+              pv( grid->number_of_cells, 0.2 ),
+              s0( grid->number_of_cells ),
+              tab( 2 * ntab )
+        {
+            // Divergence-free flux from a stream function that is
+            // concentrated near the centre of the domain.
+            const double* x = grid->node_coordinates;
+            std::vector<double> psi( grid->number_of_nodes );
+            for( int i = 0; i < grid->number_of_nodes; ++i ) {
+                const double dx = x[ 2*i ] - 0.5*n, dy = x[ 2*i+1 ] - 0.5*n;
+                psi[ i ] = 0.1*n*std::exp( -( dx*dx + dy*dy ) / ( 0.01*n*n ) );
+            }
+            for( int f = 0; f < grid->number_of_faces; ++f ) {
+                if( grid->face_cells[ 2*f ] < 0 || grid->face_cells[ 2*f+1 ] < 0 ) {
+                    continue;
+                }
+                int a = grid->face_nodes[ grid->face_nodepos[ f ] ];
+                int b = grid->face_nodes[ grid->face_nodepos[ f ] + 1 ];
+                const double tx = x[ 2*b ] - x[ 2*a ], ty = x[ 2*b+1 ] - x[ 2*a+1 ];
+                if( ty*grid->face_normals[ 2*f ] - tx*grid->face_normals[ 2*f+1 ] < 0.0 ) {
+                    std::swap( a, b );
+                }
+                dflux[ f ] = psi[ b ] - psi[ a ];
+            }
+            for( int c = 0; c < grid->number_of_cells; ++c ) {
+                s0[ c ] = grid->cell_centroids[ 2*c ] < 0.5*n ? 1.0 : 0.0;
+            }
+            for( int i = 0; i < ntab; ++i ) {
+                const double s = i * h();
+                tab[ i ] = s*s;
+                tab[ ntab + i ] = ( 1.0 - s )*( 1.0 - s );
+            }
+        }
+
+        ~VortexFlow() { destroy_grid( grid ); }
+
+        int step( const std::vector<double>& sin, std::vector<double>& sout,
+                  const double dt, const int maxlevel, int* level = 0 )
+        {
+            sout.resize( sin.size() );
+            return spu_explicit_lts( grid, const_cast<double*>( &sin[ 0 ] ), &sout[ 0 ],
+                                     h(), 0.0, ntab, &tab[ 0 ],
+                                     &dflux[ 0 ], &gflux[ 0 ], &src[ 0 ], &pv[ 0 ],
+                                     dt, 0.5, maxlevel, level );
+        }
+
+        double waterVolume( const std::vector<double>& s ) const
+        {
+            return std::inner_product( s.begin(), s.end(), pv.begin(), 0.0 );
+        }
+
+        static const int ntab = 101;
+        static double h() { return 1.0 / ( ntab - 1 ); }
+        UnstructuredGrid* grid;
+        std::vector<double> dflux, gflux, src, pv, s0, tab;
+    };
+}
+
+BOOST_AUTO_TEST_CASE(singleLevelMatchesGlobalStep)
+{
+    VortexFlow flow( 10 );
+    std::fill( flow.pv.begin(), flow.pv.end(), 1.0 );
+    const double dt = 0.01;
+    std::vector<double> s;
+    std::vector<int> level( flow.grid->number_of_cells, -1 );
+    BOOST_CHECK_EQUAL( flow.step( flow.s0, s, dt, 0, &level[ 0 ] ),
+                       flow.grid->number_of_cells );
+    BOOST_CHECK( std::count( level.begin(), level.end(), 0 ) == int( level.size() ) );
+
+    std::vector<double> mob( 2 * flow.grid->number_of_cells ), ref( s.size() );
+    for( std::size_t c = 0; c < s.size(); ++c ) {
+        mob[ 2*c ] = flow.s0[ c ] * flow.s0[ c ];
+        mob[ 2*c+1 ] = ( 1.0 - flow.s0[ c ] ) * ( 1.0 - flow.s0[ c ] );
+    }
+    spu_explicit( flow.grid, &flow.s0[ 0 ], &ref[ 0 ], &mob[ 0 ],
+                  &flow.dflux[ 0 ], &flow.gflux[ 0 ], &flow.src[ 0 ], dt );
+    for( std::size_t c = 0; c < s.size(); ++c ) {
+        BOOST_CHECK_CLOSE( s[ c ], ref[ c ], 1e-10 );
+    }
+}
+
+BOOST_AUTO_TEST_CASE(localStepsAreConservativeAndAccurate)
+{
+    VortexFlow flow( 40 );
+    const double dt = 1.0;
+    std::vector<int> level( flow.grid->number_of_cells );
+    std::vector<double> s, tmp;
+
+    // Too few levels for the fastest cells.
+    s.assign( flow.s0.size(), -1.0 );
+    BOOST_CHECK_EQUAL( flow.step( flow.s0, s, dt, 0 ), -1 );
+    BOOST_CHECK( s[ 0 ] == -1.0 );
+
+    const int updates = flow.step( flow.s0, s, dt, 20, &level[ 0 ] );
+    const int nlevel = *std::max_element( level.begin(), level.end() );
+    BOOST_REQUIRE_GT( nlevel, 1 );
+    BOOST_CHECK_LT( updates, flow.grid->number_of_cells << nlevel );
+    BOOST_CHECK_CLOSE( flow.waterVolume( s ), flow.waterVolume( flow.s0 ), 1e-10 );
+    BOOST_CHECK_GE( *std::min_element( s.begin(), s.end() ), 0.0 );
+    BOOST_CHECK_LE( *std::max_element( s.begin(), s.end() ), 1.0 + 1e-8 );
+
+    // Reference solution with the finest step everywhere.
+    std::vector<double> ref = flow.s0;
+    for( int i = 0; i < ( 1 << nlevel ); ++i ) {
+        BOOST_REQUIRE_EQUAL( flow.step( ref, tmp, dt / ( 1 << nlevel ), 0 ),
+                             flow.grid->number_of_cells );
+        ref.swap( tmp );
+    }
+    double diff = 0.0;
+    for( std::size_t c = 0; c < s.size(); ++c ) {
+        diff += std::fabs( s[ c ] - ref[ c ] );
+    }
+    BOOST_CHECK_LT( diff / s.size(), 1e-2 );
+}
+
+BOOST_AUTO_TEST_CASE(transportSolverWrapsKernel)
+{
+    VortexFlow flow( 40 );
+    const int nc = flow.grid->number_of_cells;
+    const double dt = 1.0;
+    // Quadratic relperms with unit viscosities reproduce the kernel's tables.
+    Opm::IncompPropertiesBasic props( 2, Opm::SaturationPropsBasic::Quadratic,
+                                      std::vector<double>( 2, 1000.0 ),
+                                      std::vector<double>( 2, 1.0 ),
+                                      0.2, 1e-13, 2, nc );
+    Opm::TwophaseState state;
+    state.init( *flow.grid, 2 );
+    for( int c = 0; c < nc; ++c ) {
+        state.saturation()[ 2*c ] = flow.s0[ c ];
+        state.saturation()[ 2*c+1 ] = 1.0 - flow.s0[ c ];
+    }
+    state.faceflux() = flow.dflux;
+    const Opm::TwophaseState init = state;
+
+    std::vector<double> ref;
+    const int updates = flow.step( flow.s0, ref, dt, 20 );
+    Opm::TransportSolverTwophaseExplicitLts solver( *flow.grid, props, 0.5, 20, VortexFlow::ntab );
+    solver.solve( &flow.pv[ 0 ], &flow.src[ 0 ], dt, state );
+    BOOST_CHECK_EQUAL( solver.getCellUpdates(), updates );
+    for( int c = 0; c < nc; ++c ) {
+        BOOST_CHECK_CLOSE( state.saturation()[ 2*c ], ref[ c ], 1e-10 );
+        BOOST_CHECK_CLOSE( state.saturation()[ 2*c ] + state.saturation()[ 2*c+1 ], 1.0, 1e-12 );
+    }
+
+    // Too few levels: the step is split in halves instead of failing.
+    state = init;
+    Opm::TransportSolverTwophaseExplicitLts coarse( *flow.grid, props, 0.5, 0, VortexFlow::ntab );
+    coarse.solve( &flow.pv[ 0 ], &flow.src[ 0 ], dt, state );
+    BOOST_CHECK_GT( coarse.getCellUpdates(), nc );
+    std::vector<double> s( nc );
+    for( int c = 0; c < nc; ++c ) {
+        s[ c ] = state.saturation()[ 2*c ];
+    }
+    BOOST_CHECK_CLOSE( flow.waterVolume( s ), flow.waterVolume( flow.s0 ), 1e-10 );
+    BOOST_CHECK_GE( *std::min_element( s.begin(), s.end() ), 0.0 );
+    BOOST_CHECK_LE( *std::max_element( s.begin(), s.end() ), 1.0 + 1e-8 );
+}
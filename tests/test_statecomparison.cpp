@@ -0,0 +1,132 @@
+/*
+  Copyright 2015 SINTEF ICT, Applied Mathematics.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "config.h"
+
+/* --- Boost.Test boilerplate --- */
+#if HAVE_DYNAMIC_BOOST_TEST
+#define BOOST_TEST_DYN_LINK
+#endif
+
+#define NVERBOSE  // Suppress own messages when throw()ing
+
+#define BOOST_TEST_MODULE StateComparisonTest
+#include <boost/test/unit_test.hpp>
+
+/* --- our own headers --- */
+#include <opm/core/simulator/StateComparison.hpp>
+#include <opm/core/simulator/SimulatorState.hpp>
+#include <opm/core/simulator/WellState.hpp>
+
+#include <cmath>
+#include <limits>
+#include <sstream>
+#include <vector>
+
+BOOST_AUTO_TEST_CASE(rawArrays)
+{
+    const std::size_t n = 100000;
+    std::vector<double> a( n ), b( n );
+    for( std::size_t i = 0; i < n; ++i ) {
+        a[ i ] = b[ i ] = 1.0 + std::sin( double( i ) );
+    }
+    const Opm::ApproxComparator comparator( 1e-8 );
+    BOOST_CHECK( comparator.compare( "x", a, b ).equal() );
+
+    b[ 70000 ] += 1e-3;
+    b[ 5 ] += 2e-3;
+    b[ 6 ] *= 1.0 + 1e-10;  // within the tolerance
+    const Opm::ArrayComparison c = comparator.compare( "x", a, b );
+    BOOST_CHECK( !c.equal() );
+    BOOST_CHECK( c.complete );
+    BOOST_CHECK_EQUAL( c.size, n );
+    BOOST_CHECK_EQUAL( c.num_mismatches, 2u );
+    BOOST_REQUIRE_EQUAL( c.first_mismatches.size(), 2u );
+    BOOST_CHECK_EQUAL( c.first_mismatches[ 0 ], 5u );
+    BOOST_CHECK_EQUAL( c.first_mismatches[ 1 ], 70000u );
+    BOOST_CHECK_CLOSE( c.max_abs_error, 2e-3, 1e-6 );
+    BOOST_CHECK_CLOSE( c.rms_error, std::sqrt( 5e-6 / n ), 1e-4 );
+
+    // Early exit stops after the first block with a mismatch.
+    const Opm::ArrayComparison e = Opm::ApproxComparator( 1e-8, 0.0, true ).compare( "x", a, b );
+    BOOST_CHECK( !e.equal() );
+    BOOST_CHECK_GE( e.num_mismatches, 1u );
+    BOOST_CHECK_EQUAL( e.first_mismatches[ 0 ], 5u );
+
+    // An absolute tolerance accepts the differences.
+    BOOST_CHECK( Opm::ApproxComparator( 1e-8, 1e-2 ).compare( "x", a, b ).equal() );
+
+    // Arrays of different length.
+    b.pop_back();
+    BOOST_CHECK( comparator.compare( "x", a, b ).size_mismatch );
+}
+
+BOOST_AUTO_TEST_CASE(notANumber)
+{
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    const double a[] = { 1.0, nan, 3.0 };
+    const double b[] = { 1.0, nan, nan };
+    const Opm::ArrayComparison c = Opm::ApproxComparator().compare( "x", a, b, 3 );
+    BOOST_CHECK_EQUAL( c.num_mismatches, 1u );
+    BOOST_CHECK_EQUAL( c.first_mismatches[ 0 ], 2u );
+    BOOST_CHECK_EQUAL( c.max_abs_error, 0.0 );
+}
+
+BOOST_AUTO_TEST_CASE(states)
+{
+    Opm::SimulatorState a, b;
+    a.init( 1000, 2100, 2 );
+    b.init( 1000, 2100, 2 );
+    BOOST_CHECK( a.equals( b ) );
+
+    b.saturation()[ 17 ] = 0.5;
+    a.registerCellData( "EXTRA", 1 );
+    const Opm::ApproxComparator comparator;
+    const std::vector<Opm::ArrayComparison> result = comparator.compare( a, b );
+    BOOST_CHECK( !Opm::allEqual( result ) );
+    BOOST_CHECK( !a.equals( b ) );
+    int different = 0;
+    for( std::size_t i = 0; i < result.size(); ++i ) {
+        if( result[ i ].name == "SATURATION" ) {
+            BOOST_CHECK_EQUAL( result[ i ].first_mismatches.at( 0 ), 17u );
+        } else if( result[ i ].name == "EXTRA" ) {
+            BOOST_CHECK( result[ i ].size_mismatch );
+        } else {
+            BOOST_CHECK( result[ i ].equal() );
+        }
+        different += !result[ i ].equal();
+    }
+    BOOST_CHECK_EQUAL( different, 2 );
+
+    std::ostringstream os;
+    for( std::size_t i = 0; i < result.size(); ++i ) {
+        os << result[ i ] << '\n';
+    }
+    BOOST_CHECK( os.str().find( "SATURATION: DIFFERENT" ) != std::string::npos );
+
+    Opm::WellState wa, wb;
+    wa.bhp().assign( 3, 2e7 );
+    wb.bhp().assign( 3, 2e7 );
+    wa.perfRates().assign( 5, 1.0 );
+    wb.perfRates().assign( 5, 1.0 );
+    BOOST_CHECK( Opm::allEqual( comparator.compare( wa, wb ) ) );
+    wb.perfRates()[ 4 ] = 1.1;
+    const std::vector<Opm::ArrayComparison> wells = comparator.compare( wa, wb );
+    BOOST_CHECK( !Opm::allEqual( wells ) );
+}
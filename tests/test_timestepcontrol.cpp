@@ -0,0 +1,189 @@
+/*
+  Copyright 2015 SINTEF ICT, Applied Mathematics.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "config.h"
+
+/* --- Boost.Test boilerplate --- */
+#if HAVE_DYNAMIC_BOOST_TEST
+#define BOOST_TEST_DYN_LINK
+#endif
+
+#define NVERBOSE  // Suppress own messages when throw()ing
+
+#define BOOST_TEST_MODULE TimeStepControlTest
+#include <boost/test/unit_test.hpp>
+
+/* --- our own headers --- */
+#include <opm/core/simulator/TimeStepControl.hpp>
+#include <opm/core/simulator/RelativeChange.hpp>
+#include <opm/core/simulator/BlackoilState.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+    struct NoChange : public Opm::RelativeChangeInterface
+    {
+        double relativeChange() const { return 1e-3; }
+    };
+
+    /// Synthetic simulator: a step of size dt costs a fixed overhead plus
+    /// a part growing with dt, and fails to converge if dt exceeds a limit.
+    struct SyntheticRun
+    {
+        double overhead;
+        double costPerTime;
+        double failureLimit;
+
+        double seconds( const double dt ) const { return overhead + costPerTime * dt; }
+        bool converges( const double dt ) const { return dt <= failureLimit; }
+        int iterations( const double dt ) const { return 5 + int( dt ); }
+
+        /// Run to end_time with the restart logic of AdaptiveTimeStepping,
+        /// return the total (synthetic) wall-clock seconds used.
+        double run( const Opm::TimeStepControlInterface& control, const double end_time ) const
+        {
+            NoChange change;
+            double time = 0.0, wall = 0.0, dt = 1.0;
+            int attempts = 0;
+            while( time < end_time && attempts < 10000 ) {
+                ++attempts;
+                const double step = std::min( dt, end_time - time );
+                const double cost = seconds( step );
+                wall += cost;
+                const bool ok = converges( step );
+                control.recordStepCost( step, cost, ok );
+                if( ok ) {
+                    time += step;
+                    dt = std::min( control.computeTimeStepSize( step, iterations( step ), change ), 3.0 * step );
+                }
+                else {
+                    dt = 0.33 * step;
+                }
+            }
+            BOOST_REQUIRE( time >= end_time );
+            return wall;
+        }
+    };
+}
+
+BOOST_AUTO_TEST_CASE(costModel)
+{
+    Opm::ThroughputTimeStepControl control( 0.0 );
+    BOOST_CHECK_LT( control.predictedCost( 1.0 ), 0.0 );
+    // Cost proportional to sqrt(dt).
+    for( int i = 0; i < 8; ++i ) {
+        const double dt = std::pow( 2.0, i );
+        control.recordStepCost( dt, 3.0 * std::sqrt( dt ), true );
+    }
+    BOOST_CHECK_CLOSE( control.predictedCost( 10.0 ), 3.0 * std::sqrt( 10.0 ), 1.0 );
+
+    // Failures make larger steps riskier.
+    control.recordStepCost( 200.0, 50.0, false );
+    BOOST_CHECK_LT( control.failureProbability( 10.0 ), control.failureProbability( 100.0 ) );
+    BOOST_CHECK_LT( control.failureProbability( 100.0 ), control.failureProbability( 400.0 ) );
+
+    // The failed attempt is charged with the cost it was recorded with.
+    BOOST_CHECK_CLOSE( control.predictedFailureCost( 200.0 ), 50.0, 1e-8 );
+}
+
+BOOST_AUTO_TEST_CASE(expensiveFailuresGiveSmallerSteps)
+{
+    NoChange change;
+    Opm::ThroughputTimeStepControl cheap( 0.0 ), expensive( 0.0 );
+    for( int i = 0; i < 6; ++i ) {
+        const double dt = std::pow( 2.0, i );
+        cheap.recordStepCost( dt, 10.0 + dt, true );
+        expensive.recordStepCost( dt, 10.0 + dt, true );
+    }
+    cheap.recordStepCost( 64.0, 10.0, false );
+    expensive.recordStepCost( 64.0, 1000.0, false );
+    BOOST_CHECK_GT( expensive.predictedFailureCost( 64.0 ), cheap.predictedFailureCost( 64.0 ) );
+    BOOST_CHECK_LT( expensive.computeTimeStepSize( 32.0, 10, change ),
+                    cheap.computeTimeStepSize( 32.0, 10, change ) );
+}
+
+BOOST_AUTO_TEST_CASE(throughputBeatsIterationCount)
+{
+    // With a large fixed cost per step, larger steps pay off until they
+    // fail to converge.
+    const SyntheticRun model = { 10.0, 0.1, 40.0 };
+    const double end_time = 2000.0;
+
+    const Opm::ThroughputTimeStepControl throughput( 0.0, 20, 3.0 );
+    const Opm::SimpleIterationCountTimeStepControl iterationCount( 20, 0.75, 1.25 );
+    const double wallThroughput = model.run( throughput, end_time );
+    const double wallIterationCount = model.run( iterationCount, end_time );
+    BOOST_TEST_MESSAGE( "synthetic wall time, throughput: " << wallThroughput
+                        << ", iteration count: " << wallIterationCount );
+    BOOST_CHECK_LT( wallThroughput, wallIterationCount );
+}
+
+namespace
+{
+    double relativeChange( const std::vector<double>& u0, const std::vector<double>& u1 )
+    {
+        double diff2 = 0.0, norm2 = 0.0;
+        for( std::size_t i = 0; i < u1.size(); ++i ) {
+            diff2 += ( u1[ i ] - u0[ i ] ) * ( u1[ i ] - u0[ i ] );
+            norm2 += u1[ i ] * u1[ i ];
+        }
+        return std::sqrt( diff2 / norm2 );
+    }
+}
+
+BOOST_AUTO_TEST_CASE(fusedRelativeChange)
+{
+    const int nc = 50, np = 3;
+    Opm::BlackoilState previous, current;
+    previous.init( nc, 0, np );
+    current.init( nc, 0, np );
+    for( int c = 0; c < nc; ++c ) {
+        previous.pressure()[ c ]    = 1e7 + 1e3 * c;
+        current.pressure()[ c ]     = 1e7 + 1.1e3 * c;
+        previous.gasoilratio()[ c ] = 50.0 + c;
+        current.gasoilratio()[ c ]  = 50.0 + 0.5 * c;
+        previous.rv()[ c ]          = 0.0;
+        current.rv()[ c ]           = 1e-4 * c;
+        for( int p = 0; p < np; ++p ) {
+            previous.saturation()[ np*c + p ] = ( p + 1.0 ) / 6.0;
+            current.saturation()[ np*c + p ]  = ( p + 1.0 + 0.01 * c * ( p - 1 ) ) / 6.0;
+        }
+    }
+
+    typedef Opm::FusedRelativeChange RC;
+    RC fused;
+    fused.compute( previous, current );
+    const double pressure = relativeChange( previous.pressure(), current.pressure() );
+    const double saturation = relativeChange( previous.saturation(), current.saturation() );
+    const double rs = relativeChange( previous.gasoilratio(), current.gasoilratio() );
+    BOOST_CHECK_CLOSE( fused.relativeChange( RC::Pressure ), pressure, 1e-10 );
+    BOOST_CHECK_CLOSE( fused.relativeChange( RC::Saturation ), saturation, 1e-10 );
+    BOOST_CHECK_CLOSE( fused.relativeChange( RC::DissolvedGas ), rs, 1e-10 );
+    // Rv goes from zero, so its relative change is one.
+    BOOST_CHECK_CLOSE( fused.relativeChange( RC::VaporizedOil ), 1.0, 1e-10 );
+    BOOST_CHECK_CLOSE( fused.relativeChange(), 1.0, 1e-10 );
+
+    // Only pressure and saturation for the base class.
+    fused.compute( static_cast< const Opm::SimulatorState& >( previous ),
+                   static_cast< const Opm::SimulatorState& >( current ) );
+    BOOST_CHECK_EQUAL( fused.relativeChange( RC::DissolvedGas ), 0.0 );
+    BOOST_CHECK_CLOSE( fused.relativeChange(), std::max( pressure, saturation ), 1e-10 );
+}
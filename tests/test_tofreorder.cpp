@@ -0,0 +1,200 @@
+/*
+  Copyright 2015 SINTEF ICT, Applied Mathematics.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "config.h"
+
+/* --- Boost.Test boilerplate --- */
+#if HAVE_DYNAMIC_BOOST_TEST
+#define BOOST_TEST_DYN_LINK
+#endif
+
+#define NVERBOSE  // Suppress own messages when throw()ing
+
+#define BOOST_TEST_MODULE TofReorderTest
+#include <boost/test/unit_test.hpp>
+
+/* --- our own headers --- */
+#include <opm/core/flowdiagnostics/TofReorder.hpp>
+#include <opm/core/grid.h>
+#include <opm/core/grid/cart_grid.h>
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace
+{
+    // Uniform flow in the x direction, fed by sources in the first
+    // column and drained by sinks in the last.
+    void uniformFlow(const UnstructuredGrid& g, const int nx,
+                     std::vector<double>& flux, std::vector<double>& src)
+    {
+        flux.assign(g.number_of_faces, 0.0);
+        src.assign(g.number_of_cells, 0.0);
+        for (int f = 0; f < g.number_of_faces; ++f) {
+            if (g.face_cells[2*f] != -1 && g.face_cells[2*f + 1] != -1) {
+                flux[f] = g.face_normals[2*f];
+            }
+        }
+        for (int c = 0; c < g.number_of_cells; ++c) {
+            if (c % nx == 0) {
+                src[c] = 1.0;
+            } else if (c % nx == nx - 1) {
+                src[c] = -1.0;
+            }
+        }
+    }
+
+    // Add a divergence free circulation of strength eps around a node.
+    void addCirculation(const UnstructuredGrid& g, const int node, const double eps,
+                        std::vector<double>& flux)
+    {
+        for (int f = 0; f < g.number_of_faces; ++f) {
+            const int a = g.face_nodes[g.face_nodepos[f]];
+            const int b = g.face_nodes[g.face_nodepos[f] + 1];
+            if (a != node && b != node) {
+                continue;
+            }
+            const double tx = g.node_coordinates[2*b] - g.node_coordinates[2*a];
+            const double ty = g.node_coordinates[2*b + 1] - g.node_coordinates[2*a + 1];
+            const double cross = tx*g.face_normals[2*f + 1] - ty*g.face_normals[2*f];
+            const double dpsi = (b == node) ? eps : -eps;
+            flux[f] += (cross > 0.0 ? 1.0 : -1.0) * dpsi;
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(IncrementalUpdateMatchesFullSolve)
+{
+    const int nx = 30, ny = 20;
+    UnstructuredGrid* g = create_grid_cart2d(nx, ny, 1.0, 1.0);
+    const int nc = g->number_of_cells;
+    std::vector<double> flux, src;
+    uniformFlow(*g, nx, flux, src);
+    const std::vector<double> pv(nc, 0.2);
+
+    Opm::TofReorder solver(*g);
+    std::vector<double> tof;
+    solver.solveTof(&flux[0], &pv[0], &src[0], tof);
+
+    // Perturb the flow around a node in the middle of the grid.
+    const std::vector<double> old_flux = flux;
+    const int node = (ny/2)*(nx + 1) + nx/2;
+    addCirculation(*g, node, 0.3, flux);
+    const std::vector<int> changed
+        = Opm::TofReorder::changedFaces(g->number_of_faces, &old_flux[0], &flux[0], 1e-12);
+    BOOST_CHECK_EQUAL(changed.size(), 4u);
+
+    solver.updateTof(&flux[0], &pv[0], &src[0], changed, std::vector<int>(), tof);
+    BOOST_CHECK(solver.numUpdatedCells() > 0);
+    BOOST_CHECK(solver.numUpdatedCells() < nc/2);
+
+    std::vector<double> expected;
+    Opm::TofReorder full_solver(*g);
+    full_solver.solveTof(&flux[0], &pv[0], &src[0], expected);
+    for (int c = 0; c < nc; ++c) {
+        BOOST_CHECK_CLOSE(tof[c], expected[c], 1e-10);
+    }
+
+    // Nothing changed: nothing to do.
+    solver.updateTof(&flux[0], &pv[0], &src[0], std::vector<int>(), std::vector<int>(), tof);
+    BOOST_CHECK_EQUAL(solver.numUpdatedCells(), 0);
+
+    destroy_grid(g);
+}
+
+BOOST_AUTO_TEST_CASE(IncrementalUpdateWithReversedFlux)
+{
+    const int nx = 30, ny = 20;
+    UnstructuredGrid* g = create_grid_cart2d(nx, ny, 1.0, 1.0);
+    const int nc = g->number_of_cells;
+    std::vector<double> flux, src;
+    uniformFlow(*g, nx, flux, src);
+    const std::vector<double> pv(nc, 0.2);
+
+    Opm::TofReorder solver(*g);
+    std::vector<double> tof;
+    solver.solveTof(&flux[0], &pv[0], &src[0], tof);
+    BOOST_CHECK_EQUAL(solver.numMultiCellComponents(), 0);
+
+    // A circulation stronger than the background flow reverses the
+    // flux on one face, so the four cells around the node form a loop.
+    const std::vector<double> old_flux = flux;
+    const int node = (ny/2)*(nx + 1) + nx/2;
+    addCirculation(*g, node, 2.0, flux);
+    const std::vector<int> changed
+        = Opm::TofReorder::changedFaces(g->number_of_faces, &old_flux[0], &flux[0], 1e-12);
+    int num_reversed = 0;
+    for (std::size_t i = 0; i < changed.size(); ++i) {
+        if (flux[changed[i]]*old_flux[changed[i]] < 0.0) {
+            ++num_reversed;
+        }
+    }
+    BOOST_CHECK_EQUAL(num_reversed, 1);
+
+    solver.updateTof(&flux[0], &pv[0], &src[0], changed, std::vector<int>(), tof);
+    BOOST_CHECK_EQUAL(solver.numMultiCellComponents(), 1);
+    BOOST_CHECK(solver.numUpdatedCells() < nc/2);
+
+    // Both solves stop the Gauss-Seidel iterations when no value changes
+    // by more than the solver's tolerance (1e-3), starting from different
+    // values, so they agree to within that tolerance.
+    std::vector<double> expected;
+    Opm::TofReorder full_solver(*g);
+    full_solver.solveTof(&flux[0], &pv[0], &src[0], expected);
+    BOOST_CHECK_EQUAL(full_solver.numMultiCellComponents(), 1);
+    const double gauss_seidel_tol = 1e-3;
+    double max_diff = 0.0;
+    for (int c = 0; c < nc; ++c) {
+        max_diff = std::max(max_diff, std::fabs(tof[c] - expected[c]));
+    }
+    BOOST_CHECK(max_diff <= gauss_seidel_tol);
+
+    destroy_grid(g);
+}
+
+BOOST_AUTO_TEST_CASE(IncrementalUpdateRejectsBadIndices)
+{
+    UnstructuredGrid* g = create_grid_cart2d(4, 3, 1.0, 1.0);
+    const int nc = g->number_of_cells;
+    std::vector<double> flux, src;
+    uniformFlow(*g, 4, flux, src);
+    const std::vector<double> pv(nc, 0.2);
+
+    Opm::TofReorder solver(*g);
+    std::vector<double> tof;
+    solver.solveTof(&flux[0], &pv[0], &src[0], tof);
+    const std::vector<double> before = tof;
+    BOOST_CHECK_THROW(solver.updateTof(&flux[0], &pv[0], &src[0], std::vector<int>(),
+                                       std::vector<int>(1, nc), tof), std::runtime_error);
+    BOOST_CHECK_THROW(solver.updateTof(&flux[0], &pv[0], &src[0], std::vector<int>(),
+                                       std::vector<int>(1, -1), tof), std::runtime_error);
+    BOOST_CHECK_THROW(solver.updateTof(&flux[0], &pv[0], &src[0],
+                                       std::vector<int>(1, g->number_of_faces),
+                                       std::vector<int>(), tof), std::runtime_error);
+    BOOST_CHECK(tof == before);
+
+    // The solver is still usable after the rejected calls.
+    solver.updateTof(&flux[0], &pv[0], &src[0], std::vector<int>(), std::vector<int>(1, 0), tof);
+    for (int c = 0; c < nc; ++c) {
+        BOOST_CHECK_CLOSE(tof[c], before[c], 1e-10);
+    }
+
+    destroy_grid(g);
+}